@@ -0,0 +1,78 @@
+//
+//  Camera.cpp
+//  Perseguição, tremida e matriz view da câmera 2D.
+//
+
+#include "Camera.h"
+
+#include <math.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+// Abaixo disso (em pixels) a câmera chegou ao alvo e a tremida acabou
+static const float PERTO_DO_ALVO = 0.01f;
+static const float TREMIDA_MINIMA = 0.05f;
+
+Camera::Camera()
+    : position(0.0f), target(0.0f), viewport(0.0f), shakeOffset(0.0f), zoom(1.0f), followHalfLife(0.0f),
+      shakeAmplitude(0.0f), shakeHalfLife(0.1f), shakeTime(0.0f) {}
+
+void Camera::setViewport(float width, float height) {
+    viewport = glm::vec2(width, height);
+}
+
+void Camera::setPosition(const glm::vec2 &p) {
+    position = target = p;
+}
+
+void Camera::follow(const glm::vec2 &t) {
+    target = t;
+}
+
+void Camera::shake(float amplitude, float halfLife) {
+    if (amplitude > shakeAmplitude) shakeAmplitude = amplitude;
+    shakeHalfLife = halfLife > 0.0f ? halfLife : 0.1f;
+}
+
+void Camera::update(float dt) {
+    if (dt < 0.0f) dt = 0.0f;
+
+    // Fração do caminho que sobra depois de dt: 2^(-dt/meia-vida)
+    if (followHalfLife <= 0.0f) {
+        position = target;
+    } else {
+        float resta = exp2f(-dt / followHalfLife);
+        position = target + (position - target) * resta;
+        glm::vec2 d = target - position;
+        if (fabsf(d.x) < PERTO_DO_ALVO && fabsf(d.y) < PERTO_DO_ALVO)
+            position = target;
+    }
+
+    if (shakeAmplitude > 0.0f) {
+        shakeTime += dt;
+        shakeAmplitude *= exp2f(-dt / shakeHalfLife);
+        if (shakeAmplitude < TREMIDA_MINIMA) {
+            shakeAmplitude = 0.0f;
+            shakeOffset = glm::vec2(0.0f);
+        } else {
+            // Senos de frequências sem múltiplo comum: parece aleatório e não repete logo
+            float t = shakeTime;
+            shakeOffset.x = shakeAmplitude * (0.6f * sinf(t * 53.0f) + 0.4f * sinf(t * 31.0f + 1.7f));
+            shakeOffset.y = shakeAmplitude * (0.6f * sinf(t * 47.0f + 0.9f) + 0.4f * sinf(t * 29.0f + 4.1f));
+        }
+    }
+}
+
+glm::mat4 Camera::getView() const {
+    glm::mat4 v = glm::translate(glm::mat4(1.0f), glm::vec3(viewport * 0.5f + shakeOffset, 0.0f));
+    v = glm::scale(v, glm::vec3(zoom, zoom, 1.0f));
+    return glm::translate(v, glm::vec3(-position, 0.0f));
+}
+
+glm::vec2 Camera::screenToWorld(const glm::vec2 &p) const {
+    return position + (p - viewport * 0.5f) / zoom;
+}
+
+bool Camera::isMoving() const {
+    return position != target || shakeAmplitude > 0.0f;
+}
@@ -0,0 +1,92 @@
+//
+//  Camera.h
+//  Câmera 2D: posição, zoom, perseguição suave e tremida, numa matriz view.
+//
+//  Em vez de cada função de desenho descontar a posição da câmera ao montar
+//  a matriz model, o mundo fica nas suas próprias coordenadas (pixels de
+//  mundo, y para baixo, como a projeção ortográfica dos programas) e a
+//  câmera entra uma vez por quadro, no uniforme "view" do vertex shader:
+//
+//      gl_Position = projection * view * model * vec4(position, 1.0);
+//
+//  Assim a geometria que não se mexe no mundo (o mapa, objetos parados)
+//  pode ir para buffers montados uma vez e reaproveitados enquanto a câmera
+//  anda.
+//
+//  A posição é o ponto do mundo que aparece no centro da tela. follow()
+//  só muda o alvo: update(dt) aproxima a posição dele com meia-vida fixa,
+//  do mesmo jeito qualquer que seja o ritmo de quadros. A tremida é um
+//  deslocamento em pixels de tela (não muda com o zoom) que cai pela metade
+//  a cada meia-vida; o ruído é uma soma de senos, então a mesma sequência
+//  de dt dá a mesma tremida.
+//
+//  Uso:
+//      Camera camera;
+//      camera.setViewport(960, 720);
+//      camera.setPosition(inicio);         // sem suavizar
+//      camera.setFollowHalfLife(0.08f);
+//      ...
+//      camera.follow(posicaoDoPersonagem);
+//      camera.update(dt);
+//      glUniformMatrix4fv(locView, 1, GL_FALSE, glm::value_ptr(camera.getView()));
+//
+
+#ifndef Camera_h
+#define Camera_h
+
+#include <glm/glm.hpp>
+
+class Camera {
+public:
+    Camera();
+
+    // Tamanho da tela em pixels; a posição da câmera fica no centro dela
+    void setViewport(float width, float height);
+
+    // Põe a câmera (e o alvo) no ponto do mundo, sem suavizar
+    void setPosition(const glm::vec2 &p);
+    const glm::vec2 &getPosition() const {
+        return position;
+    }
+
+    // Ponto do mundo que a câmera persegue a partir do próximo update()
+    void follow(const glm::vec2 &target);
+    const glm::vec2 &getTarget() const {
+        return target;
+    }
+
+    // Tempo para percorrer metade da distância até o alvo (0: gruda nele)
+    void setFollowHalfLife(float seconds) {
+        followHalfLife = seconds;
+    }
+
+    // Pixels de tela por pixel de mundo, em torno do centro da tela
+    void setZoom(float z) {
+        zoom = z;
+    }
+    float getZoom() const {
+        return zoom;
+    }
+
+    // Começa (ou reforça) uma tremida de até amplitude pixels de tela
+    void shake(float amplitude, float halfLife = 0.1f);
+
+    // Avança dt segundos: perseguição e tremida
+    void update(float dt);
+
+    // Mundo -> pixels de tela
+    glm::mat4 getView() const;
+
+    // Ponto da tela em coordenadas de mundo (sem a tremida)
+    glm::vec2 screenToWorld(const glm::vec2 &p) const;
+
+    // Ainda chegando ao alvo ou tremendo: o próximo quadro sai diferente
+    bool isMoving() const;
+
+private:
+    glm::vec2 position, target, viewport, shakeOffset;
+    float zoom, followHalfLife;
+    float shakeAmplitude, shakeHalfLife, shakeTime;
+};
+
+#endif /* Camera_h */
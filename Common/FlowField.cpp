@@ -0,0 +1,212 @@
+//
+//  FlowField.cpp
+//  Campo de fluxo com atualização incremental.
+//
+
+#include "FlowField.h"
+
+#include <algorithm>
+#include <float.h>
+
+#define SQRT2 1.41421356f
+#define CUSTO_INF FLT_MAX
+
+// Mesma numeração de migore.direcao no Joguinho (tecla W, Q, A, Z, S, C, D, E);
+// a direção oposta de d é sempre (d + 4) % 8
+const int FlowField::FLOW_DIR_X[8] = { -1, -1, -1, 0, 1, 1,  1,  0 };
+const int FlowField::FLOW_DIR_Y[8] = { -1,  0,  1, 1, 1, 0, -1, -1 };
+
+void FlowField::Field::resize(size_t n) {
+    cost.assign(n, CUSTO_INF);
+    dir.assign(n, -1);
+    stamp.assign(n, 0);
+    gen = 1;
+}
+
+void FlowField::Field::reset() {
+    gen++;
+    if (gen == 0) {
+        std::fill(stamp.begin(), stamp.end(), 0);
+        gen = 1;
+    }
+}
+
+float FlowField::Field::costAt(int i) const {
+    return stamp[i] == gen ? cost[i] : CUSTO_INF;
+}
+
+FlowField::FlowField() : grid(NULL), width(0), height(0), rebuilding(false), markGen(0) {
+    goal.x = goal.y = 0;
+}
+
+bool FlowField::queueGreater(const QueueNode &a, const QueueNode &b) {
+    return a.cost > b.cost;
+}
+
+float FlowField::cost(int x, int y) const {
+    if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return -1.0f;
+    float c = front.costAt(y * width + x);
+    return c == CUSTO_INF ? -1.0f : c;
+}
+
+void FlowField::build(const WalkGrid &g, GridPoint alvo) {
+    grid = &g;
+    if (width != g.getWidth() || height != g.getHeight()) {
+        width = g.getWidth();
+        height = g.getHeight();
+        size_t n = (size_t)width * height;
+        front.resize(n);
+        back.resize(n);
+        mark.assign(n, 0);
+        markGen = 0;
+    }
+    goal = alvo;
+    rebuilding = false;
+    queue.clear();
+
+    front.reset();
+    localQueue.clear();
+    if (grid->isWalkable(goal.x, goal.y)) {
+        int i = goal.y * width + goal.x;
+        front.set(i, 0.0f, -1);
+        QueueNode node = { 0.0f, i };
+        localQueue.push_back(node);
+    }
+    relaxFrom(front, localQueue, -1);
+}
+
+void FlowField::setGoal(GridPoint alvo) {
+    if (grid == NULL) return;
+    goal = alvo;
+    startRebuild();
+}
+
+void FlowField::startRebuild() {
+    back.reset();
+    queue.clear();
+    if (grid->isWalkable(goal.x, goal.y)) {
+        int i = goal.y * width + goal.x;
+        back.set(i, 0.0f, -1);
+        QueueNode node = { 0.0f, i };
+        queue.push_back(node);
+    }
+    rebuilding = true;
+}
+
+int FlowField::update(int budget) {
+    if (!rebuilding) return 0;
+    int n = relaxFrom(back, queue, budget);
+    if (queue.empty()) {
+        std::swap(front, back);
+        rebuilding = false;
+    }
+    return n;
+}
+
+// Dijkstra sobre a fila "q" até esvaziá-la ou gastar "budget" remoções
+// (budget negativo = sem limite)
+int FlowField::relaxFrom(Field &f, std::vector<QueueNode> &q, int budget) {
+    int processadas = 0;
+    while (!q.empty() && (budget < 0 || processadas < budget)) {
+        std::pop_heap(q.begin(), q.end(), queueGreater);
+        QueueNode node = q.back();
+        q.pop_back();
+        processadas++;
+        if (node.cost > f.costAt(node.index)) continue; // entrada velha
+
+        int x = node.index % width;
+        int y = node.index / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + FLOW_DIR_X[d];
+            int ny = y + FLOW_DIR_Y[d];
+            if (!grid->isWalkable(nx, ny)) continue;
+            int ni = ny * width + nx;
+            float nc = node.cost + ((d & 1) ? 1.0f : SQRT2);
+            if (nc < f.costAt(ni)) {
+                // o vizinho anda na direção oposta para chegar aqui
+                f.set(ni, nc, (d + 4) & 7);
+                QueueNode viz = { nc, ni };
+                q.push_back(viz);
+                std::push_heap(q.begin(), q.end(), queueGreater);
+            }
+        }
+    }
+    return processadas;
+}
+
+// Pega o melhor custo entre os vizinhos já resolvidos e, se melhorar a
+// célula, coloca-a na fila
+bool FlowField::seedFromNeighbours(Field &f, std::vector<QueueNode> &q, int index) {
+    int x = index % width;
+    int y = index / width;
+    float melhor = (x == goal.x && y == goal.y) ? 0.0f : CUSTO_INF;
+    int melhorDir = -1;
+    for (int d = 0; d < 8; d++) {
+        int nx = x + FLOW_DIR_X[d];
+        int ny = y + FLOW_DIR_Y[d];
+        if ((unsigned)nx >= (unsigned)width || (unsigned)ny >= (unsigned)height) continue;
+        float c = f.costAt(ny * width + nx);
+        if (c == CUSTO_INF) continue;
+        c += (d & 1) ? 1.0f : SQRT2;
+        if (c < melhor) {
+            melhor = c;
+            melhorDir = d;
+        }
+    }
+    if (melhor >= f.costAt(index)) return false;
+    f.set(index, melhor, melhorDir);
+    QueueNode node = { melhor, index };
+    q.push_back(node);
+    std::push_heap(q.begin(), q.end(), queueGreater);
+    return true;
+}
+
+int FlowField::cellOpened(int x, int y) {
+    if (grid == NULL || !grid->isWalkable(x, y)) return 0;
+    if (rebuilding) startRebuild();
+
+    localQueue.clear();
+    if (!seedFromNeighbours(front, localQueue, y * width + x)) return 0;
+    return relaxFrom(front, localQueue, -1);
+}
+
+int FlowField::cellClosed(int x, int y) {
+    if (grid == NULL || (unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return 0;
+    if (rebuilding) startRebuild();
+
+    markGen++;
+    if (markGen == 0) {
+        std::fill(mark.begin(), mark.end(), 0);
+        markGen = 1;
+    }
+
+    // Todas as células cuja direção leva, direta ou indiretamente, à
+    // célula fechada perdem o caminho
+    affected.clear();
+    int c = y * width + x;
+    affected.push_back(c);
+    mark[c] = markGen;
+    for (size_t k = 0; k < affected.size(); k++) {
+        int ax = affected[k] % width;
+        int ay = affected[k] / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = ax + FLOW_DIR_X[d];
+            int ny = ay + FLOW_DIR_Y[d];
+            if ((unsigned)nx >= (unsigned)width || (unsigned)ny >= (unsigned)height) continue;
+            int ni = ny * width + nx;
+            // o vizinho aponta para a célula afetada?
+            if (mark[ni] != markGen && front.dirAt(ni) == ((d + 4) & 7)) {
+                mark[ni] = markGen;
+                affected.push_back(ni);
+            }
+        }
+    }
+    for (size_t k = 0; k < affected.size(); k++)
+        front.set(affected[k], CUSTO_INF, -1);
+
+    // Repara a região a partir da borda que continua válida
+    localQueue.clear();
+    for (size_t k = 1; k < affected.size(); k++)
+        seedFromNeighbours(front, localQueue, affected[k]);
+    return (int)affected.size() + relaxFrom(front, localQueue, -1);
+}
@@ -0,0 +1,109 @@
+//
+//  FlowField.h
+//  Campo de fluxo compartilhado para navegação de muitos agentes.
+//
+//  Um único campo de integração (custo octil até o alvo) e um campo de
+//  direções são calculados a partir do alvo sobre uma WalkGrid. Cada agente
+//  só precisa de uma consulta direction(x, y) por passo, então o custo por
+//  frame não depende do número de agentes.
+//
+//  Atualizações:
+//   - cellOpened(): barreira liberada. Só as células cujo custo diminui são
+//     revisitadas.
+//   - cellClosed(): célula bloqueada. Invalida apenas as células cujo
+//     caminho passava por ela e repara essa região.
+//   - setGoal(): alvo mudou. O novo campo é montado num buffer de trás, em
+//     fatias de no máximo "budget" células por update(); os agentes seguem
+//     usando o campo anterior (completo) até a troca.
+//
+
+#ifndef FlowField_h
+#define FlowField_h
+
+#include "WalkGrid.h"
+#include <vector>
+
+class FlowField {
+public:
+    FlowField();
+
+    // Monta o campo inteiro imediatamente
+    void build(const WalkGrid &grid, GridPoint goal);
+
+    // Agenda a reconstrução para um novo alvo (processada por update)
+    void setGoal(GridPoint goal);
+
+    // Avisos de mudança na grade. Retornam o número de células recalculadas.
+    int cellOpened(int x, int y);
+    int cellClosed(int x, int y);
+
+    // Avança a reconstrução pendente em até "budget" células.
+    // Retorna quantas foram processadas.
+    int update(int budget);
+
+    bool isRebuilding() const {
+        return rebuilding;
+    }
+
+    // Direção (0..7, índices de FLOW_DIR_X/Y) do próximo passo rumo ao alvo,
+    // ou -1 se a célula não alcança o alvo (ou é o próprio alvo)
+    int direction(int x, int y) const {
+        if ((unsigned)x >= (unsigned)width || (unsigned)y >= (unsigned)height) return -1;
+        return front.dirAt(y * width + x);
+    }
+
+    // Custo até o alvo; negativo quando inalcançável
+    float cost(int x, int y) const;
+
+    GridPoint getGoal() const {
+        return goal;
+    }
+
+    static const int FLOW_DIR_X[8];
+    static const int FLOW_DIR_Y[8];
+
+private:
+    // Um buffer de campo. "stamp" diz em qual geração a célula foi escrita,
+    // assim limpar o buffer inteiro é só incrementar "gen".
+    struct Field {
+        std::vector<float> cost;
+        std::vector<signed char> dir;
+        std::vector<uint32_t> stamp;
+        uint32_t gen;
+
+        void resize(size_t n);
+        void reset();
+        float costAt(int i) const;
+        int dirAt(int i) const {
+            return stamp[i] == gen ? dir[i] : -1;
+        }
+        void set(int i, float c, int d) {
+            cost[i] = c;
+            dir[i] = (signed char)d;
+            stamp[i] = gen;
+        }
+    };
+
+    struct QueueNode {
+        float cost;
+        int index;
+    };
+
+    const WalkGrid *grid;
+    int width, height;
+    GridPoint goal;
+    Field front, back;
+    bool rebuilding;
+    std::vector<QueueNode> queue;         // fila da reconstrução em andamento
+    std::vector<QueueNode> localQueue;    // fila dos reparos incrementais
+    std::vector<int> affected;
+    std::vector<uint32_t> mark;           // marca das células afetadas em cellClosed
+    uint32_t markGen;
+
+    static bool queueGreater(const QueueNode &a, const QueueNode &b);
+    void startRebuild();
+    int relaxFrom(Field &f, std::vector<QueueNode> &q, int budget);
+    bool seedFromNeighbours(Field &f, std::vector<QueueNode> &q, int index);
+};
+
+#endif /* FlowField_h */
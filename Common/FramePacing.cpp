@@ -0,0 +1,112 @@
+//
+//  FramePacing.cpp
+//  Vsync pela GLFW e espera do limitador de quadros (dorme e depois gira).
+//
+
+#include "FramePacing.h"
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <thread>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+// Margem inicial de spin e limites da margem ajustada
+static const double MARGEM_SPIN_INICIAL = 0.002;
+static const double MARGEM_SPIN_MINIMA = 0.0002;
+static const double MARGEM_SPIN_MAXIMA = 0.004;
+
+FramePacer::FramePacer()
+    : vsync(VSYNC_ON), targetFps(0.0), idleFps(15.0), idle(false), scheduled(false),
+      spinMargin(MARGEM_SPIN_INICIAL), timerPeriodSet(false) {
+}
+
+FramePacer::~FramePacer() {
+#ifdef _WIN32
+    if (timerPeriodSet) timeEndPeriod(1);
+#endif
+}
+
+void FramePacer::parseArgs(int argc, char **argv) {
+    for (int i = 1; i + 1 < argc; i++) {
+        if (!strcmp(argv[i], "--vsync")) {
+            const char *m = argv[++i];
+            if (!strcmp(m, "off")) vsync = VSYNC_OFF;
+            else if (!strcmp(m, "adaptive")) vsync = VSYNC_ADAPTIVE;
+            else vsync = VSYNC_ON;
+        } else if (!strcmp(argv[i], "--fps")) {
+            targetFps = std::max(0.0, atof(argv[++i]));
+        } else if (!strcmp(argv[i], "--fps-pausa")) {
+            idleFps = std::max(0.0, atof(argv[++i]));
+        }
+    }
+}
+
+VsyncMode FramePacer::apply() {
+#ifdef _WIN32
+    // Sleep com resolução de 1 ms; sem isso o sleep acorda em passos de ~15 ms.
+    // Vale para o sistema todo até o timeEndPeriod do destrutor
+    if (!timerPeriodSet) timerPeriodSet = timeBeginPeriod(1) == TIMERR_NOERROR;
+#endif
+    if (vsync == VSYNC_ADAPTIVE &&
+        !glfwExtensionSupported("WGL_EXT_swap_control_tear") &&
+        !glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+        vsync = VSYNC_ON;
+    // Intervalo -1 é o vsync adaptativo das extensões swap_control_tear
+    glfwSwapInterval(vsync == VSYNC_ADAPTIVE ? -1 : (int)vsync);
+    return vsync;
+}
+
+void FramePacer::setIdle(bool novo) {
+    if (novo != idle) scheduled = false;   // não herda o horário do outro ritmo
+    idle = novo;
+}
+
+void FramePacer::waitForNextFrame() {
+    double fps = idle ? idleFps : targetFps;
+    if (fps <= 0.0) {
+        scheduled = false;
+        return;
+    }
+    Clock::duration periodo = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+    Clock::time_point agora = Clock::now();
+    if (!scheduled) {
+        nextFrame = agora;
+        scheduled = true;
+    }
+    nextFrame += periodo;
+    // Atrasou mais de um quadro (janela arrastada, travada): recomeça daqui
+    // em vez de emendar quadros para alcançar o relógio
+    if (nextFrame < agora) {
+        nextFrame = agora + periodo;
+        return;
+    }
+
+    // Dorme até a margem de spin; o atraso do sleep ajusta a margem
+    std::chrono::duration<double> resto = nextFrame - agora;
+    if (resto.count() > spinMargin) {
+        Clock::time_point acorda = nextFrame - std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(spinMargin));
+        std::this_thread::sleep_until(acorda);
+        double atraso = std::chrono::duration<double>(Clock::now() - acorda).count();
+        // Sobe rápido quando o sleep atrasa além da margem, desce devagar
+        double alvo = atraso * 1.5;
+        spinMargin = alvo > spinMargin ? alvo : spinMargin * 0.95 + alvo * 0.05;
+        spinMargin = std::min(MARGEM_SPIN_MAXIMA, std::max(MARGEM_SPIN_MINIMA, spinMargin));
+    }
+    while (Clock::now() < nextFrame)
+        std::this_thread::yield();
+}
+
+const char *vsyncModeName(VsyncMode mode) {
+    switch (mode) {
+    case VSYNC_OFF: return "off";
+    case VSYNC_ADAPTIVE: return "adaptive";
+    default: return "on";
+    }
+}
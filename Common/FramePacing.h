@@ -0,0 +1,88 @@
+//
+//  FramePacing.h
+//  Ritmo de quadros: modo de vsync e limitador de FPS que dorme em vez de
+//  girar a CPU.
+//
+//  O limitador dorme até pouco antes do horário do próximo quadro e só gira
+//  (spin) o restinho, porque o sleep do sistema costuma acordar atrasado. A
+//  margem de spin se ajusta sozinha ao atraso medido dos sleeps. Em pausa ou
+//  menu, setIdle(true) troca o alvo por uma taxa baixa.
+//
+//  Uso típico, com o contexto da janela já corrente:
+//      FramePacer pacer;
+//      pacer.parseArgs(argc, argv);   // --vsync on|off|adaptive --fps N
+//      pacer.apply();
+//      while (...) { ...; glfwSwapBuffers(window); pacer.waitForNextFrame(); }
+//
+
+#ifndef FramePacing_h
+#define FramePacing_h
+
+#include <chrono>
+
+enum VsyncMode {
+    VSYNC_OFF = 0,
+    VSYNC_ON = 1,
+    VSYNC_ADAPTIVE = 2   // troca atrasada não espera o próximo vblank (swap_control_tear)
+};
+
+class FramePacer {
+public:
+    FramePacer();
+    // Devolve a resolução do timer do sistema que apply() pediu (Windows)
+    ~FramePacer();
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    // Lê --vsync on|off|adaptive, --fps N (0 = sem limite) e --fps-pausa N
+    void parseArgs(int argc, char **argv);
+
+    void setVsync(VsyncMode mode) {
+        vsync = mode;
+    }
+    void setTargetFps(double fps) {
+        targetFps = fps;
+    }
+    void setIdleFps(double fps) {
+        idleFps = fps;
+    }
+
+    // Aplica o vsync no contexto corrente. Adaptativo vira ligado quando o
+    // driver não tem a extensão; devolve o modo que ficou valendo
+    VsyncMode apply();
+
+    // Pausa/menu: o quadro não muda, então limita a idleFps
+    void setIdle(bool idle);
+
+    // Chamado logo depois do glfwSwapBuffers
+    void waitForNextFrame();
+
+    VsyncMode getVsync() const {
+        return vsync;
+    }
+    double getTargetFps() const {
+        return targetFps;
+    }
+    double getIdleFps() const {
+        return idleFps;
+    }
+    bool isIdle() const {
+        return idle;
+    }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    VsyncMode vsync;
+    double targetFps;
+    double idleFps;
+    bool idle;
+    bool scheduled;             // nextFrame já vale
+    Clock::time_point nextFrame;
+    double spinMargin;          // segundos reservados para o spin no fim da espera
+    bool timerPeriodSet;        // apply() pediu timeBeginPeriod(1)
+};
+
+const char *vsyncModeName(VsyncMode mode);
+
+#endif /* FramePacing_h */
@@ -0,0 +1,350 @@
+//
+//  GLInstrumentation.cpp
+//  Versões que contam das entradas da GLAD e o estado que elas acompanham
+//  para achar mudanças redundantes.
+//
+
+#include "GLInstrumentation.h"
+
+#include <glad/glad.h>
+
+#include <string.h>
+
+GLInstrumentation g_glInstrumentation;
+
+static GLCounters contadores;
+
+// --- Estado conhecido; DESCONHECIDO até a primeira mudança vista ---
+static const GLuint DESCONHECIDO = 0xFFFFFFFFu;
+static const int MAX_UNIDADES = 32;
+static const GLenum ALVOS_TEXTURA[] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP };
+static const int N_ALVOS_TEXTURA = sizeof(ALVOS_TEXTURA) / sizeof(ALVOS_TEXTURA[0]);
+static const GLenum ALVOS_BUFFER[] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER,
+                                       GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, GL_PIXEL_UNPACK_BUFFER };
+static const int N_ALVOS_BUFFER = sizeof(ALVOS_BUFFER) / sizeof(ALVOS_BUFFER[0]);
+static const GLenum CAPACIDADES[] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST, GL_STENCIL_TEST, GL_MULTISAMPLE };
+static const int N_CAPACIDADES = sizeof(CAPACIDADES) / sizeof(CAPACIDADES[0]);
+
+static struct {
+    GLuint programa;
+    GLuint vao;
+    GLuint unidade;
+    GLuint texturas[MAX_UNIDADES][N_ALVOS_TEXTURA];
+    GLuint buffers[N_ALVOS_BUFFER];
+    GLuint capacidades[N_CAPACIDADES];   // 0, 1 ou DESCONHECIDO
+    GLuint blendOrigem, blendDestino;
+    GLuint funcaoProfundidade;
+} estado;
+
+static void esqueceEstado() {
+    memset(&estado, 0xFF, sizeof(estado));
+}
+
+static int indiceDe(const GLenum *lista, int n, GLenum valor) {
+    for (int i = 0; i < n; i++)
+        if (lista[i] == valor) return i;
+    return -1;
+}
+
+// Guarda o valor novo; devolve true se ele já era o conhecido
+static bool repete(GLuint &conhecido, GLuint novo) {
+    if (conhecido == novo) {
+        contadores.redundantStateSets++;
+        return true;
+    }
+    conhecido = novo;
+    return false;
+}
+
+// --- Originais da GLAD ---
+static PFNGLDRAWARRAYSPROC orig_glDrawArrays;
+static PFNGLDRAWELEMENTSPROC orig_glDrawElements;
+static PFNGLDRAWARRAYSINSTANCEDPROC orig_glDrawArraysInstanced;
+static PFNGLDRAWELEMENTSINSTANCEDPROC orig_glDrawElementsInstanced;
+static PFNGLUSEPROGRAMPROC orig_glUseProgram;
+static PFNGLDELETEPROGRAMPROC orig_glDeleteProgram;
+static PFNGLACTIVETEXTUREPROC orig_glActiveTexture;
+static PFNGLBINDTEXTUREPROC orig_glBindTexture;
+static PFNGLDELETETEXTURESPROC orig_glDeleteTextures;
+static PFNGLBINDVERTEXARRAYPROC orig_glBindVertexArray;
+static PFNGLDELETEVERTEXARRAYSPROC orig_glDeleteVertexArrays;
+static PFNGLBINDBUFFERPROC orig_glBindBuffer;
+static PFNGLDELETEBUFFERSPROC orig_glDeleteBuffers;
+static PFNGLBUFFERDATAPROC orig_glBufferData;
+static PFNGLBUFFERSUBDATAPROC orig_glBufferSubData;
+static PFNGLENABLEPROC orig_glEnable;
+static PFNGLDISABLEPROC orig_glDisable;
+static PFNGLBLENDFUNCPROC orig_glBlendFunc;
+static PFNGLDEPTHFUNCPROC orig_glDepthFunc;
+static PFNGLGETUNIFORMLOCATIONPROC orig_glGetUniformLocation;
+static PFNGLUNIFORM1IPROC orig_glUniform1i;
+static PFNGLUNIFORM1FPROC orig_glUniform1f;
+static PFNGLUNIFORM2FPROC orig_glUniform2f;
+static PFNGLUNIFORM3FPROC orig_glUniform3f;
+static PFNGLUNIFORM4FPROC orig_glUniform4f;
+static PFNGLUNIFORM1FVPROC orig_glUniform1fv;
+static PFNGLUNIFORM2FVPROC orig_glUniform2fv;
+static PFNGLUNIFORM3FVPROC orig_glUniform3fv;
+static PFNGLUNIFORM4FVPROC orig_glUniform4fv;
+static PFNGLUNIFORMMATRIX4FVPROC orig_glUniformMatrix4fv;
+
+// --- Desenho ---
+static void APIENTRY conta_glDrawArrays(GLenum modo, GLint primeiro, GLsizei n) {
+    contadores.drawCalls++;
+    contadores.vertices += n;
+    orig_glDrawArrays(modo, primeiro, n);
+}
+
+static void APIENTRY conta_glDrawElements(GLenum modo, GLsizei n, GLenum tipo, const void *indices) {
+    contadores.drawCalls++;
+    contadores.vertices += n;
+    orig_glDrawElements(modo, n, tipo, indices);
+}
+
+static void APIENTRY conta_glDrawArraysInstanced(GLenum modo, GLint primeiro, GLsizei n, GLsizei instancias) {
+    contadores.drawCalls++;
+    contadores.vertices += (long long)n * instancias;
+    orig_glDrawArraysInstanced(modo, primeiro, n, instancias);
+}
+
+static void APIENTRY conta_glDrawElementsInstanced(GLenum modo, GLsizei n, GLenum tipo, const void *indices, GLsizei instancias) {
+    contadores.drawCalls++;
+    contadores.vertices += (long long)n * instancias;
+    orig_glDrawElementsInstanced(modo, n, tipo, indices, instancias);
+}
+
+// --- Programa, texturas, VAO e buffers ---
+static void APIENTRY conta_glUseProgram(GLuint programa) {
+    contadores.programSwitches++;
+    repete(estado.programa, programa);
+    orig_glUseProgram(programa);
+}
+
+static void APIENTRY conta_glDeleteProgram(GLuint programa) {
+    if (estado.programa == programa) estado.programa = DESCONHECIDO;
+    orig_glDeleteProgram(programa);
+}
+
+static void APIENTRY conta_glActiveTexture(GLenum unidade) {
+    repete(estado.unidade, unidade - GL_TEXTURE0);
+    orig_glActiveTexture(unidade);
+}
+
+static void APIENTRY conta_glBindTexture(GLenum alvo, GLuint textura) {
+    contadores.textureBinds++;
+    int a = indiceDe(ALVOS_TEXTURA, N_ALVOS_TEXTURA, alvo);
+    if (a >= 0 && estado.unidade < (GLuint)MAX_UNIDADES)
+        repete(estado.texturas[estado.unidade][a], textura);
+    orig_glBindTexture(alvo, textura);
+}
+
+static void APIENTRY conta_glDeleteTextures(GLsizei n, const GLuint *texturas) {
+    for (GLsizei i = 0; i < n; i++)
+        for (int u = 0; u < MAX_UNIDADES; u++)
+            for (int a = 0; a < N_ALVOS_TEXTURA; a++)
+                if (estado.texturas[u][a] == texturas[i]) estado.texturas[u][a] = DESCONHECIDO;
+    orig_glDeleteTextures(n, texturas);
+}
+
+static void APIENTRY conta_glBindVertexArray(GLuint vao) {
+    contadores.vaoBinds++;
+    if (!repete(estado.vao, vao)) {
+        // O buffer de índices faz parte do VAO
+        estado.buffers[indiceDe(ALVOS_BUFFER, N_ALVOS_BUFFER, GL_ELEMENT_ARRAY_BUFFER)] = DESCONHECIDO;
+    }
+    orig_glBindVertexArray(vao);
+}
+
+static void APIENTRY conta_glDeleteVertexArrays(GLsizei n, const GLuint *vaos) {
+    for (GLsizei i = 0; i < n; i++)
+        if (estado.vao == vaos[i]) estado.vao = DESCONHECIDO;
+    orig_glDeleteVertexArrays(n, vaos);
+}
+
+static void APIENTRY conta_glBindBuffer(GLenum alvo, GLuint buffer) {
+    int a = indiceDe(ALVOS_BUFFER, N_ALVOS_BUFFER, alvo);
+    if (a >= 0) repete(estado.buffers[a], buffer);
+    orig_glBindBuffer(alvo, buffer);
+}
+
+static void APIENTRY conta_glDeleteBuffers(GLsizei n, const GLuint *buffers) {
+    for (GLsizei i = 0; i < n; i++)
+        for (int a = 0; a < N_ALVOS_BUFFER; a++)
+            if (estado.buffers[a] == buffers[i]) estado.buffers[a] = DESCONHECIDO;
+    orig_glDeleteBuffers(n, buffers);
+}
+
+static void APIENTRY conta_glBufferData(GLenum alvo, GLsizeiptr tamanho, const void *dados, GLenum uso) {
+    if (dados) {
+        contadores.bufferUploads++;
+        contadores.bufferBytes += tamanho;
+    }
+    orig_glBufferData(alvo, tamanho, dados, uso);
+}
+
+static void APIENTRY conta_glBufferSubData(GLenum alvo, GLintptr inicio, GLsizeiptr tamanho, const void *dados) {
+    contadores.bufferUploads++;
+    contadores.bufferBytes += tamanho;
+    orig_glBufferSubData(alvo, inicio, tamanho, dados);
+}
+
+// --- Estado fixo ---
+static void APIENTRY conta_glEnable(GLenum capacidade) {
+    int c = indiceDe(CAPACIDADES, N_CAPACIDADES, capacidade);
+    if (c >= 0) repete(estado.capacidades[c], 1);
+    orig_glEnable(capacidade);
+}
+
+static void APIENTRY conta_glDisable(GLenum capacidade) {
+    int c = indiceDe(CAPACIDADES, N_CAPACIDADES, capacidade);
+    if (c >= 0) repete(estado.capacidades[c], 0);
+    orig_glDisable(capacidade);
+}
+
+static void APIENTRY conta_glBlendFunc(GLenum origem, GLenum destino) {
+    if (estado.blendOrigem == origem && estado.blendDestino == destino) {
+        contadores.redundantStateSets++;
+    }
+    estado.blendOrigem = origem;
+    estado.blendDestino = destino;
+    orig_glBlendFunc(origem, destino);
+}
+
+static void APIENTRY conta_glDepthFunc(GLenum funcao) {
+    repete(estado.funcaoProfundidade, funcao);
+    orig_glDepthFunc(funcao);
+}
+
+// --- Uniformes ---
+static GLint APIENTRY conta_glGetUniformLocation(GLuint programa, const GLchar *nome) {
+    contadores.uniformLocationQueries++;
+    return orig_glGetUniformLocation(programa, nome);
+}
+
+static void APIENTRY conta_glUniform1i(GLint l, GLint a) {
+    contadores.uniformUploads++;
+    orig_glUniform1i(l, a);
+}
+
+static void APIENTRY conta_glUniform1f(GLint l, GLfloat a) {
+    contadores.uniformUploads++;
+    orig_glUniform1f(l, a);
+}
+
+static void APIENTRY conta_glUniform2f(GLint l, GLfloat a, GLfloat b) {
+    contadores.uniformUploads++;
+    orig_glUniform2f(l, a, b);
+}
+
+static void APIENTRY conta_glUniform3f(GLint l, GLfloat a, GLfloat b, GLfloat c) {
+    contadores.uniformUploads++;
+    orig_glUniform3f(l, a, b, c);
+}
+
+static void APIENTRY conta_glUniform4f(GLint l, GLfloat a, GLfloat b, GLfloat c, GLfloat d) {
+    contadores.uniformUploads++;
+    orig_glUniform4f(l, a, b, c, d);
+}
+
+static void APIENTRY conta_glUniform1fv(GLint l, GLsizei n, const GLfloat *v) {
+    contadores.uniformUploads++;
+    orig_glUniform1fv(l, n, v);
+}
+
+static void APIENTRY conta_glUniform2fv(GLint l, GLsizei n, const GLfloat *v) {
+    contadores.uniformUploads++;
+    orig_glUniform2fv(l, n, v);
+}
+
+static void APIENTRY conta_glUniform3fv(GLint l, GLsizei n, const GLfloat *v) {
+    contadores.uniformUploads++;
+    orig_glUniform3fv(l, n, v);
+}
+
+static void APIENTRY conta_glUniform4fv(GLint l, GLsizei n, const GLfloat *v) {
+    contadores.uniformUploads++;
+    orig_glUniform4fv(l, n, v);
+}
+
+static void APIENTRY conta_glUniformMatrix4fv(GLint l, GLsizei n, GLboolean transposta, const GLfloat *v) {
+    contadores.uniformUploads++;
+    orig_glUniformMatrix4fv(l, n, transposta, v);
+}
+
+GLInstrumentation::GLInstrumentation() : installed(false), frames(0) {
+    memset(&last, 0, sizeof(last));
+    memset(&accumulated, 0, sizeof(accumulated));
+}
+
+// Guarda a original e põe a versão que conta; entradas ausentes ficam como estão
+#define INSTRUMENTA(nome)                 \
+    if (glad_##nome) {                    \
+        orig_##nome = glad_##nome;        \
+        glad_##nome = conta_##nome;       \
+    }
+
+bool GLInstrumentation::install() {
+    if (installed) return true;
+    if (!glad_glDrawArrays) return false;   // GLAD ainda não carregada
+    INSTRUMENTA(glDrawArrays);
+    INSTRUMENTA(glDrawElements);
+    INSTRUMENTA(glDrawArraysInstanced);
+    INSTRUMENTA(glDrawElementsInstanced);
+    INSTRUMENTA(glUseProgram);
+    INSTRUMENTA(glDeleteProgram);
+    INSTRUMENTA(glActiveTexture);
+    INSTRUMENTA(glBindTexture);
+    INSTRUMENTA(glDeleteTextures);
+    INSTRUMENTA(glBindVertexArray);
+    INSTRUMENTA(glDeleteVertexArrays);
+    INSTRUMENTA(glBindBuffer);
+    INSTRUMENTA(glDeleteBuffers);
+    INSTRUMENTA(glBufferData);
+    INSTRUMENTA(glBufferSubData);
+    INSTRUMENTA(glEnable);
+    INSTRUMENTA(glDisable);
+    INSTRUMENTA(glBlendFunc);
+    INSTRUMENTA(glDepthFunc);
+    INSTRUMENTA(glGetUniformLocation);
+    INSTRUMENTA(glUniform1i);
+    INSTRUMENTA(glUniform1f);
+    INSTRUMENTA(glUniform2f);
+    INSTRUMENTA(glUniform3f);
+    INSTRUMENTA(glUniform4f);
+    INSTRUMENTA(glUniform1fv);
+    INSTRUMENTA(glUniform2fv);
+    INSTRUMENTA(glUniform3fv);
+    INSTRUMENTA(glUniform4fv);
+    INSTRUMENTA(glUniformMatrix4fv);
+    esqueceEstado();
+    memset(&contadores, 0, sizeof(contadores));
+    installed = true;
+    return true;
+}
+
+#undef INSTRUMENTA
+
+const GLCounters &GLInstrumentation::current() const {
+    return contadores;
+}
+
+void GLInstrumentation::endFrame() {
+    if (!installed) return;
+    last = contadores;
+    long long *total = &accumulated.drawCalls;
+    const long long *quadro = &contadores.drawCalls;
+    for (size_t i = 0; i < sizeof(GLCounters) / sizeof(long long); i++)
+        total[i] += quadro[i];
+    memset(&contadores, 0, sizeof(contadores));
+    frames++;
+}
+
+void GLInstrumentation::countBufferWrite(long long bytes) {
+    if (!installed) return;
+    contadores.bufferUploads++;
+    contadores.bufferBytes += bytes;
+}
+
+void GLInstrumentation::invalidateState() {
+    esqueceEstado();
+}
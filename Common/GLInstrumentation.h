@@ -0,0 +1,74 @@
+//
+//  GLInstrumentation.h
+//  Contadores de chamadas OpenGL por quadro: desenhos, vértices, trocas de
+//  programa, binds de textura e de VAO, uniformes, envios para buffers e
+//  mudanças de estado redundantes.
+//
+//  install() troca os ponteiros da GLAD (glad_glDrawArrays etc.) por versões
+//  que contam e chamam a original. Fica desligado por padrão: sem install()
+//  as chamadas vão direto ao driver, sem custo nenhum. Os contadores valem
+//  para a thread do contexto OpenGL.
+//
+//  Uso, depois do gladLoadGLLoader:
+//      g_glInstrumentation.install();
+//      while (...) { ...; glfwSwapBuffers(window); g_glInstrumentation.endFrame(); }
+//      g_glInstrumentation.lastFrame().drawCalls;
+//
+
+#ifndef GLInstrumentation_h
+#define GLInstrumentation_h
+
+struct GLCounters {
+    long long drawCalls;
+    long long vertices;              // vértices emitidos (instâncias incluídas)
+    long long programSwitches;       // glUseProgram
+    long long textureBinds;          // glBindTexture
+    long long vaoBinds;              // glBindVertexArray
+    long long uniformUploads;        // glUniform*
+    long long uniformLocationQueries;// glGetUniformLocation
+    long long bufferUploads;         // glBufferData/glBufferSubData com dados e escritas no mapeamento
+    long long bufferBytes;
+    long long redundantStateSets;    // bind/enable/função igual ao estado atual
+};
+
+class GLInstrumentation {
+public:
+    GLInstrumentation();
+
+    // Troca os ponteiros da GLAD; chamar com o contexto corrente, uma vez
+    bool install();
+    bool isInstalled() const {
+        return installed;
+    }
+
+    // Fecha o quadro: o atual vira lastFrame() e os contadores zeram
+    void endFrame();
+
+    const GLCounters &current() const;
+    const GLCounters &lastFrame() const {
+        return last;
+    }
+    const GLCounters &total() const {
+        return accumulated;
+    }
+    long long getFrames() const {
+        return frames;
+    }
+
+    // Esquece o estado conhecido (depois de código que mexe no GL por fora)
+    void invalidateState();
+
+    // Conta um envio que não passa por glBuffer*Data: escrita direta num
+    // buffer mapeado (StreamBuffer persistente)
+    void countBufferWrite(long long bytes);
+
+private:
+    bool installed;
+    GLCounters last;
+    GLCounters accumulated;
+    long long frames;
+};
+
+extern GLInstrumentation g_glInstrumentation;
+
+#endif /* GLInstrumentation_h */
@@ -0,0 +1,154 @@
+//
+//  GLStateCache.cpp
+//  Comparação com o estado conhecido antes de cada chamada de estado.
+//
+
+#include "GLStateCache.h"
+
+#include <string.h>
+
+GLStateCache g_glState;
+
+// Valor que nunca é um nome de objeto nem um enum válido: estado desconhecido
+static const GLuint DESCONHECIDO = 0xFFFFFFFFu;
+
+GLStateCache::GLStateCache() : skipped(0) {
+    invalidate();
+}
+
+void GLStateCache::invalidate() {
+    program = vao = unit = DESCONHECIDO;
+    for (int u = 0; u < MAX_TEXTURE_UNITS; u++)
+        for (int t = 0; t < TEX_TARGETS; t++)
+            textures[u][t] = DESCONHECIDO;
+    for (int b = 0; b < BUF_TARGETS; b++)
+        buffers[b] = DESCONHECIDO;
+    for (int c = 0; c < CAPS; c++)
+        capabilities[c] = DESCONHECIDO;
+    blendSource = blendDestination = depthFunction = DESCONHECIDO;
+}
+
+bool GLStateCache::same(GLuint &known, GLuint value) {
+    if (known == value) {
+        skipped++;
+        return true;
+    }
+    known = value;
+    return false;
+}
+
+int GLStateCache::textureSlot(GLenum target) {
+    switch (target) {
+    case GL_TEXTURE_2D: return TEX_2D;
+    case GL_TEXTURE_2D_ARRAY: return TEX_2D_ARRAY;
+    case GL_TEXTURE_3D: return TEX_3D;
+    case GL_TEXTURE_CUBE_MAP: return TEX_CUBE;
+    default: return -1;
+    }
+}
+
+int GLStateCache::bufferSlot(GLenum target) {
+    switch (target) {
+    case GL_ARRAY_BUFFER: return BUF_ARRAY;
+    case GL_ELEMENT_ARRAY_BUFFER: return BUF_ELEMENT;
+    case GL_UNIFORM_BUFFER: return BUF_UNIFORM;
+    case GL_COPY_READ_BUFFER: return BUF_COPY_READ;
+    case GL_COPY_WRITE_BUFFER: return BUF_COPY_WRITE;
+    case GL_PIXEL_UNPACK_BUFFER: return BUF_PIXEL_UNPACK;
+    default: return -1;
+    }
+}
+
+int GLStateCache::capabilitySlot(GLenum capability) {
+    switch (capability) {
+    case GL_BLEND: return CAP_BLEND;
+    case GL_DEPTH_TEST: return CAP_DEPTH_TEST;
+    case GL_CULL_FACE: return CAP_CULL_FACE;
+    case GL_SCISSOR_TEST: return CAP_SCISSOR_TEST;
+    case GL_STENCIL_TEST: return CAP_STENCIL_TEST;
+    default: return -1;
+    }
+}
+
+void GLStateCache::useProgram(GLuint p) {
+    if (!same(program, p)) glUseProgram(p);
+}
+
+void GLStateCache::bindVertexArray(GLuint v) {
+    if (same(vao, v)) return;
+    glBindVertexArray(v);
+    // O buffer de índices é estado do VAO
+    buffers[BUF_ELEMENT] = DESCONHECIDO;
+}
+
+void GLStateCache::activeTexture(GLenum u) {
+    if (!same(unit, u - GL_TEXTURE0)) glActiveTexture(u);
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    int t = textureSlot(target);
+    if (t < 0 || unit >= (GLuint)MAX_TEXTURE_UNITS) {
+        glBindTexture(target, texture);
+        return;
+    }
+    if (!same(textures[unit][t], texture)) glBindTexture(target, texture);
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int b = bufferSlot(target);
+    if (b < 0) {
+        glBindBuffer(target, buffer);
+        return;
+    }
+    if (!same(buffers[b], buffer)) glBindBuffer(target, buffer);
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+    int c = capabilitySlot(capability);
+    if (c >= 0 && same(capabilities[c], enabled ? 1 : 0)) return;
+    if (enabled) glEnable(capability);
+    else glDisable(capability);
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+    if (blendSource == source && blendDestination == destination) {
+        skipped++;
+        return;
+    }
+    blendSource = source;
+    blendDestination = destination;
+    glBlendFunc(source, destination);
+}
+
+void GLStateCache::depthFunc(GLenum func) {
+    if (!same(depthFunction, func)) glDepthFunc(func);
+}
+
+GLint GLStateCache::uniformLocation(GLuint p, const char *name) {
+    // Quase sempre o nome é um literal: o mesmo ponteiro acha a entrada na
+    // primeira volta. O ponteiro só serve de atalho, o texto é conferido
+    // sempre: um buffer reaproveitado (snprintf, std::string::c_str())
+    // chega com o mesmo endereço e outro nome
+    for (size_t i = 0; i < uniforms.size(); i++)
+        if (uniforms[i].program == p && uniforms[i].name == name && !strcmp(uniforms[i].nameCopy.c_str(), name))
+            return uniforms[i].location;
+    for (size_t i = 0; i < uniforms.size(); i++) {
+        if (uniforms[i].program == p && uniforms[i].nameCopy == name) {
+            uniforms[i].name = name;
+            return uniforms[i].location;
+        }
+    }
+    UniformEntry e;
+    e.program = p;
+    e.name = name;
+    e.nameCopy = name;
+    e.location = glGetUniformLocation(p, name);
+    uniforms.push_back(e);
+    return e.location;
+}
+
+void GLStateCache::forgetProgram(GLuint p) {
+    for (size_t i = uniforms.size(); i-- > 0;)
+        if (uniforms[i].program == p) uniforms.erase(uniforms.begin() + i);
+    if (program == p) program = DESCONHECIDO;
+}
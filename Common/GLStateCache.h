@@ -0,0 +1,89 @@
+//
+//  GLStateCache.h
+//  Cache do estado OpenGL: programa, VAO, texturas por unidade, buffers,
+//  blend/profundidade e locais de uniforme. Cada chamada compara com o
+//  estado conhecido e pula a chamada ao driver quando nada muda.
+//
+//  O cache só sabe o que passa por ele. Código que muda o estado direto
+//  na GL (criação de VAOs e texturas, bibliotecas de fora) deve deixar o
+//  estado como encontrou ou chamar invalidate() depois. Apagar um programa
+//  pede forgetProgram(), porque os locais de uniforme guardados morrem
+//  junto.
+//
+//  Uso:
+//      g_glState.useProgram(shader);
+//      glUniformMatrix4fv(g_glState.uniformLocation(shader, "model"), ...);
+//      g_glState.bindVertexArray(vao);
+//      g_glState.bindTexture(GL_TEXTURE_2D, tex);
+//
+
+#ifndef GLStateCache_h
+#define GLStateCache_h
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+class GLStateCache {
+public:
+    static const int MAX_TEXTURE_UNITS = 16;
+
+    GLStateCache();
+
+    // Esquece tudo; a próxima chamada de cada tipo vai ao driver
+    void invalidate();
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    void activeTexture(GLenum unit);              // GL_TEXTURE0 + n
+    void bindTexture(GLenum target, GLuint texture); // na unidade ativa
+    void bindBuffer(GLenum target, GLuint buffer);
+    void setEnabled(GLenum capability, bool enabled); // GL_BLEND, GL_DEPTH_TEST...
+    void blendFunc(GLenum source, GLenum destination);
+    void depthFunc(GLenum func);
+
+    // glGetUniformLocation com cache por programa e nome
+    GLint uniformLocation(GLuint program, const char *name);
+    void forgetProgram(GLuint program);
+
+    GLuint getProgram() const {
+        return program;
+    }
+    // Chamadas puladas desde o começo (estado já era o pedido)
+    long long getSkippedCalls() const {
+        return skipped;
+    }
+
+private:
+    enum { TEX_2D, TEX_2D_ARRAY, TEX_3D, TEX_CUBE, TEX_TARGETS };
+    enum { BUF_ARRAY, BUF_ELEMENT, BUF_UNIFORM, BUF_COPY_READ, BUF_COPY_WRITE, BUF_PIXEL_UNPACK, BUF_TARGETS };
+    enum { CAP_BLEND, CAP_DEPTH_TEST, CAP_CULL_FACE, CAP_SCISSOR_TEST, CAP_STENCIL_TEST, CAPS };
+
+    struct UniformEntry {
+        GLuint program;
+        const char *name;       // ponteiro visto por último (atalho para literais)
+        std::string nameCopy;
+        GLint location;
+    };
+
+    GLuint program;
+    GLuint vao;
+    GLuint unit;
+    GLuint textures[MAX_TEXTURE_UNITS][TEX_TARGETS];
+    GLuint buffers[BUF_TARGETS];
+    GLuint capabilities[CAPS];
+    GLuint blendSource, blendDestination;
+    GLuint depthFunction;
+    std::vector<UniformEntry> uniforms;
+    long long skipped;
+
+    bool same(GLuint &known, GLuint value);
+    static int textureSlot(GLenum target);
+    static int bufferSlot(GLenum target);
+    static int capabilitySlot(GLenum capability);
+};
+
+extern GLStateCache g_glState;
+
+#endif /* GLStateCache_h */
@@ -0,0 +1,175 @@
+//
+//  JobSystem.cpp
+//  Filas por thread, roubo, dependências e espera ajudando.
+//
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// Sistema e fila da thread atual (só as threads de trabalho definem)
+static thread_local const JobSystem *t_sistema = NULL;
+static thread_local int t_fila = 0;
+
+JobSystem::JobSystem(int workers)
+    : queued(0), stopping(false), executed(0), stolen(0) {
+    if (workers < 0) workers = (int)std::thread::hardware_concurrency() - 1;
+    workers = std::max(workers, 0);
+    for (int i = 0; i <= workers; i++) queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    for (int i = 1; i <= workers; i++) this->workers.push_back(std::thread(&JobSystem::work, this, i));
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> l(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+int JobSystem::currentSlot() const {
+    return t_sistema == this ? t_fila : 0;
+}
+
+void JobSystem::run(Job job, JobCounter *counter) {
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    Task t;
+    t.job = std::move(job);
+    t.counter = counter;
+    push(std::move(t));
+}
+
+void JobSystem::runAfter(JobCounter &dependency, Job job, JobCounter *counter) {
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+    Task t;
+    t.job = std::move(job);
+    t.counter = counter;
+
+    // O zero da dependência acontece com deferredLock preso (finish()):
+    // ou ela ainda não zerou e a tarefa entra na lista antes, ou já zerou
+    // e enfileiramos nós
+    {
+        std::lock_guard<std::mutex> l(deferredLock);
+        if (!dependency.done()) {
+            Deferred d;
+            d.dependency = &dependency;
+            d.task = std::move(t);
+            deferred.push_back(std::move(d));
+            return;
+        }
+    }
+    push(std::move(t));
+}
+
+void JobSystem::wait(JobCounter &counter) {
+    while (!counter.done()) {
+        if (!helpOne()) std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(int count, int grain, const std::function<void(int, int)> &body) {
+    if (count <= 0) return;
+    grain = std::max(grain, 1);
+    JobCounter feito;
+    for (int inicio = grain; inicio < count; inicio += grain) {
+        int fim = std::min(inicio + grain, count);
+        run([&body, inicio, fim] { body(inicio, fim); }, &feito);
+    }
+    body(0, std::min(grain, count));
+    wait(feito);
+}
+
+bool JobSystem::helpOne() {
+    return execute(currentSlot());
+}
+
+void JobSystem::push(Task task) {
+    Queue &q = *queues[currentSlot()];
+    {
+        std::lock_guard<std::mutex> l(q.lock);
+        q.tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    if (workers.empty()) return;
+    // Passa pelo lock para não acordar antes de uma thread começar a dormir
+    { std::lock_guard<std::mutex> l(sleepLock); }
+    wake.notify_one();
+}
+
+bool JobSystem::execute(int slot) {
+    if (queued.load() <= 0) return false;
+
+    Task t;
+    bool achou = false;
+    {
+        // A própria fila pelo fim: a tarefa mais recente
+        Queue &q = *queues[slot];
+        std::lock_guard<std::mutex> l(q.lock);
+        if (!q.tasks.empty()) {
+            t = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            achou = true;
+        }
+    }
+    int n = (int)queues.size();
+    for (int i = 1; i < n && !achou; i++) {
+        // As outras pelo começo: as mais antigas, em geral as maiores
+        Queue &q = *queues[(slot + i) % n];
+        std::lock_guard<std::mutex> l(q.lock);
+        if (!q.tasks.empty()) {
+            t = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            achou = true;
+            stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (!achou) return false;
+
+    queued.fetch_sub(1);
+    t.job();
+    executed.fetch_add(1, std::memory_order_relaxed);
+    finish(t.counter);
+    return true;
+}
+
+void JobSystem::finish(JobCounter *counter) {
+    if (!counter) return;
+    // Enquanto não é a última tarefa do grupo, desce sem lock
+    int n = counter->pending.load(std::memory_order_relaxed);
+    while (n > 1) {
+        if (counter->pending.compare_exchange_weak(n, n - 1)) return;
+    }
+
+    // Pode ser a última: desce com o lock das adiadas e tira da lista as que
+    // esperavam por ela antes de soltá-lo. Depois do zero quem espera pode
+    // descartar o contador e criar outro no mesmo endereço; um runAfter
+    // sobre o novo só entra na lista depois daqui, então o endereço nunca é
+    // comparado com o de um contador que já morreu
+    std::vector<Task> liberadas;
+    {
+        std::lock_guard<std::mutex> l(deferredLock);
+        if (counter->pending.fetch_sub(1) != 1) return;
+        for (size_t i = 0; i < deferred.size();) {
+            if (deferred[i].dependency == counter) {
+                liberadas.push_back(std::move(deferred[i].task));
+                deferred[i] = std::move(deferred.back());
+                deferred.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    for (size_t i = 0; i < liberadas.size(); i++) push(std::move(liberadas[i]));
+}
+
+void JobSystem::work(int slot) {
+    t_sistema = this;
+    t_fila = slot;
+    for (;;) {
+        if (execute(slot)) continue;
+        std::unique_lock<std::mutex> l(sleepLock);
+        if (stopping) return;
+        wake.wait(l, [this] { return stopping || queued.load() > 0; });
+    }
+}
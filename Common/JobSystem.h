@@ -0,0 +1,135 @@
+//
+//  JobSystem.h
+//  Tarefas curtas espalhadas por threads fixas, com roubo de trabalho.
+//
+//  Cada thread de trabalho tem a sua fila dupla: empilha e retira do fim
+//  (a tarefa mais recente, ainda quente na cache) e, quando a sua acaba,
+//  rouba do começo da fila de outra. Quem não é thread do sistema (a
+//  principal, o salvamento) usa a fila 0. Assim não é preciso criar
+//  threads para decodificar texturas, ler mapas, gravar listas de desenho
+//  ou buscar caminhos: tudo vira tarefa aqui.
+//
+//  Quem espera não fica parado: wait(contador) executa tarefas pendentes
+//  até o contador zerar, inclusive de dentro de outra tarefa. Com zero
+//  threads de trabalho tudo roda na thread que espera.
+//
+//  Dependências são contadores: runAfter(dep, tarefa) só enfileira a
+//  tarefa quando dep zerar.
+//
+//  Uso:
+//      JobSystem jobs;
+//      JobCounter pronto;
+//      jobs.run([&] { decodifica(a); }, &pronto);
+//      jobs.run([&] { decodifica(b); }, &pronto);
+//      jobs.runAfter(pronto, [&] { monta(a, b); }, &montado);
+//      ...
+//      jobs.wait(montado);
+//
+//      jobs.parallelFor(n, 64, [&](int inicio, int fim) { ... });
+//
+
+#ifndef JobSystem_h
+#define JobSystem_h
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef std::function<void()> Job;
+
+// Tarefas em andamento de um grupo. Só pode ser descartado depois de zerar.
+class JobCounter {
+public:
+    JobCounter() : pending(0) {}
+
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    bool done() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending;
+};
+
+class JobSystem {
+public:
+    // Threads de trabalho além de quem espera; negativo: um a menos que os núcleos
+    explicit JobSystem(int workers = -1);
+    ~JobSystem();
+
+    // Enfileira a tarefa; counter (se houver) sobe agora e desce quando ela termina
+    void run(Job job, JobCounter *counter = NULL);
+
+    // Como run(), mas a tarefa só entra na fila quando dependency zerar
+    void runAfter(JobCounter &dependency, Job job, JobCounter *counter = NULL);
+
+    // Executa tarefas até counter zerar
+    void wait(JobCounter &counter);
+
+    // Divide [0, count) em pedaços de até grain e chama body(inicio, fim)
+    // em paralelo; volta quando todos terminarem
+    void parallelFor(int count, int grain, const std::function<void(int, int)> &body);
+
+    // Executa uma tarefa pendente, se houver
+    bool helpOne();
+
+    // Threads que executam tarefas, contando a que espera
+    int getThreads() const {
+        return (int)queues.size();
+    }
+
+    // Fila da thread que chama, em [0, getThreads()): serve de índice para
+    // dados de rascunho por thread. Todas as threads de fora dão 0, então
+    // só uma delas pode esperar usando esses dados.
+    int currentSlot() const;
+
+    // Tarefas executadas e, delas, quantas foram roubadas de outra fila
+    long long getExecuted() const {
+        return executed.load(std::memory_order_relaxed);
+    }
+    long long getStolen() const {
+        return stolen.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Task {
+        Job job;
+        JobCounter *counter;
+    };
+    struct Queue {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+    struct Deferred {
+        JobCounter *dependency;
+        Task task;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;  // 0: threads de fora
+    std::vector<std::thread> workers;
+    std::atomic<int> queued;                      // tarefas nas filas
+    std::mutex sleepLock;
+    std::condition_variable wake;
+    bool stopping;
+
+    std::mutex deferredLock;
+    std::vector<Deferred> deferred;               // esperando a dependência
+
+    std::atomic<long long> executed, stolen;
+
+    void push(Task task);
+    bool execute(int slot);
+    void finish(JobCounter *counter);
+    void work(int slot);
+};
+
+#endif /* JobSystem_h */
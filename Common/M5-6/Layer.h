@@ -1,7 +1,15 @@
+#ifndef Layer_h
+#define Layer_h
+
+// Camada de fundo para parallax (ver ParallaxRenderer.h): tid é a fatia
+// da textura array; offsetx/offsety, o deslocamento atual em coordenadas
+// de textura; ratex/ratey, quanto a camada anda por unidade de câmera.
 typedef struct Layer {
 		float z;
 		unsigned int tid;
-		char * filename;
+		const char * filename;
 		float offsetx, offsety, ratex, ratey;
 	
-} Layer;
\ No newline at end of file
+} Layer;
+
+#endif /* Layer_h */
@@ -17,6 +17,17 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 
+// SSE versions of the mat4 kernels (mat4 * mat4 also has an AVX one). x86-64
+// always has SSE2; AVX is only used if the compiler is allowed to emit it
+// (-mavx or -march=native). Anything else gets the scalar code.
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATHS_FUNCS_SIMD
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MATHS_FUNCS_SIMD
+#endif
+
 /*--------------------------------CONSTRUCTORS--------------------------------*/
 vec2::vec2 () {}
 
@@ -309,7 +320,8 @@ mat4 identity_mat4 () {
  3  7 11 15
 */
 
-vec4 mat4::operator* (const vec4& rhs) {
+vec4 mat4_mul_vec4_scalar (const mat4& a, const vec4& rhs) {
+	const float* m = a.m;
 	// 0x + 4y + 8z + 12w
 	float x =
 		m[0] * rhs.v[0] +
@@ -334,7 +346,8 @@ vec4 mat4::operator* (const vec4& rhs) {
 	return vec4 (x, y, z, w);
 }
 
-mat4 mat4::operator* (const mat4& rhs) {
+mat4 mat4_mul_scalar (const mat4& a, const mat4& rhs) {
+	const float* m = a.m;
 	mat4 r = zero_mat4 ();
 	int r_index = 0;
 	for (int col = 0; col < 4; col++) {
@@ -350,10 +363,79 @@ mat4 mat4::operator* (const mat4& rhs) {
 	return r;
 }
 
+vec4 mat4::operator* (const vec4& rhs) {
+#ifdef MATHS_FUNCS_SIMD
+	// same sums as the scalar version, one column at a time
+	__m128 r = _mm_mul_ps (_mm_loadu_ps (m), _mm_set1_ps (rhs.v[0]));
+	r = _mm_add_ps (r, _mm_mul_ps (_mm_loadu_ps (m + 4), _mm_set1_ps (rhs.v[1])));
+	r = _mm_add_ps (r, _mm_mul_ps (_mm_loadu_ps (m + 8), _mm_set1_ps (rhs.v[2])));
+	r = _mm_add_ps (r, _mm_mul_ps (_mm_loadu_ps (m + 12), _mm_set1_ps (rhs.v[3])));
+	vec4 result;
+	_mm_storeu_ps (result.v, r);
+	return result;
+#else
+	return mat4_mul_vec4_scalar (*this, rhs);
+#endif
+}
+
+/* column c of the result is this * (column c of rhs), i.e. the columns of
+this scaled by the 4 values of that column and added in the same order as the
+scalar loop, so both give the same floats (barring FMA contraction) */
+mat4 mat4::operator* (const mat4& rhs) {
+#if defined(__AVX__)
+	// two result columns per register: lane i of each half is broadcast from
+	// its own column of rhs by the in-lane shuffle
+	const __m256 c0 = _mm256_broadcast_ps ((const __m128*)m);
+	const __m256 c1 = _mm256_broadcast_ps ((const __m128*)(m + 4));
+	const __m256 c2 = _mm256_broadcast_ps ((const __m128*)(m + 8));
+	const __m256 c3 = _mm256_broadcast_ps ((const __m128*)(m + 12));
+	mat4 r;
+	for (int i = 0; i < 16; i += 8) {
+		__m256 b = _mm256_loadu_ps (rhs.m + i);
+		__m256 s = _mm256_mul_ps (c0, _mm256_shuffle_ps (b, b, 0x00));
+		s = _mm256_add_ps (s, _mm256_mul_ps (c1, _mm256_shuffle_ps (b, b, 0x55)));
+		s = _mm256_add_ps (s, _mm256_mul_ps (c2, _mm256_shuffle_ps (b, b, 0xAA)));
+		s = _mm256_add_ps (s, _mm256_mul_ps (c3, _mm256_shuffle_ps (b, b, 0xFF)));
+		_mm256_storeu_ps (r.m + i, s);
+	}
+	return r;
+#elif defined(MATHS_FUNCS_SIMD)
+	const __m128 c0 = _mm_loadu_ps (m);
+	const __m128 c1 = _mm_loadu_ps (m + 4);
+	const __m128 c2 = _mm_loadu_ps (m + 8);
+	const __m128 c3 = _mm_loadu_ps (m + 12);
+	mat4 r;
+	for (int i = 0; i < 16; i += 4) {
+		__m128 b = _mm_loadu_ps (rhs.m + i);
+		__m128 s = _mm_mul_ps (c0, _mm_shuffle_ps (b, b, 0x00));
+		s = _mm_add_ps (s, _mm_mul_ps (c1, _mm_shuffle_ps (b, b, 0x55)));
+		s = _mm_add_ps (s, _mm_mul_ps (c2, _mm_shuffle_ps (b, b, 0xAA)));
+		s = _mm_add_ps (s, _mm_mul_ps (c3, _mm_shuffle_ps (b, b, 0xFF)));
+		_mm_storeu_ps (r.m + i, s);
+	}
+	return r;
+#else
+	return mat4_mul_scalar (*this, rhs);
+#endif
+}
+
 mat4& mat4::operator= (const mat4& rhs) {
+#ifdef MATHS_FUNCS_SIMD
+	// the loop below turns into a call to memcpy, which costs more than the
+	// products above
+	__m128 c0 = _mm_loadu_ps (rhs.m);
+	__m128 c1 = _mm_loadu_ps (rhs.m + 4);
+	__m128 c2 = _mm_loadu_ps (rhs.m + 8);
+	__m128 c3 = _mm_loadu_ps (rhs.m + 12);
+	_mm_storeu_ps (m, c0);
+	_mm_storeu_ps (m + 4, c1);
+	_mm_storeu_ps (m + 8, c2);
+	_mm_storeu_ps (m + 12, c3);
+#else
 	for (int i = 0; i < 16; i++) {
 		m[i] = rhs.m[i];
 	}
+#endif
 	return *this;
 }
 
@@ -389,7 +471,7 @@ float determinant (const mat4& mm) {
 
 /* returns a 16-element array that is the inverse of a 16-element array (4x4
 matrix). see http://www.euclideanspace.com/maths/algebra/matrix/functions/inverse/fourD/index.htm */
-mat4 inverse (const mat4& mm) {
+mat4 inverse_scalar (const mat4& mm) {
 	float det = determinant (mm);
 	/* there is no inverse if determinant is zero (not likely unless scale is
 	broken) */
@@ -484,7 +566,7 @@ mat4 inverse (const mat4& mm) {
 }
 
 // returns a 16-element array flipped on the main diagonal
-mat4 transpose (const mat4& mm) {
+mat4 transpose_scalar (const mat4& mm) {
 	return mat4 (
 		mm.m[0], mm.m[4], mm.m[8], mm.m[12],
 		mm.m[1], mm.m[5], mm.m[9], mm.m[13],
@@ -493,6 +575,114 @@ mat4 transpose (const mat4& mm) {
 	);
 }
 
+#ifdef MATHS_FUNCS_SIMD
+// lanes of a picked as (x, y, z, w); _mm_shuffle_ps takes the mask backwards
+#define SWIZZLE(a, x, y, z, w) _mm_shuffle_ps (a, a, _MM_SHUFFLE (w, z, y, x))
+#define SHUFFLE(a, b, x, y, z, w) _mm_shuffle_ps (a, b, _MM_SHUFFLE (w, z, y, x))
+
+/* the 2x2 helpers below work on 2x2 blocks stored as (m00, m01, m10, m11).
+A * B */
+static inline __m128 mat2_mul (__m128 a, __m128 b) {
+	return _mm_add_ps (_mm_mul_ps (a, SWIZZLE (b, 0, 3, 0, 3)),
+		_mm_mul_ps (SWIZZLE (a, 1, 0, 3, 2), SWIZZLE (b, 2, 1, 2, 1)));
+}
+
+// adj(A) * B
+static inline __m128 mat2_adj_mul (__m128 a, __m128 b) {
+	return _mm_sub_ps (_mm_mul_ps (SWIZZLE (a, 3, 3, 0, 0), b),
+		_mm_mul_ps (SWIZZLE (a, 1, 1, 2, 2), SWIZZLE (b, 2, 3, 0, 1)));
+}
+
+// A * adj(B)
+static inline __m128 mat2_mul_adj (__m128 a, __m128 b) {
+	return _mm_sub_ps (_mm_mul_ps (a, SWIZZLE (b, 3, 0, 3, 0)),
+		_mm_mul_ps (SWIZZLE (a, 1, 0, 3, 2), SWIZZLE (b, 2, 1, 2, 1)));
+}
+#endif
+
+/* blockwise inverse: the matrix is split in four 2x2 blocks and the inverse
+is built from their determinants and adjugates, which is about a third of the
+multiplies of the cofactor expansion and all 4-wide. the layout does not
+matter: the same code on the transposed array gives the transposed inverse.
+results differ from inverse_scalar () by rounding only */
+mat4 inverse (const mat4& mm) {
+#ifdef MATHS_FUNCS_SIMD
+	__m128 c0 = _mm_loadu_ps (mm.m);
+	__m128 c1 = _mm_loadu_ps (mm.m + 4);
+	__m128 c2 = _mm_loadu_ps (mm.m + 8);
+	__m128 c3 = _mm_loadu_ps (mm.m + 12);
+	__m128 a = _mm_movelh_ps (c0, c1);
+	__m128 b = _mm_movehl_ps (c1, c0);
+	__m128 c = _mm_movelh_ps (c2, c3);
+	__m128 d = _mm_movehl_ps (c3, c2);
+
+	// (|A|, |B|, |C|, |D|)
+	__m128 det_sub = _mm_sub_ps (
+		_mm_mul_ps (SHUFFLE (c0, c2, 0, 2, 0, 2), SHUFFLE (c1, c3, 1, 3, 1, 3)),
+		_mm_mul_ps (SHUFFLE (c0, c2, 1, 3, 1, 3), SHUFFLE (c1, c3, 0, 2, 0, 2)));
+	__m128 det_a = SWIZZLE (det_sub, 0, 0, 0, 0);
+	__m128 det_b = SWIZZLE (det_sub, 1, 1, 1, 1);
+	__m128 det_c = SWIZZLE (det_sub, 2, 2, 2, 2);
+	__m128 det_d = SWIZZLE (det_sub, 3, 3, 3, 3);
+
+	__m128 d_c = mat2_adj_mul (d, c);
+	__m128 a_b = mat2_adj_mul (a, b);
+	// adjugates of the blocks of the inverse, before the 1/det
+	__m128 x = _mm_sub_ps (_mm_mul_ps (det_d, a), mat2_mul (b, d_c));
+	__m128 w = _mm_sub_ps (_mm_mul_ps (det_a, d), mat2_mul (c, a_b));
+	__m128 y = _mm_sub_ps (_mm_mul_ps (det_b, c), mat2_mul_adj (d, a_b));
+	__m128 z = _mm_sub_ps (_mm_mul_ps (det_c, b), mat2_mul_adj (a, d_c));
+
+	// |M| = |A||D| + |B||C| - tr (adj(A)B adj(D)C)
+	__m128 tr = _mm_mul_ps (a_b, SWIZZLE (d_c, 0, 2, 1, 3));
+	tr = _mm_add_ps (tr, SWIZZLE (tr, 2, 3, 0, 1));
+	tr = _mm_add_ps (tr, SWIZZLE (tr, 1, 0, 3, 2));
+	__m128 det = _mm_sub_ps (_mm_add_ps (_mm_mul_ps (det_a, det_d), _mm_mul_ps (det_b, det_c)), tr);
+	if (0.0f == _mm_cvtss_f32 (det)) {
+		fprintf (stderr, "WARNING. matrix has no determinant. can not invert\n");
+		return mm;
+	}
+	__m128 inv_det = _mm_div_ps (_mm_setr_ps (1.0f, -1.0f, -1.0f, 1.0f), det);
+	x = _mm_mul_ps (x, inv_det);
+	y = _mm_mul_ps (y, inv_det);
+	z = _mm_mul_ps (z, inv_det);
+	w = _mm_mul_ps (w, inv_det);
+
+	// undo the adjugate swizzle while putting the blocks back in place
+	mat4 r;
+	_mm_storeu_ps (r.m, SHUFFLE (x, y, 3, 1, 3, 1));
+	_mm_storeu_ps (r.m + 4, SHUFFLE (x, y, 2, 0, 2, 0));
+	_mm_storeu_ps (r.m + 8, SHUFFLE (z, w, 3, 1, 3, 1));
+	_mm_storeu_ps (r.m + 12, SHUFFLE (z, w, 2, 0, 2, 0));
+	return r;
+#else
+	return inverse_scalar (mm);
+#endif
+}
+
+mat4 transpose (const mat4& mm) {
+#ifdef MATHS_FUNCS_SIMD
+	__m128 c0 = _mm_loadu_ps (mm.m);
+	__m128 c1 = _mm_loadu_ps (mm.m + 4);
+	__m128 c2 = _mm_loadu_ps (mm.m + 8);
+	__m128 c3 = _mm_loadu_ps (mm.m + 12);
+	_MM_TRANSPOSE4_PS (c0, c1, c2, c3);
+	mat4 r;
+	_mm_storeu_ps (r.m, c0);
+	_mm_storeu_ps (r.m + 4, c1);
+	_mm_storeu_ps (r.m + 8, c2);
+	_mm_storeu_ps (r.m + 12, c3);
+	return r;
+#else
+	return transpose_scalar (mm);
+#endif
+}
+
+#ifdef MATHS_FUNCS_SIMD
+#undef SWIZZLE
+#undef SHUFFLE
+#endif
+
 /*--------------------------AFFINE MATRIX FUNCTIONS---------------------------*/
 // translate a 4d matrix with xyz array
 mat4 translate (const mat4& m, const vec3& v) {
@@ -548,6 +738,241 @@ mat4 scale (const mat4& m, const vec3& v) {
 	return a * m;
 }
 
+/*-------------------------------BATCH FUNCTIONS------------------------------*/
+/* one loop over whole arrays instead of a call per point: 8 points per
+iteration with AVX, 4 with SSE and the scalar code for the rest. every sum is
+done in the order of mat4_mul_vec4_scalar (), so a point comes out the same
+as through mat4 * vec4. all inputs of a block are loaded before anything is
+stored, which is what lets the outputs overwrite the inputs */
+
+static inline void transform_one (const float* a, float x, float y, float z,
+	float w, float* ox, float* oy, float* oz, float* ow) {
+	float rx = a[0] * x + a[4] * y + a[8] * z + a[12] * w;
+	float ry = a[1] * x + a[5] * y + a[9] * z + a[13] * w;
+	float rz = a[2] * x + a[6] * y + a[10] * z + a[14] * w;
+	float rw = a[3] * x + a[7] * y + a[11] * z + a[15] * w;
+	*ox = rx;
+	*oy = ry;
+	if (oz) {
+		*oz = rz;
+	}
+	if (ow) {
+		*ow = rw;
+	}
+}
+
+void transform_points (const mat4& m, const float* x, const float* y,
+	const float* z, int n, float* ox, float* oy, float* oz) {
+	const float* a = m.m;
+	int i = 0;
+#if defined(__AVX__)
+	__m256 zero = _mm256_setzero_ps ();
+	__m256 c[12];
+	for (int k = 0; k < 3; k++) {
+		for (int j = 0; j < 4; j++) {
+			c[k * 4 + j] = _mm256_set1_ps (a[k + j * 4]);
+		}
+	}
+	for (; i + 8 <= n; i += 8) {
+		__m256 vx = _mm256_loadu_ps (x + i);
+		__m256 vy = _mm256_loadu_ps (y + i);
+		__m256 vz = z ? _mm256_loadu_ps (z + i) : zero;
+		__m256 r[3];
+		for (int k = 0; k < 3; k++) {
+			__m256 s = _mm256_add_ps (_mm256_mul_ps (c[k * 4], vx), _mm256_mul_ps (c[k * 4 + 1], vy));
+			s = _mm256_add_ps (s, _mm256_mul_ps (c[k * 4 + 2], vz));
+			r[k] = _mm256_add_ps (s, c[k * 4 + 3]);
+		}
+		_mm256_storeu_ps (ox + i, r[0]);
+		_mm256_storeu_ps (oy + i, r[1]);
+		if (oz) {
+			_mm256_storeu_ps (oz + i, r[2]);
+		}
+	}
+#elif defined(MATHS_FUNCS_SIMD)
+	__m128 zero = _mm_setzero_ps ();
+	__m128 c[12];
+	for (int k = 0; k < 3; k++) {
+		for (int j = 0; j < 4; j++) {
+			c[k * 4 + j] = _mm_set1_ps (a[k + j * 4]);
+		}
+	}
+	for (; i + 4 <= n; i += 4) {
+		__m128 vx = _mm_loadu_ps (x + i);
+		__m128 vy = _mm_loadu_ps (y + i);
+		__m128 vz = z ? _mm_loadu_ps (z + i) : zero;
+		__m128 r[3];
+		for (int k = 0; k < 3; k++) {
+			__m128 s = _mm_add_ps (_mm_mul_ps (c[k * 4], vx), _mm_mul_ps (c[k * 4 + 1], vy));
+			s = _mm_add_ps (s, _mm_mul_ps (c[k * 4 + 2], vz));
+			r[k] = _mm_add_ps (s, c[k * 4 + 3]);
+		}
+		_mm_storeu_ps (ox + i, r[0]);
+		_mm_storeu_ps (oy + i, r[1]);
+		if (oz) {
+			_mm_storeu_ps (oz + i, r[2]);
+		}
+	}
+#endif
+	for (; i < n; i++) {
+		transform_one (a, x[i], y[i], z ? z[i] : 0.0f, 1.0f, ox + i, oy + i,
+			oz ? oz + i : NULL, NULL);
+	}
+}
+
+void transform_vec4s (const mat4& m, const float* x, const float* y,
+	const float* z, const float* w, int n, float* ox, float* oy, float* oz,
+	float* ow) {
+	const float* a = m.m;
+	int i = 0;
+#if defined(__AVX__)
+	__m256 c[16];
+	for (int k = 0; k < 4; k++) {
+		for (int j = 0; j < 4; j++) {
+			c[k * 4 + j] = _mm256_set1_ps (a[k + j * 4]);
+		}
+	}
+	for (; i + 8 <= n; i += 8) {
+		__m256 vx = _mm256_loadu_ps (x + i);
+		__m256 vy = _mm256_loadu_ps (y + i);
+		__m256 vz = _mm256_loadu_ps (z + i);
+		__m256 vw = _mm256_loadu_ps (w + i);
+		__m256 r[4];
+		for (int k = 0; k < 4; k++) {
+			__m256 s = _mm256_add_ps (_mm256_mul_ps (c[k * 4], vx), _mm256_mul_ps (c[k * 4 + 1], vy));
+			s = _mm256_add_ps (s, _mm256_mul_ps (c[k * 4 + 2], vz));
+			r[k] = _mm256_add_ps (s, _mm256_mul_ps (c[k * 4 + 3], vw));
+		}
+		_mm256_storeu_ps (ox + i, r[0]);
+		_mm256_storeu_ps (oy + i, r[1]);
+		_mm256_storeu_ps (oz + i, r[2]);
+		_mm256_storeu_ps (ow + i, r[3]);
+	}
+#elif defined(MATHS_FUNCS_SIMD)
+	__m128 c[16];
+	for (int k = 0; k < 4; k++) {
+		for (int j = 0; j < 4; j++) {
+			c[k * 4 + j] = _mm_set1_ps (a[k + j * 4]);
+		}
+	}
+	for (; i + 4 <= n; i += 4) {
+		__m128 vx = _mm_loadu_ps (x + i);
+		__m128 vy = _mm_loadu_ps (y + i);
+		__m128 vz = _mm_loadu_ps (z + i);
+		__m128 vw = _mm_loadu_ps (w + i);
+		__m128 r[4];
+		for (int k = 0; k < 4; k++) {
+			__m128 s = _mm_add_ps (_mm_mul_ps (c[k * 4], vx), _mm_mul_ps (c[k * 4 + 1], vy));
+			s = _mm_add_ps (s, _mm_mul_ps (c[k * 4 + 2], vz));
+			r[k] = _mm_add_ps (s, _mm_mul_ps (c[k * 4 + 3], vw));
+		}
+		_mm_storeu_ps (ox + i, r[0]);
+		_mm_storeu_ps (oy + i, r[1]);
+		_mm_storeu_ps (oz + i, r[2]);
+		_mm_storeu_ps (ow + i, r[3]);
+	}
+#endif
+	for (; i < n; i++) {
+		transform_one (a, x[i], y[i], z[i], w[i], ox + i, oy + i, oz + i, ow + i);
+	}
+}
+
+void iso_to_screen (const float* gx, const float* gy, int n, float tile_w,
+	float tile_h, float origin_x, float origin_y, float* sx, float* sy) {
+	float hw = tile_w * 0.5f;
+	float hh = tile_h * 0.5f;
+	int i = 0;
+#if defined(__AVX__)
+	__m256 vhw = _mm256_set1_ps (hw);
+	__m256 vhh = _mm256_set1_ps (hh);
+	__m256 vox = _mm256_set1_ps (origin_x);
+	__m256 voy = _mm256_set1_ps (origin_y);
+	for (; i + 8 <= n; i += 8) {
+		__m256 x = _mm256_loadu_ps (gx + i);
+		__m256 y = _mm256_loadu_ps (gy + i);
+		__m256 rx = _mm256_add_ps (vox, _mm256_mul_ps (_mm256_sub_ps (x, y), vhw));
+		__m256 ry = _mm256_add_ps (voy, _mm256_mul_ps (_mm256_add_ps (x, y), vhh));
+		_mm256_storeu_ps (sx + i, rx);
+		_mm256_storeu_ps (sy + i, ry);
+	}
+#elif defined(MATHS_FUNCS_SIMD)
+	__m128 vhw = _mm_set1_ps (hw);
+	__m128 vhh = _mm_set1_ps (hh);
+	__m128 vox = _mm_set1_ps (origin_x);
+	__m128 voy = _mm_set1_ps (origin_y);
+	for (; i + 4 <= n; i += 4) {
+		__m128 x = _mm_loadu_ps (gx + i);
+		__m128 y = _mm_loadu_ps (gy + i);
+		__m128 rx = _mm_add_ps (vox, _mm_mul_ps (_mm_sub_ps (x, y), vhw));
+		__m128 ry = _mm_add_ps (voy, _mm_mul_ps (_mm_add_ps (x, y), vhh));
+		_mm_storeu_ps (sx + i, rx);
+		_mm_storeu_ps (sy + i, ry);
+	}
+#endif
+	for (; i < n; i++) {
+		float x = gx[i];
+		float y = gy[i];
+		sx[i] = origin_x + (x - y) * hw;
+		sy[i] = origin_y + (x + y) * hh;
+	}
+}
+
+/* the compare gives a bit per box; every lane index is written and the
+count only moves past the visible ones, so there is no branch per box */
+int cull_aabbs (const float* min_x, const float* min_y, const float* max_x,
+	const float* max_y, int n, float rect_min_x, float rect_min_y,
+	float rect_max_x, float rect_max_y, int* visible) {
+	int count = 0;
+	int i = 0;
+#if defined(__AVX__)
+	__m256 rx0 = _mm256_set1_ps (rect_min_x);
+	__m256 ry0 = _mm256_set1_ps (rect_min_y);
+	__m256 rx1 = _mm256_set1_ps (rect_max_x);
+	__m256 ry1 = _mm256_set1_ps (rect_max_y);
+	for (; i + 8 <= n; i += 8) {
+		__m256 in = _mm256_and_ps (
+			_mm256_and_ps (_mm256_cmp_ps (_mm256_loadu_ps (max_x + i), rx0, _CMP_GE_OQ),
+				_mm256_cmp_ps (_mm256_loadu_ps (min_x + i), rx1, _CMP_LE_OQ)),
+			_mm256_and_ps (_mm256_cmp_ps (_mm256_loadu_ps (max_y + i), ry0, _CMP_GE_OQ),
+				_mm256_cmp_ps (_mm256_loadu_ps (min_y + i), ry1, _CMP_LE_OQ)));
+		int bits = _mm256_movemask_ps (in);
+		if (!bits) {
+			continue;
+		}
+		for (int k = 0; k < 8; k++) {
+			visible[count] = i + k;
+			count += (bits >> k) & 1;
+		}
+	}
+#elif defined(MATHS_FUNCS_SIMD)
+	__m128 rx0 = _mm_set1_ps (rect_min_x);
+	__m128 ry0 = _mm_set1_ps (rect_min_y);
+	__m128 rx1 = _mm_set1_ps (rect_max_x);
+	__m128 ry1 = _mm_set1_ps (rect_max_y);
+	for (; i + 4 <= n; i += 4) {
+		__m128 in = _mm_and_ps (
+			_mm_and_ps (_mm_cmpge_ps (_mm_loadu_ps (max_x + i), rx0),
+				_mm_cmple_ps (_mm_loadu_ps (min_x + i), rx1)),
+			_mm_and_ps (_mm_cmpge_ps (_mm_loadu_ps (max_y + i), ry0),
+				_mm_cmple_ps (_mm_loadu_ps (min_y + i), ry1)));
+		int bits = _mm_movemask_ps (in);
+		if (!bits) {
+			continue;
+		}
+		for (int k = 0; k < 4; k++) {
+			visible[count] = i + k;
+			count += (bits >> k) & 1;
+		}
+	}
+#endif
+	for (; i < n; i++) {
+		visible[count] = i;
+		count += max_x[i] >= rect_min_x && min_x[i] <= rect_max_x &&
+			max_y[i] >= rect_min_y && min_y[i] <= rect_max_y;
+	}
+	return count;
+}
+
 /*-----------------------VIRTUAL CAMERA MATRIX FUNCTIONS----------------------*/
 // returns a view matrix using the opengl lookAt style. COLUMN ORDER.
 mat4 look_at (const vec3& cam_pos, vec3 targ_pos, const vec3& up) {
@@ -134,12 +134,39 @@ mat4 identity_mat4 ();
 float determinant (const mat4& mm);
 mat4 inverse (const mat4& mm);
 mat4 transpose (const mat4& mm);
+// mat4 * mat4, mat4 * vec4, inverse and transpose use SSE/AVX where the
+// compiler has it. these are the plain versions: the fallback, and the
+// reference the SIMD ones are checked against
+mat4 mat4_mul_scalar (const mat4& a, const mat4& b);
+vec4 mat4_mul_vec4_scalar (const mat4& a, const vec4& v);
+mat4 inverse_scalar (const mat4& mm);
+mat4 transpose_scalar (const mat4& mm);
 // affine functions
 mat4 translate (const mat4& m, const vec3& v);
 mat4 rotate_x_deg (const mat4& m, float deg);
 mat4 rotate_y_deg (const mat4& m, float deg);
 mat4 rotate_z_deg (const mat4& m, float deg);
 mat4 scale (const mat4& m, const vec3& v);
+// batch functions. arrays are structure-of-arrays: point i is (x[i], y[i],
+// z[i]). they use SSE/AVX like the mat4 kernels and give the same floats as
+// the one-at-a-time versions. outputs may be the same arrays as the inputs
+// transform n points (w = 1, no divide) by m; z may be NULL for 2D points
+// (z = 0) and oz may be NULL if not needed
+void transform_points (const mat4& m, const float* x, const float* y,
+	const float* z, int n, float* ox, float* oy, float* oz);
+// transform n vec4s by m
+void transform_vec4s (const mat4& m, const float* x, const float* y,
+	const float* z, const float* w, int n, float* ox, float* oy, float* oz,
+	float* ow);
+// isometric grid (gx, gy) to screen: the top corner of tile (0, 0) goes to
+// (origin_x, origin_y), +gx goes right-down and +gy left-down
+void iso_to_screen (const float* gx, const float* gy, int n, float tile_w,
+	float tile_h, float origin_x, float origin_y, float* sx, float* sy);
+// writes the indices of the boxes that touch the rect [rect_min, rect_max]
+// to visible (room for n) and returns how many there are, in order
+int cull_aabbs (const float* min_x, const float* min_y, const float* max_x,
+	const float* max_y, int n, float rect_min_x, float rect_min_y,
+	float rect_max_x, float rect_max_y, int* visible);
 // camera functions
 mat4 look_at (const vec3& cam_pos, vec3 targ_pos, const vec3& up);
 mat4 perspective (float fovy, float aspect, float near, float far);
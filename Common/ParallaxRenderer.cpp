@@ -0,0 +1,336 @@
+//
+//  ParallaxRenderer.cpp
+//  Textura array das camadas, reamostragem, máscaras dos ladrilhos e o desenho.
+//
+
+#include "ParallaxRenderer.h"
+#include "GLStateCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+
+// Um ladrilho por instância, em até quatro cópias (divisor 4 no atributo):
+// a 0 no lugar do ladrilho na tela e as outras só quando ele passa da borda
+// direita ou de baixo e precisa reaparecer do outro lado
+static const char *PARALLAX_VS =
+    "#version 330 core\n"
+    "#define MAX_LAYERS 64\n"
+    "layout (location = 0) in vec3 aTile;\n"  // coluna, linha, camada
+    "out vec3 vUV;\n"
+    "uniform vec2 uOffsets[MAX_LAYERS];\n"
+    "uniform int uLayerCount;\n"
+    "uniform vec2 uSize;\n"
+    "uniform float uTile;\n"
+    "void main() {\n"
+    "    int camada = int(aTile.z);\n"
+    "    vec2 inicio = aTile.xy * uTile;\n"
+    "    vec2 fim = min(inicio + uTile, uSize);\n"
+    "    vec2 texel = mix(inicio, fim, vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)));\n"
+    "    vec2 deslocamento = uOffsets[camada] * uSize;\n"
+    // Voltas inteiras da textura que levam o ladrilho para [0, uSize); os
+    // vértices compartilhados fazem a mesma conta e não abrem frestas
+    "    vec2 volta = floor((inicio - deslocamento) / uSize) * uSize;\n"
+    "    vec2 copia = vec2(float(gl_InstanceID & 1), float((gl_InstanceID >> 1) & 1));\n"
+    "    bvec2 sobra = greaterThan(inicio - deslocamento - volta + (fim - inicio), uSize);\n"
+    "    if ((copia.x > 0.0 && !sobra.x) || (copia.y > 0.0 && !sobra.y)) {\n"
+    "        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);\n"  // cópia desnecessária: fora da tela
+    "        vUV = vec3(0.0);\n"
+    "        return;\n"
+    "    }\n"
+    "    vec2 tela = (texel - deslocamento) - (volta + copia * uSize);\n"
+    "    float z = 1.0 - 2.0 * float(camada + 1) / float(uLayerCount + 1);\n"  // mais próxima, menor
+    "    gl_Position = vec4(tela.x / uSize.x * 2.0 - 1.0, 1.0 - tela.y / uSize.y * 2.0, z, 1.0);\n"
+    "    vUV = vec3(texel / uSize, aTile.z);\n"
+    "}\n";
+
+static const char *PARALLAX_FS =
+    "#version 330 core\n"
+    "in vec3 vUV;\n"
+    "out vec4 FragColor;\n"
+    "uniform sampler2DArray uLayers;\n"
+    "void main() {\n"
+    "    FragColor = texture(uLayers, vUV);\n"
+    "}\n";
+
+// Ladrilho na lista de instâncias
+struct Tile {
+    GLshort x, y, layer, pad;
+};
+
+static GLuint compila(GLenum tipo, const char *fonte) {
+    GLuint s = glCreateShader(tipo);
+    glShaderSource(s, 1, &fonte, NULL);
+    glCompileShader(s);
+    GLint ok;
+    glGetShaderiv(s, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[512];
+        glGetShaderInfoLog(s, sizeof(log), NULL, log);
+        fprintf(stderr, "ParallaxRenderer: shader não compilou:\n%s\n", log);
+    }
+    return s;
+}
+
+ParallaxRenderer::ParallaxRenderer()
+    : program(0), texture(0), instances(0), vaoOpaque(0), vaoTranslucent(0), locOffsets(-1), locCount(-1),
+      width(0), height(0), tilesX(0), tilesY(0), opaqueTiles(0), translucentTiles(0), mipmapsDirty(false),
+      tilesDirty(false) {}
+
+bool ParallaxRenderer::create(const std::vector<Layer> &layers, int width, int height) {
+    destroy();
+    if (layers.empty() || (int)layers.size() > MAX_LAYERS) {
+        fprintf(stderr, "ParallaxRenderer: %d camadas (máximo %d)\n", (int)layers.size(), MAX_LAYERS);
+        return false;
+    }
+    this->layers = layers;
+    this->width = width;
+    this->height = height;
+    for (size_t i = 0; i < this->layers.size(); i++) this->layers[i].tid = (unsigned int)i;
+    offsets.assign(layers.size() * 2, 0.0f);
+    tilesX = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tilesY = (height + TILE_SIZE - 1) / TILE_SIZE;
+    tiles.assign(layers.size(), std::vector<unsigned char>((size_t)tilesX * tilesY, TILE_EMPTY));
+    fullyOpaque.assign(layers.size(), false);
+    tilesDirty = true;
+
+    GLuint vs = compila(GL_VERTEX_SHADER, PARALLAX_VS);
+    GLuint fs = compila(GL_FRAGMENT_SHADER, PARALLAX_FS);
+    program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    GLint ok;
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        fprintf(stderr, "ParallaxRenderer: programa não ligou\n");
+        destroy();
+        return false;
+    }
+    locOffsets = glGetUniformLocation(program, "uOffsets");
+    locCount = glGetUniformLocation(program, "uLayerCount");
+    g_glState.useProgram(program);
+    glUniform1i(glGetUniformLocation(program, "uLayers"), 0);
+    glUniform2f(glGetUniformLocation(program, "uSize"), (float)width, (float)height);
+    glUniform1f(glGetUniformLocation(program, "uTile"), (float)TILE_SIZE);
+
+    // Um buffer de ladrilhos e um VAO para cada passada; o dos translúcidos
+    // começa onde terminam os opacos (buildTiles acerta o ponteiro)
+    glGenBuffers(1, &instances);
+    glGenVertexArrays(1, &vaoOpaque);
+    glGenVertexArrays(1, &vaoTranslucent);
+
+    glGenTextures(1, &texture);
+    g_glState.activeTexture(GL_TEXTURE0);
+    g_glState.bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, (GLsizei)layers.size(), 0, GL_RGBA,
+                 GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    mipmapsDirty = true;
+    return true;
+}
+
+void ParallaxRenderer::destroy() {
+    if (program) {
+        g_glState.forgetProgram(program);
+        glDeleteProgram(program);
+    }
+    if (vaoOpaque) {
+        g_glState.bindVertexArray(0);
+        glDeleteVertexArrays(1, &vaoOpaque);
+        glDeleteVertexArrays(1, &vaoTranslucent);
+    }
+    if (instances) {
+        g_glState.bindBuffer(GL_ARRAY_BUFFER, 0);
+        glDeleteBuffers(1, &instances);
+    }
+    if (texture) {
+        g_glState.activeTexture(GL_TEXTURE0);
+        g_glState.bindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glDeleteTextures(1, &texture);
+    }
+    program = texture = instances = vaoOpaque = vaoTranslucent = 0;
+    layers.clear();
+    offsets.clear();
+    tiles.clear();
+    fullyOpaque.clear();
+    opaqueTiles = translucentTiles = 0;
+}
+
+void ParallaxRenderer::setLayerImage(int layer, const unsigned char *pixels, int w, int h, int channels) {
+    if (!texture || layer < 0 || layer >= (int)layers.size() || !pixels || w <= 0 || h <= 0) return;
+
+    // RGBA no tamanho da textura; cada texel é a média da área que cobre na
+    // imagem original (serve para reduzir e, com área mínima de 1, ampliar)
+    rgba.resize((size_t)width * height * 4);
+    for (int y = 0; y < height; y++) {
+        int y0 = y * h / height;
+        int y1 = std::max((y + 1) * h / height, y0 + 1);
+        for (int x = 0; x < width; x++) {
+            int x0 = x * w / width;
+            int x1 = std::max((x + 1) * w / width, x0 + 1);
+            unsigned soma[4] = {0, 0, 0, 0};
+            for (int sy = y0; sy < y1; sy++) {
+                const unsigned char *p = pixels + ((size_t)sy * w + x0) * channels;
+                for (int sx = x0; sx < x1; sx++, p += channels) {
+                    if (channels >= 3) {
+                        soma[0] += p[0];
+                        soma[1] += p[1];
+                        soma[2] += p[2];
+                        soma[3] += channels == 4 ? p[3] : 255;
+                    } else {
+                        soma[0] += p[0];
+                        soma[1] += p[0];
+                        soma[2] += p[0];
+                        soma[3] += 255;
+                    }
+                }
+            }
+            unsigned n = (unsigned)((y1 - y0) * (x1 - x0));
+            unsigned char *d = &rgba[((size_t)y * width + x) * 4];
+            for (int c = 0; c < 4; c++) d[c] = (unsigned char)((soma[c] + n / 2) / n);
+        }
+    }
+
+    g_glState.activeTexture(GL_TEXTURE0);
+    g_glState.bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+    mipmapsDirty = true;
+    classify(layer);
+}
+
+void ParallaxRenderer::classify(int layer) {
+    // O filtro linear mistura o texel da borda com o vizinho: o ladrilho é
+    // olhado com um texel a mais de cada lado (dando a volta, por causa do
+    // GL_REPEAT), para que um "opaco" nunca amostre alfa abaixo de 1 nem um
+    // "vazio" amostre algo acima de 0
+    std::vector<unsigned char> &kinds = tiles[layer];
+    bool todoOpaco = true;
+    for (int ty = 0; ty < tilesY; ty++) {
+        int y0 = ty * TILE_SIZE - 1;
+        int y1 = std::min((ty + 1) * TILE_SIZE, height) + 1;
+        for (int tx = 0; tx < tilesX; tx++) {
+            int x0 = tx * TILE_SIZE - 1;
+            int x1 = std::min((tx + 1) * TILE_SIZE, width) + 1;
+            int menor = 255, maior = 0;
+            for (int y = y0; y < y1; y++) {
+                const unsigned char *linha = &rgba[(size_t)((y + height) % height) * width * 4];
+                for (int x = x0; x < x1; x++) {
+                    int a = linha[((x + width) % width) * 4 + 3];
+                    menor = std::min(menor, a);
+                    maior = std::max(maior, a);
+                }
+            }
+            unsigned char tipo = menor == 255 ? TILE_OPAQUE : maior == 0 ? TILE_EMPTY : TILE_TRANSLUCENT;
+            kinds[(size_t)ty * tilesX + tx] = tipo;
+            if (tipo != TILE_OPAQUE) todoOpaco = false;
+        }
+    }
+    fullyOpaque[layer] = todoOpaco;
+    tilesDirty = true;
+}
+
+void ParallaxRenderer::buildTiles() {
+    tilesDirty = false;
+    int n = (int)layers.size();
+
+    // A camada toda opaca mais próxima esconde as que estão atrás dela
+    int primeira = 0;
+    for (int i = n - 1; i >= 0; i--) {
+        if (fullyOpaque[i]) {
+            primeira = i;
+            break;
+        }
+    }
+
+    // Opacos da frente para trás (o depth test rejeita o que fica atrás
+    // antes de amostrar); translúcidos de trás para a frente (o blend exige)
+    std::vector<Tile> lista;
+    for (int i = n - 1; i >= primeira; i--) {
+        for (int t = 0; t < tilesX * tilesY; t++) {
+            if (tiles[i][t] != TILE_OPAQUE) continue;
+            Tile tile = {(GLshort)(t % tilesX), (GLshort)(t / tilesX), (GLshort)i, 0};
+            lista.push_back(tile);
+        }
+    }
+    opaqueTiles = (int)lista.size();
+    for (int i = primeira; i < n; i++) {
+        for (int t = 0; t < tilesX * tilesY; t++) {
+            if (tiles[i][t] != TILE_TRANSLUCENT) continue;
+            Tile tile = {(GLshort)(t % tilesX), (GLshort)(t / tilesX), (GLshort)i, 0};
+            lista.push_back(tile);
+        }
+    }
+    translucentTiles = (int)lista.size() - opaqueTiles;
+
+    g_glState.bindBuffer(GL_ARRAY_BUFFER, instances);
+    glBufferData(GL_ARRAY_BUFFER, lista.size() * sizeof(Tile), lista.empty() ? NULL : lista.data(), GL_STATIC_DRAW);
+    GLuint vaos[2] = {vaoOpaque, vaoTranslucent};
+    size_t inicio[2] = {0, (size_t)opaqueTiles * sizeof(Tile)};
+    for (int v = 0; v < 2; v++) {
+        g_glState.bindVertexArray(vaos[v]);
+        glVertexAttribPointer(0, 3, GL_SHORT, GL_FALSE, sizeof(Tile), (void *)inicio[v]);
+        glEnableVertexAttribArray(0);
+        glVertexAttribDivisor(0, 4);
+    }
+}
+
+bool ParallaxRenderer::coversScreen() const {
+    for (size_t i = 0; i < fullyOpaque.size(); i++)
+        if (fullyOpaque[i]) return true;
+    return false;
+}
+
+void ParallaxRenderer::scroll(float dx, float dy) {
+    for (size_t i = 0; i < layers.size(); i++) {
+        Layer &l = layers[i];
+        // Só a parte fracionária importa (GL_REPEAT); mantém a precisão do float
+        l.offsetx += dx * l.ratex;
+        l.offsety += dy * l.ratey;
+        l.offsetx -= floorf(l.offsetx);
+        l.offsety -= floorf(l.offsety);
+    }
+}
+
+void ParallaxRenderer::draw() {
+    if (!program) return;
+    if (tilesDirty) buildTiles();
+    int n = (int)layers.size();
+    for (int i = 0; i < n; i++) {
+        offsets[i * 2] = layers[i].offsetx;
+        offsets[i * 2 + 1] = layers[i].offsety;
+    }
+
+    g_glState.useProgram(program);
+    g_glState.activeTexture(GL_TEXTURE0);
+    g_glState.bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    if (mipmapsDirty) {
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        mipmapsDirty = false;
+    }
+    glUniform2fv(locOffsets, n, offsets.data());
+    glUniform1i(locCount, n);
+
+    g_glState.setEnabled(GL_DEPTH_TEST, true);
+    g_glState.depthFunc(GL_LESS);
+    if (opaqueTiles > 0) {
+        g_glState.setEnabled(GL_BLEND, false);
+        g_glState.bindVertexArray(vaoOpaque);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, opaqueTiles * 4);
+    }
+    g_glState.setEnabled(GL_BLEND, true);
+    g_glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    if (translucentTiles > 0) {
+        glDepthMask(GL_FALSE);
+        g_glState.bindVertexArray(vaoTranslucent);
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, translucentTiles * 4);
+        glDepthMask(GL_TRUE);
+    }
+    g_glState.setEnabled(GL_DEPTH_TEST, false);
+}
@@ -0,0 +1,111 @@
+//
+//  ParallaxRenderer.h
+//  Camadas de fundo com parallax desenhadas sem pintar o que fica escondido.
+//
+//  Cada camada (Layer.h) é uma fatia de uma textura GL_TEXTURE_2D_ARRAY,
+//  todas do mesmo tamanho, com GL_REPEAT, rolando pelo seu deslocamento de
+//  UV. Empilhar camadas de tela inteira com blend custa uma passada de tela
+//  por camada, e a maior parte dela pinta pixels que a camada da frente vai
+//  cobrir de novo. Para evitar isso, cada imagem é dividida em ladrilhos de
+//  TILE_SIZE texels ao ser enviada, e cada ladrilho é classificado pela sua
+//  máscara de alfa:
+//
+//    - vazio (alfa 0 em tudo): não é desenhado;
+//    - opaco (alfa 255 em tudo): desenhado sem blend, da camada mais
+//      próxima para a mais distante, gravando profundidade; o teste de
+//      profundidade descarta o que fica atrás antes de amostrar a textura;
+//    - translúcido (o resto, em geral as bordas dos desenhos): desenhado
+//      com blend, da mais distante para a mais próxima, testando mas sem
+//      gravar profundidade, por cima dos opacos.
+//
+//  Uma camada toda opaca esconde todas as de trás, que nem entram na lista,
+//  e cobre a tela: nesse caso coversScreen() diz que a cor não precisa ser
+//  limpa. São dois glDrawArraysInstanced por quadro, qualquer que seja o
+//  número de camadas; a emenda da repetição é uma segunda cópia só dos
+//  ladrilhos que passam da borda.
+//
+//  O desenho usa o depth buffer: limpe a profundidade antes (e a cor só se
+//  coversScreen() for falso). No fim, o teste de profundidade fica
+//  desligado e o blend, ligado com GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA.
+//
+//  Uso (contexto OpenGL corrente):
+//      std::vector<Layer> camadas(5);      // ratex/ratey de cada uma
+//      parallax.create(camadas, 800, 600);
+//      parallax.setLayerImage(0, pixels, w, h, canais);  // para cada camada
+//      ...
+//      parallax.scroll(dx, 0.0f);          // câmera andou dx larguras de tela
+//      glClear(parallax.coversScreen() ? GL_DEPTH_BUFFER_BIT
+//                                      : GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+//      parallax.draw();
+//
+
+#ifndef ParallaxRenderer_h
+#define ParallaxRenderer_h
+
+#include <glad/glad.h>
+
+#include <vector>
+
+#include "Layer.h"
+
+class ParallaxRenderer {
+public:
+    static const int MAX_LAYERS = 64;
+    static const int TILE_SIZE = 32;
+
+    ParallaxRenderer();
+
+    // Cria a textura array com uma fatia de width x height por camada. As
+    // camadas são copiadas; tid vira o índice da fatia.
+    bool create(const std::vector<Layer> &layers, int width, int height);
+    void destroy();
+
+    // Envia a imagem da camada (1, 3 ou 4 canais, primeira linha no topo) e
+    // refaz a máscara dos seus ladrilhos. Imagens de outro tamanho são
+    // reamostradas para o da textura.
+    void setLayerImage(int layer, const unsigned char *pixels, int width, int height, int channels);
+
+    // A câmera andou (dx, dy) em larguras e alturas de tela; cada camada
+    // anda ratex/ratey vezes isso
+    void scroll(float dx, float dy);
+
+    // Alguma camada é toda opaca: o fundo cobre a tela inteira
+    bool coversScreen() const;
+
+    // Desenha todas as camadas: ladrilhos opacos e depois os translúcidos
+    void draw();
+
+    int getLayerCount() const {
+        return (int)layers.size();
+    }
+    Layer &getLayer(int i) {
+        return layers[i];
+    }
+
+    // Ladrilhos desenhados por quadro (com a cópia da emenda contada uma vez)
+    int getOpaqueTiles() const {
+        return opaqueTiles;
+    }
+    int getTranslucentTiles() const {
+        return translucentTiles;
+    }
+
+private:
+    enum TileKind { TILE_EMPTY, TILE_OPAQUE, TILE_TRANSLUCENT };
+
+    std::vector<Layer> layers;
+    std::vector<float> offsets;     // vec2 por camada, enviado em draw()
+    std::vector<unsigned char> rgba;
+    std::vector<std::vector<unsigned char> > tiles;  // TileKind por ladrilho, por camada
+    std::vector<bool> fullyOpaque;
+    GLuint program, texture, instances, vaoOpaque, vaoTranslucent;
+    GLint locOffsets, locCount;
+    int width, height, tilesX, tilesY;
+    int opaqueTiles, translucentTiles;
+    bool mipmapsDirty, tilesDirty;
+
+    void classify(int layer);
+    void buildTiles();
+};
+
+#endif /* ParallaxRenderer_h */
@@ -0,0 +1,325 @@
+//
+//  Pathfinding.cpp
+//  A* e Jump Point Search sobre WalkGrid.
+//
+
+#include "Pathfinding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdlib.h>
+
+#define SQRT2 1.41421356f
+
+// As 8 direções, na mesma ordem em que são testadas na expansão
+static const int DIR_X[8] = { -1,  0,  1, 1, 1, 0, -1, -1 };
+static const int DIR_Y[8] = { -1, -1, -1, 0, 1, 1,  1,  0 };
+
+static inline int sign(int v) {
+    return (v > 0) - (v < 0);
+}
+
+Pathfinder::Pathfinder() : generation(0), width(0), height(0) {
+}
+
+float Pathfinder::octile(int dx, int dy) {
+    dx = abs(dx);
+    dy = abs(dy);
+    int lo = std::min(dx, dy);
+    int hi = std::max(dx, dy);
+    return lo * SQRT2 + (hi - lo);
+}
+
+void Pathfinder::prepare(const WalkGrid &grid) {
+    size_t n = (size_t)grid.getWidth() * grid.getHeight();
+    if (grid.getWidth() != width || grid.getHeight() != height || g.size() != n) {
+        width = grid.getWidth();
+        height = grid.getHeight();
+        g.assign(n, 0.0f);
+        parent.assign(n, -1);
+        stamp.assign(n, 0);
+        closedStamp.assign(n, 0);
+        generation = 0;
+    }
+    generation++;
+    if (generation == 0) {
+        // deu a volta no contador: limpa as marcas uma vez
+        std::fill(stamp.begin(), stamp.end(), 0);
+        std::fill(closedStamp.begin(), closedStamp.end(), 0);
+        generation = 1;
+    }
+    heap.clear();
+}
+
+// Ordena a heap por menor f; no empate prefere o nó mais perto do destino
+bool Pathfinder::heapGreater(const HeapNode &a, const HeapNode &b) {
+    if (a.f != b.f) return a.f > b.f;
+    return a.h > b.h;
+}
+
+void Pathfinder::push(int index, float f, float h) {
+    HeapNode node = { f, h, index };
+    heap.push_back(node);
+    std::push_heap(heap.begin(), heap.end(), heapGreater);
+}
+
+Pathfinder::HeapNode Pathfinder::pop() {
+    std::pop_heap(heap.begin(), heap.end(), heapGreater);
+    HeapNode node = heap.back();
+    heap.pop_back();
+    return node;
+}
+
+bool Pathfinder::relax(int index, int from, float newG, int goalX, int goalY) {
+    if (closedStamp[index] == generation) return false;
+    if (stamp[index] == generation && g[index] <= newG) return false;
+    stamp[index] = generation;
+    g[index] = newG;
+    parent[index] = from;
+    float h = octile(index % width - goalX, index / width - goalY);
+    push(index, newG + h, h);
+    return true;
+}
+
+bool Pathfinder::findPath(const WalkGrid &grid, GridPoint start, GridPoint goal,
+                          PathResult &out, PathAlgorithm algorithm) {
+    out.found = false;
+    out.cost = 0.0f;
+    out.expanded = 0;
+    out.waypoints.clear();
+
+    if (!grid.isWalkable(start.x, start.y) || !grid.isWalkable(goal.x, goal.y))
+        return false;
+    if (start == goal) {
+        out.found = true;
+        out.waypoints.push_back(start);
+        return true;
+    }
+
+    prepare(grid);
+    int s = start.y * width + start.x;
+    stamp[s] = generation;
+    g[s] = 0.0f;
+    parent[s] = -1;
+    float h = octile(start.x - goal.x, start.y - goal.y);
+    push(s, h, h);
+
+    if (algorithm == PATH_ASTAR) searchAStar(grid, goal, out);
+    else searchJPS(grid, goal, out);
+
+    if (out.found) buildPath(goal, out);
+    return out.found;
+}
+
+void Pathfinder::searchAStar(const WalkGrid &grid, GridPoint goal, PathResult &out) {
+    int goalIndex = goal.y * width + goal.x;
+    while (!heap.empty()) {
+        HeapNode node = pop();
+        if (closedStamp[node.index] == generation) continue; // entrada velha na heap
+        closedStamp[node.index] = generation;
+        out.expanded++;
+        if (node.index == goalIndex) {
+            out.found = true;
+            out.cost = g[node.index];
+            return;
+        }
+        int x = node.index % width;
+        int y = node.index / width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + DIR_X[d];
+            int ny = y + DIR_Y[d];
+            if (!grid.isWalkable(nx, ny)) continue;
+            float step = (DIR_X[d] != 0 && DIR_Y[d] != 0) ? SQRT2 : 1.0f;
+            relax(ny * width + nx, node.index, g[node.index] + step, goal.x, goal.y);
+        }
+    }
+}
+
+// Salto em linha reta (horizontal ou vertical). Para no destino ou quando
+// encontra um vizinho forçado, isto é, uma célula que só é alcançada pelo
+// caminho ótimo passando pela célula atual.
+bool Pathfinder::jumpStraight(const WalkGrid &grid, int x, int y, int dx, int dy,
+                              GridPoint goal, GridPoint &jp) const {
+    if (dy == 0) return jumpHorizontal(grid, x, y, dx, goal, jp);
+    while (true) {
+        if (!grid.isWalkable(x, y)) return false;
+        if (x == goal.x && y == goal.y) break;
+        if (dx != 0) {
+            if ((grid.isWalkable(x + dx, y + 1) && !grid.isWalkable(x, y + 1)) ||
+                (grid.isWalkable(x + dx, y - 1) && !grid.isWalkable(x, y - 1)))
+                break;
+        } else {
+            if ((grid.isWalkable(x + 1, y + dy) && !grid.isWalkable(x + 1, y)) ||
+                (grid.isWalkable(x - 1, y + dy) && !grid.isWalkable(x - 1, y)))
+                break;
+        }
+        x += dx;
+        y += dy;
+    }
+    jp.x = x;
+    jp.y = y;
+    return true;
+}
+
+// Salto horizontal com 64 células por iteração. Numa palavra da linha, o
+// vizinho forçado em cima aparece onde a célula de cima está bloqueada e a
+// seguinte (no sentido do salto) está livre; idem para baixo. O salto para
+// no primeiro bit que seja forçado, bloqueado ou o destino. Chegar à
+// palavra-guarda da linha é bater na borda: acaba ali, antes de ler as
+// vizinhas dela, que para a primeira e a última linha já passam das
+// guardas da WalkGrid.
+bool Pathfinder::jumpHorizontal(const WalkGrid &grid, int x, int y, int dx,
+                                GridPoint goal, GridPoint &jp) const {
+    if (!grid.inside(x, y)) return false;
+    const uint64_t *cima = grid.row(y - 1);
+    const uint64_t *meio = grid.row(y);
+    const uint64_t *baixo = grid.row(y + 1);
+    int i = x >> 6;
+    uint64_t inicio = dx > 0 ? ~0ull << (x & 63) : ~0ull >> (63 - (x & 63));
+    int goalWord = (goal.y == y) ? (goal.x >> 6) : -2;
+    int palavras = grid.getStride();
+
+    while (true) {
+        if (i < 0 || i >= palavras) return false;
+        uint64_t c = cima[i], b = baixo[i];
+        uint64_t cProx, bProx;
+        if (dx > 0) {
+            cProx = (c >> 1) | (cima[i + 1] << 63);
+            bProx = (b >> 1) | (baixo[i + 1] << 63);
+        } else {
+            cProx = (c << 1) | (cima[i - 1] >> 63);
+            bProx = (b << 1) | (baixo[i - 1] >> 63);
+        }
+        uint64_t parada = (cProx & ~c) | (bProx & ~b) | ~meio[i];
+        if (i == goalWord) parada |= 1ull << (goal.x & 63);
+        parada &= inicio;
+        if (parada) {
+            int bit = dx > 0 ? walkgrid_ctz(parada) : 63 - walkgrid_clz(parada);
+            if (!((meio[i] >> bit) & 1)) return false;
+            jp.x = i * 64 + bit;
+            jp.y = y;
+            return true;
+        }
+        i += dx;
+        inicio = ~0ull;
+    }
+}
+
+// Salto genérico: nas diagonais, cada passo dispara dois saltos retos e
+// para assim que um deles encontra algo
+bool Pathfinder::jump(const WalkGrid &grid, int x, int y, int dx, int dy,
+                      GridPoint goal, GridPoint &jp) const {
+    if (dx == 0 || dy == 0) return jumpStraight(grid, x, y, dx, dy, goal, jp);
+
+    GridPoint ignorado;
+    while (true) {
+        if (!grid.isWalkable(x, y)) return false;
+        if (x == goal.x && y == goal.y) break;
+        if ((grid.isWalkable(x - dx, y + dy) && !grid.isWalkable(x - dx, y)) ||
+            (grid.isWalkable(x + dx, y - dy) && !grid.isWalkable(x, y - dy)))
+            break;
+        if (jumpStraight(grid, x + dx, y, dx, 0, goal, ignorado) ||
+            jumpStraight(grid, x, y + dy, 0, dy, goal, ignorado))
+            break;
+        x += dx;
+        y += dy;
+    }
+    jp.x = x;
+    jp.y = y;
+    return true;
+}
+
+void Pathfinder::searchJPS(const WalkGrid &grid, GridPoint goal, PathResult &out) {
+    int goalIndex = goal.y * width + goal.x;
+    int vizX[8], vizY[8];
+
+    while (!heap.empty()) {
+        HeapNode node = pop();
+        if (closedStamp[node.index] == generation) continue;
+        closedStamp[node.index] = generation;
+        out.expanded++;
+        if (node.index == goalIndex) {
+            out.found = true;
+            out.cost = g[node.index];
+            return;
+        }
+        int x = node.index % width;
+        int y = node.index / width;
+
+        // Vizinhos podados: sem pai, todas as direções; com pai, só as
+        // naturais na direção de chegada mais as forçadas
+        int n = 0;
+        if (parent[node.index] < 0) {
+            for (int d = 0; d < 8; d++) {
+                vizX[n] = DIR_X[d];
+                vizY[n] = DIR_Y[d];
+                n++;
+            }
+        } else {
+            int px = parent[node.index] % width;
+            int py = parent[node.index] / width;
+            int dx = sign(x - px);
+            int dy = sign(y - py);
+            if (dx != 0 && dy != 0) {
+                vizX[n] = 0;   vizY[n] = dy;  n++;
+                vizX[n] = dx;  vizY[n] = 0;   n++;
+                vizX[n] = dx;  vizY[n] = dy;  n++;
+                if (!grid.isWalkable(x - dx, y)) { vizX[n] = -dx; vizY[n] = dy;  n++; }
+                if (!grid.isWalkable(x, y - dy)) { vizX[n] = dx;  vizY[n] = -dy; n++; }
+            } else if (dx != 0) {
+                vizX[n] = dx;  vizY[n] = 0;   n++;
+                if (!grid.isWalkable(x, y + 1)) { vizX[n] = dx; vizY[n] = 1;  n++; }
+                if (!grid.isWalkable(x, y - 1)) { vizX[n] = dx; vizY[n] = -1; n++; }
+            } else {
+                vizX[n] = 0;   vizY[n] = dy;  n++;
+                if (!grid.isWalkable(x + 1, y)) { vizX[n] = 1;  vizY[n] = dy; n++; }
+                if (!grid.isWalkable(x - 1, y)) { vizX[n] = -1; vizY[n] = dy; n++; }
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            GridPoint jp;
+            if (!jump(grid, x + vizX[i], y + vizY[i], vizX[i], vizY[i], goal, jp)) continue;
+            float newG = g[node.index] + octile(jp.x - x, jp.y - y);
+            relax(jp.y * width + jp.x, node.index, newG, goal.x, goal.y);
+        }
+    }
+}
+
+// Reconstrói o caminho pelos pais, do objetivo até a origem (sem pai), e
+// remove pontos colineares
+void Pathfinder::buildPath(GridPoint goal, PathResult &out) const {
+    std::vector<GridPoint> &pts = out.waypoints;
+    for (int i = goal.y * width + goal.x; i >= 0; i = parent[i]) {
+        GridPoint p = { i % width, i / width };
+        pts.push_back(p);
+    }
+    std::reverse(pts.begin(), pts.end());
+
+    size_t n = 1;
+    for (size_t i = 1; i < pts.size(); i++) {
+        if (i + 1 < pts.size()) {
+            int d1x = sign(pts[i].x - pts[n - 1].x), d1y = sign(pts[i].y - pts[n - 1].y);
+            int d2x = sign(pts[i + 1].x - pts[i].x), d2y = sign(pts[i + 1].y - pts[i].y);
+            if (d1x == d2x && d1y == d2y) continue;
+        }
+        pts[n++] = pts[i];
+    }
+    pts.resize(n);
+}
+
+void Pathfinder::expandPath(const std::vector<GridPoint> &waypoints, std::vector<GridPoint> &cells) {
+    cells.clear();
+    if (waypoints.empty()) return;
+    cells.push_back(waypoints[0]);
+    for (size_t i = 1; i < waypoints.size(); i++) {
+        GridPoint p = waypoints[i - 1];
+        int dx = sign(waypoints[i].x - p.x);
+        int dy = sign(waypoints[i].y - p.y);
+        while (p != waypoints[i]) {
+            p.x += dx;
+            p.y += dy;
+            cells.push_back(p);
+        }
+    }
+}
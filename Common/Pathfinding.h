@@ -0,0 +1,77 @@
+//
+//  Pathfinding.h
+//  Busca de caminhos sobre uma WalkGrid.
+//
+//  Movimento em 8 direções com custo 1 nas retas e sqrt(2) nas diagonais,
+//  as mesmas direções do key_callback do Joguinho. Como o jogo só testa a
+//  célula de destino, a diagonal pode "cortar quina" de barreiras e a busca
+//  segue a mesma regra. A heurística é a distância octil, que é exata em
+//  grade livre.
+//
+//  O caminho é devolvido compacto: só os pontos onde a direção muda (mais
+//  origem e destino). Entre dois pontos consecutivos o trecho é sempre uma
+//  reta ou diagonal pura, e expandPath() reconstrói célula a célula.
+//
+
+#ifndef Pathfinding_h
+#define Pathfinding_h
+
+#include "WalkGrid.h"
+#include <vector>
+
+enum PathAlgorithm {
+    PATH_ASTAR,     // A* clássico, expande vizinho a vizinho
+    PATH_JPS        // Jump Point Search, expande só pontos de salto
+};
+
+struct PathResult {
+    bool found;
+    float cost;                        // custo octil total
+    int expanded;                      // nós retirados da fila
+    std::vector<GridPoint> waypoints;  // caminho compacto (origem ... destino)
+};
+
+class Pathfinder {
+public:
+    Pathfinder();
+
+    // Procura caminho de start até goal. Retorna out.found.
+    bool findPath(const WalkGrid &grid, GridPoint start, GridPoint goal,
+                  PathResult &out, PathAlgorithm algorithm = PATH_JPS);
+
+    // Converte pontos de virada em sequência completa de células
+    static void expandPath(const std::vector<GridPoint> &waypoints, std::vector<GridPoint> &cells);
+
+    static float octile(int dx, int dy);
+
+private:
+    struct HeapNode {
+        float f, h;
+        int index;
+    };
+
+    // Estado reaproveitado entre consultas: "stamp" marca em qual busca
+    // o nó foi tocado, evitando limpar vetores do tamanho da grade
+    std::vector<float> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> stamp;
+    std::vector<uint32_t> closedStamp;
+    std::vector<HeapNode> heap;
+    uint32_t generation;
+    int width, height;
+
+    static bool heapGreater(const HeapNode &a, const HeapNode &b);
+    void prepare(const WalkGrid &grid);
+    void push(int index, float f, float h);
+    HeapNode pop();
+    bool relax(int index, int from, float newG, int goalX, int goalY);
+
+    void searchAStar(const WalkGrid &grid, GridPoint goal, PathResult &out);
+    void searchJPS(const WalkGrid &grid, GridPoint goal, PathResult &out);
+    bool jump(const WalkGrid &grid, int x, int y, int dx, int dy, GridPoint goal, GridPoint &jp) const;
+    bool jumpStraight(const WalkGrid &grid, int x, int y, int dx, int dy, GridPoint goal, GridPoint &jp) const;
+    bool jumpHorizontal(const WalkGrid &grid, int x, int y, int dx, GridPoint goal, GridPoint &jp) const;
+    void buildPath(GridPoint goal, PathResult &out) const;
+};
+
+#endif /* Pathfinding_h */
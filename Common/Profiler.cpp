@@ -0,0 +1,332 @@
+//
+//  Profiler.cpp
+//  Zonas de CPU/GPU, leitura atrasada das consultas, sobreposição com
+//  stb_easy_font e exportação do trace.
+//
+
+#include "Profiler.h"
+#include "GLInstrumentation.h"
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+
+#include "stb_easy_font.h"
+
+Profiler g_profiler;
+
+// Peso do quadro novo na média móvel da sobreposição
+static const double PESO_MEDIA = 0.1;
+
+Profiler::Profiler()
+    : enabled(false), gpuTimers(false), overlayVisible(false), frameOpen(false), current(0), depth(0),
+      droppedGpuFrames(0), start(Clock::now()), gpuOffset(0.0),
+      overlayProgram(0), overlayVao(0), overlayVbo(0), overlayColorLoc(-1), overlayScreenLoc(-1) {
+    for (int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        frames[i].usedQueries = 0;
+        frames[i].pending = false;
+    }
+}
+
+double Profiler::now() const {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void Profiler::setEnabled(bool on) {
+    enabled = on;
+    frameOpen = false;
+    depth = 0;
+    if (!on) return;
+    gpuTimers = (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query) && glQueryCounter && glGetInteger64v;
+    if (gpuTimers) {
+        // Alinha o relógio da GPU ao da CPU (a deriva em uma sessão é desprezível)
+        GLint64 t = 0;
+        glGetInteger64v(GL_TIMESTAMP, &t);
+        gpuOffset = now() - t * 1e-9;
+    }
+}
+
+void Profiler::beginFrame() {
+    if (!enabled) return;
+    Frame &f = frames[current];
+    // Consultas de FRAMES_IN_FLIGHT quadros atrás ainda na GPU: descarta em vez de esperar
+    if (f.pending && !tryResolve(f)) {
+        f.pending = false;
+        droppedGpuFrames++;
+    }
+    f.zones.clear();
+    f.usedQueries = 0;
+    frameOpen = true;
+    depth = 0;
+    beginZone("Quadro");
+}
+
+int Profiler::beginZone(const char *name) {
+    if (!enabled || !frameOpen) return -1;
+    Frame &f = frames[current];
+    Zone z;
+    z.name = name;
+    z.depth = depth++;
+    z.gpuQuery = -1;
+    if (gpuTimers) {
+        if (f.usedQueries + 2 > (int)f.queries.size()) {
+            size_t antes = f.queries.size();
+            f.queries.resize(antes + 32);
+            glGenQueries(32, &f.queries[antes]);
+        }
+        z.gpuQuery = f.usedQueries;
+        f.usedQueries += 2;
+        glQueryCounter(f.queries[z.gpuQuery], GL_TIMESTAMP);
+    }
+    z.cpuBegin = now();
+    z.cpuEnd = z.cpuBegin;
+    f.zones.push_back(z);
+    return (int)f.zones.size() - 1;
+}
+
+void Profiler::endZone(int zone) {
+    if (!enabled || !frameOpen || zone < 0) return;
+    Frame &f = frames[current];
+    Zone &z = f.zones[zone];
+    z.cpuEnd = now();
+    if (z.gpuQuery >= 0) glQueryCounter(f.queries[z.gpuQuery + 1], GL_TIMESTAMP);
+    depth = z.depth;
+}
+
+void Profiler::endFrame() {
+    if (!enabled || !frameOpen) return;
+    endZone(0);
+    frameOpen = false;
+    Frame &f = frames[current];
+    if (gpuTimers) f.pending = true;
+    else resolve(f, false);
+    current = (current + 1) % FRAMES_IN_FLIGHT;
+
+    // Quadros anteriores cujas consultas já chegaram (terminam em ordem)
+    for (int k = 1; k < FRAMES_IN_FLIGHT; k++) {
+        Frame &antigo = frames[(current + k) % FRAMES_IN_FLIGHT];
+        if (antigo.pending && !tryResolve(antigo)) break;
+    }
+}
+
+bool Profiler::tryResolve(Frame &f) {
+    if (f.usedQueries > 0) {
+        GLuint pronta = 0;
+        glGetQueryObjectuiv(f.queries[f.usedQueries - 1], GL_QUERY_RESULT_AVAILABLE, &pronta);
+        if (!pronta) return false;
+    }
+    resolve(f, true);
+    f.pending = false;
+    return true;
+}
+
+void Profiler::resolve(Frame &f, bool withGpu) {
+    for (size_t i = 0; i < f.zones.size(); i++) {
+        const Zone &z = f.zones[i];
+        double gpuBegin = 0.0, gpuEnd = 0.0;
+        bool temGpu = withGpu && z.gpuQuery >= 0;
+        if (temGpu) {
+            GLuint64 a = 0, b = 0;
+            glGetQueryObjectui64v(f.queries[z.gpuQuery], GL_QUERY_RESULT, &a);
+            glGetQueryObjectui64v(f.queries[z.gpuQuery + 1], GL_QUERY_RESULT, &b);
+            gpuBegin = a * 1e-9 + gpuOffset;
+            gpuEnd = b * 1e-9 + gpuOffset;
+        }
+        addStats(z, gpuBegin, gpuEnd, temGpu);
+        if (trace.size() + 2 > MAX_TRACE_EVENTS) continue;
+        TraceEvent e = { z.name, z.cpuBegin, z.cpuEnd - z.cpuBegin, false };
+        trace.push_back(e);
+        if (temGpu) {
+            TraceEvent g = { z.name, gpuBegin, gpuEnd - gpuBegin, true };
+            trace.push_back(g);
+        }
+    }
+}
+
+void Profiler::addStats(const Zone &z, double gpuBegin, double gpuEnd, bool withGpu) {
+    double cpuMs = (z.cpuEnd - z.cpuBegin) * 1000.0;
+    double gpuMs = (gpuEnd - gpuBegin) * 1000.0;
+    for (size_t i = 0; i < stats.size(); i++) {
+        ZoneStats &s = stats[i];
+        if (s.depth != z.depth || strcmp(s.name, z.name) != 0) continue;
+        s.cpuMs += (cpuMs - s.cpuMs) * PESO_MEDIA;
+        if (withGpu) s.gpuMs = s.hasGpu ? s.gpuMs + (gpuMs - s.gpuMs) * PESO_MEDIA : gpuMs;
+        s.hasGpu = s.hasGpu || withGpu;
+        return;
+    }
+    ZoneStats s = { z.name, z.depth, cpuMs, withGpu ? gpuMs : 0.0, withGpu };
+    stats.push_back(s);
+}
+
+static const char *OVERLAY_VS =
+    "#version 330 core\n"
+    "layout(location = 0) in vec2 pos;\n"
+    "uniform vec2 screen;\n"
+    "void main() { gl_Position = vec4(pos.x / screen.x * 2.0 - 1.0, 1.0 - pos.y / screen.y * 2.0, 0.0, 1.0); }\n";
+
+static const char *OVERLAY_FS =
+    "#version 330 core\n"
+    "uniform vec4 color;\n"
+    "out vec4 fragColor;\n"
+    "void main() { fragColor = color; }\n";
+
+// Quads do stb_easy_font (4 vértices de 16 bytes) viram triângulos, que
+// funcionam também no perfil core
+static void quadsParaTriangulos(const char *texto, float x, float y, float escala, std::vector<float> &saida) {
+    static char buffer[60000];
+    int quads = stb_easy_font_print(0, 0, (char *)texto, NULL, buffer, sizeof(buffer));
+    const int ordem[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int q = 0; q < quads; q++) {
+        const float *v = (const float *)(buffer + q * 64);
+        for (int k = 0; k < 6; k++) {
+            saida.push_back(x + v[ordem[k] * 4 + 0] * escala);
+            saida.push_back(y + v[ordem[k] * 4 + 1] * escala);
+        }
+    }
+}
+
+void Profiler::drawOverlay(int width, int height) {
+    if (!enabled || !overlayVisible || stats.empty()) return;
+
+    if (!overlayProgram) {
+        GLuint vs = glCreateShader(GL_VERTEX_SHADER);
+        GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(vs, 1, &OVERLAY_VS, NULL);
+        glCompileShader(vs);
+        glShaderSource(fs, 1, &OVERLAY_FS, NULL);
+        glCompileShader(fs);
+        overlayProgram = glCreateProgram();
+        glAttachShader(overlayProgram, vs);
+        glAttachShader(overlayProgram, fs);
+        glLinkProgram(overlayProgram);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        overlayColorLoc = glGetUniformLocation(overlayProgram, "color");
+        overlayScreenLoc = glGetUniformLocation(overlayProgram, "screen");
+        glGenVertexArrays(1, &overlayVao);
+        glGenBuffers(1, &overlayVbo);
+    }
+
+    // Texto da tabela
+    std::vector<std::string> linhas;
+    char buf[160];
+    snprintf(buf, sizeof(buf), "%-22s %8s %8s", "zona", "CPU ms", gpuTimers ? "GPU ms" : "");
+    linhas.push_back(buf);
+    for (size_t i = 0; i < stats.size(); i++) {
+        const ZoneStats &s = stats[i];
+        char nome[64];
+        snprintf(nome, sizeof(nome), "%*s%s", s.depth * 2, "", s.name);
+        if (s.hasGpu) snprintf(buf, sizeof(buf), "%-22s %8.3f %8.3f", nome, s.cpuMs, s.gpuMs);
+        else snprintf(buf, sizeof(buf), "%-22s %8.3f %8s", nome, s.cpuMs, "-");
+        linhas.push_back(buf);
+    }
+    if (droppedGpuFrames > 0) {
+        snprintf(buf, sizeof(buf), "GPU descartada em %lld quadros", droppedGpuFrames);
+        linhas.push_back(buf);
+    }
+    // Chamadas OpenGL do último quadro, se a instrumentação estiver ligada
+    if (g_glInstrumentation.isInstalled()) {
+        const GLCounters &c = g_glInstrumentation.lastFrame();
+        snprintf(buf, sizeof(buf), "desenhos %lld  vertices %lld  programas %lld", c.drawCalls, c.vertices, c.programSwitches);
+        linhas.push_back(buf);
+        snprintf(buf, sizeof(buf), "texturas %lld  VAOs %lld  redundantes %lld", c.textureBinds, c.vaoBinds, c.redundantStateSets);
+        linhas.push_back(buf);
+        snprintf(buf, sizeof(buf), "uniformes %lld  locais %lld  buffers %lld (%lld bytes)", c.uniformUploads,
+                 c.uniformLocationQueries, c.bufferUploads, c.bufferBytes);
+        linhas.push_back(buf);
+    }
+    const float escala = 1.5f, linha = 12.0f * escala, x0 = 10.0f, y0 = 70.0f;
+    std::vector<float> texto;
+    for (size_t i = 0; i < linhas.size(); i++)
+        quadsParaTriangulos(linhas[i].c_str(), x0, y0 + linha * i, escala, texto);
+    float fundoAltura = linha * linhas.size() + 8.0f;
+    int maiorLinha = 0;
+    for (size_t i = 0; i < linhas.size(); i++)
+        maiorLinha = std::max(maiorLinha, stb_easy_font_width((char *)linhas[i].c_str()));
+    float fundoLargura = maiorLinha * escala + 8.0f;
+    float fundo[12] = {
+        x0 - 4, y0 - 4, x0 - 4 + fundoLargura, y0 - 4, x0 - 4 + fundoLargura, y0 - 4 + fundoAltura,
+        x0 - 4, y0 - 4, x0 - 4 + fundoLargura, y0 - 4 + fundoAltura, x0 - 4, y0 - 4 + fundoAltura
+    };
+
+    // O estado passa pelo cache: quem desenha depois pede o seu de novo
+    // pelo g_glState e só paga a chamada do que a sobreposição mudou
+    g_glState.setEnabled(GL_DEPTH_TEST, false);
+    g_glState.setEnabled(GL_BLEND, true);
+    g_glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    g_glState.useProgram(overlayProgram);
+    glUniform2f(overlayScreenLoc, (float)width, (float)height);
+    g_glState.bindVertexArray(overlayVao);
+    // Com o buffer de streaming do programa, os vértices vão para o pedaço do quadro
+    GLsizeiptr bytes = sizeof(fundo) + texto.size() * sizeof(float);
+    GLintptr deslocamento = 0;
+    char *destino = NULL;
+    if (g_streamBuffer.isCreated())
+        destino = (char *)g_streamBuffer.allocate(bytes, 2 * sizeof(float), deslocamento);
+    if (destino) {
+        memcpy(destino, fundo, sizeof(fundo));
+        memcpy(destino + sizeof(fundo), texto.data(), texto.size() * sizeof(float));
+        g_streamBuffer.commit(deslocamento, bytes);
+        g_glState.bindBuffer(GL_ARRAY_BUFFER, g_streamBuffer.getBuffer());
+    } else {
+        g_glState.bindBuffer(GL_ARRAY_BUFFER, overlayVbo);
+        glBufferData(GL_ARRAY_BUFFER, bytes, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(fundo), fundo);
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(fundo), texto.size() * sizeof(float), texto.data());
+    }
+    GLint primeiro = (GLint)(deslocamento / (2 * sizeof(float)));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
+    glUniform4f(overlayColorLoc, 0.0f, 0.0f, 0.0f, 0.6f);
+    glDrawArrays(GL_TRIANGLES, primeiro, 6);
+    glUniform4f(overlayColorLoc, 0.9f, 0.9f, 0.3f, 1.0f);
+    glDrawArrays(GL_TRIANGLES, primeiro + 6, (GLsizei)(texto.size() / 2));
+}
+
+// Nome de zona como string JSON: aspas, barra invertida e caracteres de
+// controle escapados, para o chrome://tracing aceitar qualquer nome
+static void escreveNomeJson(FILE *f, const char *nome) {
+    fputc('"', f);
+    for (const unsigned char *c = (const unsigned char *)nome; *c; c++) {
+        if (*c == '"' || *c == '\\') fprintf(f, "\\%c", *c);
+        else if (*c < 0x20) fprintf(f, "\\u%04x", *c);
+        else fputc(*c, f);
+    }
+    fputc('"', f);
+}
+
+bool Profiler::writeChromeTrace(const std::string &path) const {
+    FILE *f = fopen(path.c_str(), "w");
+    if (!f) return false;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+    fprintf(f, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+    for (size_t i = 0; i < trace.size(); i++) {
+        const TraceEvent &e = trace[i];
+        fprintf(f, ",\n{\"name\":");
+        escreveNomeJson(f, e.name);
+        fprintf(f, ",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}", e.gpu ? "gpu" : "cpu",
+                e.begin * 1e6, e.duration * 1e6, e.gpu ? 2 : 1);
+    }
+    fprintf(f, "\n]}\n");
+    return fclose(f) == 0;
+}
+
+void Profiler::shutdown() {
+    for (int i = 0; i < FRAMES_IN_FLIGHT; i++) {
+        if (!frames[i].queries.empty())
+            glDeleteQueries((GLsizei)frames[i].queries.size(), frames[i].queries.data());
+        frames[i].queries.clear();
+        frames[i].pending = false;
+    }
+    if (overlayProgram) {
+        g_glState.forgetProgram(overlayProgram);
+        glDeleteProgram(overlayProgram);
+        glDeleteVertexArrays(1, &overlayVao);
+        glDeleteBuffers(1, &overlayVbo);
+        overlayProgram = overlayVao = overlayVbo = 0;
+    }
+    enabled = false;
+}
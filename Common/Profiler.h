@@ -0,0 +1,142 @@
+//
+//  Profiler.h
+//  Perfil de quadro: zonas de CPU aninhadas, cada uma com marcas de tempo da
+//  GPU, sobreposição na tela e exportação para chrome://tracing.
+//
+//  As zonas da GPU usam glQueryCounter(GL_TIMESTAMP) no início e no fim da
+//  zona, porque consultas GL_TIME_ELAPSED não podem ficar aninhadas. Cada
+//  quadro tem o próprio conjunto de consultas, e o resultado só é lido
+//  FRAMES_IN_FLIGHT quadros depois, quando já está disponível: o perfil
+//  nunca faz a CPU esperar a GPU. Se as consultas de um quadro ainda não
+//  chegaram quando o conjunto é reaproveitado, a parte de GPU daquele
+//  quadro é descartada.
+//
+//  Uso (contexto OpenGL corrente):
+//      g_profiler.setEnabled(true);
+//      g_profiler.beginFrame();
+//      { PROFILE_ZONE("Mapa"); desenharMapa(); }
+//      ...
+//      glfwSwapBuffers(window);
+//      g_profiler.endFrame();
+//      g_profiler.writeChromeTrace("perfil.json");
+//
+
+#ifndef Profiler_h
+#define Profiler_h
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+    static const int FRAMES_IN_FLIGHT = 4;
+    static const size_t MAX_TRACE_EVENTS = 1 << 20;   // o resto da sessão fica fora do trace
+
+    Profiler();
+
+    // Liga ou desliga. As consultas de GPU só são usadas se o contexto tiver
+    // GL_TIMESTAMP (OpenGL 3.3 ou ARB_timer_query)
+    void setEnabled(bool on);
+    bool isEnabled() const {
+        return enabled;
+    }
+    bool hasGpuTimers() const {
+        return gpuTimers;
+    }
+
+    // O quadro é a zona de fora; endFrame vai depois do swap. Um beginFrame
+    // sem endFrame anterior descarta o quadro aberto (quadro não desenhado)
+    void beginFrame();
+    void endFrame();
+
+    int beginZone(const char *name);   // o nome precisa viver até a exportação
+    void endZone(int zone);
+
+    void setOverlayVisible(bool visible) {
+        overlayVisible = visible;
+    }
+    bool isOverlayVisible() const {
+        return overlayVisible;
+    }
+
+    // Tabela com a média móvel de cada zona, no canto da tela. Troca o
+    // estado pelo g_glState (GLStateCache.h) e não o restaura
+    void drawOverlay(int width, int height);
+
+    // JSON no formato de eventos do chrome://tracing (e do Perfetto)
+    bool writeChromeTrace(const std::string &path) const;
+
+    // Libera consultas e objetos da sobreposição; chamar com o contexto vivo
+    void shutdown();
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Zone {
+        const char *name;
+        int depth;
+        double cpuBegin, cpuEnd;   // segundos desde o início do perfil
+        int gpuQuery;              // índice da consulta de início; fim = +1 (-1 sem GPU)
+    };
+
+    struct Frame {
+        std::vector<Zone> zones;
+        std::vector<GLuint> queries;
+        int usedQueries;
+        bool pending;              // esperando as consultas da GPU
+    };
+
+    struct ZoneStats {
+        const char *name;
+        int depth;
+        double cpuMs, gpuMs;
+        bool hasGpu;
+    };
+
+    struct TraceEvent {
+        const char *name;
+        double begin, duration;   // segundos
+        bool gpu;
+    };
+
+    bool enabled;
+    bool gpuTimers;
+    bool overlayVisible;
+    bool frameOpen;
+    int current;
+    int depth;
+    long long droppedGpuFrames;
+    Frame frames[FRAMES_IN_FLIGHT];
+    Clock::time_point start;
+    double gpuOffset;              // segundos de CPU = ns da GPU * 1e-9 + gpuOffset
+    std::vector<ZoneStats> stats;
+    std::vector<TraceEvent> trace;
+
+    GLuint overlayProgram, overlayVao, overlayVbo;
+    GLint overlayColorLoc, overlayScreenLoc;
+
+    double now() const;
+    void resolve(Frame &f, bool withGpu);
+    bool tryResolve(Frame &f);
+    void addStats(const Zone &z, double gpuBegin, double gpuEnd, bool withGpu);
+};
+
+extern Profiler g_profiler;
+
+// Zona com escopo: PROFILE_ZONE("Mapa"); mede até o fim do bloco
+struct ProfileZone {
+    int id;
+    explicit ProfileZone(const char *name) : id(g_profiler.beginZone(name)) {}
+    ~ProfileZone() {
+        g_profiler.endZone(id);
+    }
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(zonaPerfil_, __LINE__)(name)
+
+#endif /* Profiler_h */
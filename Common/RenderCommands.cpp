@@ -0,0 +1,111 @@
+//
+//  RenderCommands.cpp
+//  Gravação, ordenação e envio das listas de comandos.
+//
+
+#include "RenderCommands.h"
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
+
+#include <algorithm>
+#include <string.h>
+
+void RenderCommand::setModel(GLint location, const float *matrix) {
+    modelLocation = location;
+    memcpy(model, matrix, sizeof(model));
+}
+
+void RenderCommand::setParam(GLint location, int size, float x, float y, float z, float w) {
+    paramLocation = location;
+    paramSize = size;
+    param[0] = x;
+    param[1] = y;
+    param[2] = z;
+    param[3] = w;
+}
+
+void RenderCommandList::clear() {
+    commands.clear();
+    vertexData.clear();
+}
+
+RenderCommand &RenderCommandList::draw(uint64_t key, GLuint program, GLuint vao, GLuint texture, GLenum mode,
+                                       GLint first, GLsizei count) {
+    commands.push_back(RenderCommand());
+    RenderCommand &c = commands.back();
+    c.key = key;
+    c.program = program;
+    c.vao = vao;
+    c.texture = texture;
+    c.mode = mode;
+    c.first = first;
+    c.count = count;
+    c.modelLocation = -1;
+    c.paramLocation = -1;
+    c.paramSize = 0;
+    c.stride = 0;
+    return c;
+}
+
+void *RenderCommandList::vertices(GLsizei count, int stride, GLint &first) {
+    size_t inicio = (vertexData.size() + stride - 1) / stride * stride;
+    vertexData.resize(inicio + (size_t)count * stride);
+    first = (GLint)(inicio / stride);
+    return &vertexData[inicio];
+}
+
+void RenderQueue::add(RenderCommandList &list) {
+    lists.push_back(&list);
+}
+
+void RenderQueue::submit() {
+    entries.clear();
+    for (size_t l = 0; l < lists.size(); l++) {
+        RenderCommandList &lista = *lists[l];
+        // Os vértices da lista inteira vão num pedaço só; 64 é múltiplo de todo stride
+        GLintptr deslocamento = 0;
+        bool temVertices = false;
+        if (!lista.vertexData.empty()) {
+            GLsizeiptr bytes = (GLsizeiptr)lista.vertexData.size();
+            void *destino = g_streamBuffer.allocate(bytes, 64, deslocamento);
+            if (destino) {
+                memcpy(destino, lista.vertexData.data(), bytes);
+                g_streamBuffer.commit(deslocamento, bytes);
+                temVertices = true;
+            }
+        }
+        for (size_t i = 0; i < lista.commands.size(); i++) {
+            const RenderCommand &c = lista.commands[i];
+            Entry e;
+            e.key = c.key;
+            e.command = &c;
+            e.base = 0;
+            if (c.stride > 0) {
+                if (!temVertices) continue; // StreamBuffer cheio: o desenho fica de fora
+                e.base = (GLint)(deslocamento / c.stride);
+            }
+            entries.push_back(e);
+        }
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const RenderCommand &c = *entries[i].command;
+        g_glState.useProgram(c.program);
+        g_glState.bindVertexArray(c.vao);
+        if (c.texture) g_glState.bindTexture(GL_TEXTURE_2D, c.texture);
+        if (c.modelLocation >= 0) glUniformMatrix4fv(c.modelLocation, 1, GL_FALSE, c.model);
+        if (c.paramLocation >= 0) {
+            switch (c.paramSize) {
+            case 1: glUniform1f(c.paramLocation, c.param[0]); break;
+            case 2: glUniform2f(c.paramLocation, c.param[0], c.param[1]); break;
+            case 3: glUniform3f(c.paramLocation, c.param[0], c.param[1], c.param[2]); break;
+            default: glUniform4f(c.paramLocation, c.param[0], c.param[1], c.param[2], c.param[3]); break;
+            }
+        }
+        glDrawArrays(c.mode, entries[i].base + c.first, c.count);
+    }
+    submitted = entries.size();
+    lists.clear();
+}
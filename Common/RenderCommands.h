@@ -0,0 +1,107 @@
+//
+//  RenderCommands.h
+//  Listas de comandos de desenho gravadas fora da thread do OpenGL.
+//
+//  Gravar um quadro (montar matrizes, escolher frames de animação, gerar os
+//  quads dos textos) não chama o GL: cada RenderCommandList guarda desenhos
+//  já resolvidos, com programa, VAO, textura, uniformes e, se for o caso,
+//  vértices gerados na CPU. Várias listas podem ser gravadas ao mesmo tempo,
+//  uma por tarefa do JobSystem. Na thread do contexto, RenderQueue
+//  junta as listas, ordena pela chave e envia tudo ao GL pelo GLStateCache;
+//  os vértices das listas vão num pedaço só do StreamBuffer.
+//
+//  A chave de ordenação começa pela camada e pela ordem de pintura dentro
+//  dela (o que está por cima precisa vir depois quando há transparência);
+//  com a mesma ordem, os desenhos se agrupam por programa e textura. Empates
+//  mantêm a ordem de gravação.
+//
+//  Locais de uniforme são consultados antes, na thread do GL: as listas só
+//  guardam o número.
+//
+//  Uso:
+//      jobs.parallelFor(n, 1, [&](int i, int) { listas[i].clear(); grava(listas[i], i); });
+//      for (...) fila.add(listas[i]);
+//      fila.submit();
+//
+
+#ifndef RenderCommands_h
+#define RenderCommands_h
+
+#include <glad/glad.h>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct RenderCommand {
+    uint64_t key;
+    GLuint program, vao, texture;    // GL_TEXTURE_2D na unidade ativa; 0 não troca
+    GLenum mode;
+    GLint first;                     // vértice inicial no VAO, ou no bloco da lista se stride > 0
+    GLsizei count;
+    GLint modelLocation;             // -1: sem matriz
+    GLint paramLocation;             // -1: sem parâmetro
+    int paramSize;                   // floats em param (1 a 4)
+    int stride;                      // > 0: vértices vêm do bloco da lista
+    float model[16];
+    float param[4];
+
+    void setModel(GLint location, const float *matrix);
+    void setParam(GLint location, int size, float x, float y = 0.0f, float z = 0.0f, float w = 0.0f);
+
+    // camada (8 bits) | ordem de pintura (24) | programa (12) | textura (20)
+    static uint64_t makeKey(unsigned layer, unsigned order, GLuint program, GLuint texture) {
+        return ((uint64_t)(layer & 0xFF) << 56) | ((uint64_t)(order & 0xFFFFFF) << 32) |
+               ((uint64_t)(program & 0xFFF) << 20) | (uint64_t)(texture & 0xFFFFF);
+    }
+};
+
+class RenderCommandList {
+public:
+    void clear();
+
+    // Novo desenho; a referência vale até o próximo draw()
+    RenderCommand &draw(uint64_t key, GLuint program, GLuint vao, GLuint texture, GLenum mode, GLint first,
+                        GLsizei count);
+
+    // Espaço para count vértices de stride bytes (stride divide 64). Devolve
+    // onde escrever e, em first, o índice a passar ao draw(); o comando leva
+    // o mesmo stride (cmd.stride) e um VAO que lê do StreamBuffer a partir de 0.
+    void *vertices(GLsizei count, int stride, GLint &first);
+
+    size_t size() const {
+        return commands.size();
+    }
+
+private:
+    friend class RenderQueue;
+    std::vector<RenderCommand> commands;
+    std::vector<char> vertexData;
+};
+
+class RenderQueue {
+public:
+    RenderQueue() : submitted(0) {}
+
+    void add(RenderCommandList &list);
+
+    // Ordena e envia ao GL as listas adicionadas; depois a fila fica vazia
+    void submit();
+
+    // Comandos enviados no último submit()
+    size_t getSubmitted() const {
+        return submitted;
+    }
+
+private:
+    struct Entry {
+        uint64_t key;
+        const RenderCommand *command;
+        GLint base;                  // vértice do bloco da lista no StreamBuffer
+    };
+    std::vector<RenderCommandList *> lists;
+    std::vector<Entry> entries;
+    size_t submitted;
+};
+
+#endif /* RenderCommands_h */
@@ -0,0 +1,147 @@
+//
+//  SpritePhysics.cpp
+//  Integração do pulo em lote, com SSE/AVX e um laço escalar para o resto.
+//
+
+#include "SpritePhysics.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+int SpritePhysics::add(float groundY, float g) {
+    y.push_back(groundY);
+    vy.push_back(0.0f);
+    ground.push_back(groundY);
+    gravity.push_back(g);
+    airborne.push_back(0);
+    return (int)y.size() - 1;
+}
+
+void SpritePhysics::clear() {
+    y.clear();
+    vy.clear();
+    ground.clear();
+    gravity.clear();
+    airborne.clear();
+}
+
+void SpritePhysics::place(int body, float groundY) {
+    y[body] = groundY;
+    ground[body] = groundY;
+    vy[body] = 0.0f;
+    airborne[body] = 0;
+}
+
+void SpritePhysics::jump(int body, float velocity) {
+    if (airborne[body]) return;
+    airborne[body] = ~0u;
+    vy[body] = velocity;
+}
+
+void SpritePhysics::jumpGrounded(float velocity) {
+    int n = size();
+    float *pv = vy.data();
+    uint32_t *pa = airborne.data();
+    int i = 0;
+
+    // Quem está no ar mantém a velocidade; os outros recebem a do pulo
+#if defined(__AVX__)
+    __m256 v8 = _mm256_set1_ps(velocity);
+    __m256 todos = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (; i + 8 <= n; i += 8) {
+        __m256 ar = _mm256_loadu_ps((const float *)(pa + i));
+        __m256 v = _mm256_or_ps(_mm256_and_ps(ar, _mm256_loadu_ps(pv + i)), _mm256_andnot_ps(ar, v8));
+        _mm256_storeu_ps(pv + i, v);
+        _mm256_storeu_ps((float *)(pa + i), todos);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 v4 = _mm_set1_ps(velocity);
+    __m128 todos = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (; i + 4 <= n; i += 4) {
+        __m128 ar = _mm_loadu_ps((const float *)(pa + i));
+        __m128 v = _mm_or_ps(_mm_and_ps(ar, _mm_loadu_ps(pv + i)), _mm_andnot_ps(ar, v4));
+        _mm_storeu_ps(pv + i, v);
+        _mm_storeu_ps((float *)(pa + i), todos);
+    }
+#endif
+
+    for (; i < n; i++) {
+        if (airborne[i]) continue;
+        airborne[i] = ~0u;
+        vy[i] = velocity;
+    }
+}
+
+// Um corpo, exatamente como o Sprite::UpdatePhysics
+static inline void integraUm(float &y, float &vy, uint32_t &noAr, float chao, float g, float dt) {
+    if (!noAr) return;
+    y += vy * dt;
+    vy -= g * dt;
+    if (y <= chao) {
+        y = chao;
+        vy = 0.0f;
+        noAr = 0;
+    }
+}
+
+void SpritePhysics::updateScalar(float dt) {
+    int n = size();
+    for (int i = 0; i < n; i++)
+        integraUm(y[i], vy[i], airborne[i], ground[i], gravity[i], dt);
+}
+
+void SpritePhysics::update(float dt) {
+    int n = size();
+    float *py = y.data(), *pv = vy.data();
+    const float *pc = ground.data(), *pg = gravity.data();
+    uint32_t *pa = airborne.data();
+    int i = 0;
+
+    // Para cada corpo: no ar e acima do chão segue o pulo; no ar e no chão
+    // (ou abaixo) pousa; parado fica como está. A escolha é feita com
+    // and/andnot/or (o SSE2 não tem blendv, e no AVX ele não saiu mais rápido)
+#if defined(__AVX__)
+    __m256 dt8 = _mm256_set1_ps(dt);
+    for (; i + 8 <= n; i += 8) {
+        __m256 ar = _mm256_loadu_ps((const float *)(pa + i));
+        if (!_mm256_movemask_ps(ar)) continue;
+        __m256 y0 = _mm256_loadu_ps(py + i);
+        __m256 v = _mm256_loadu_ps(pv + i);
+        __m256 chao = _mm256_loadu_ps(pc + i);
+        __m256 ny = _mm256_add_ps(y0, _mm256_mul_ps(v, dt8));
+        __m256 nv = _mm256_sub_ps(v, _mm256_mul_ps(_mm256_loadu_ps(pg + i), dt8));
+        __m256 pousou = _mm256_and_ps(ar, _mm256_cmp_ps(ny, chao, _CMP_LE_OQ));
+        __m256 segue = _mm256_andnot_ps(pousou, ar);
+        ny = _mm256_or_ps(_mm256_or_ps(_mm256_and_ps(segue, ny), _mm256_and_ps(pousou, chao)),
+                          _mm256_andnot_ps(ar, y0));
+        nv = _mm256_or_ps(_mm256_and_ps(segue, nv), _mm256_andnot_ps(ar, v));
+        _mm256_storeu_ps(py + i, ny);
+        _mm256_storeu_ps(pv + i, nv);
+        _mm256_storeu_ps((float *)(pa + i), segue);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 dt4 = _mm_set1_ps(dt);
+    for (; i + 4 <= n; i += 4) {
+        __m128 ar = _mm_loadu_ps((const float *)(pa + i));
+        if (!_mm_movemask_ps(ar)) continue;
+        __m128 y0 = _mm_loadu_ps(py + i);
+        __m128 v = _mm_loadu_ps(pv + i);
+        __m128 chao = _mm_loadu_ps(pc + i);
+        __m128 ny = _mm_add_ps(y0, _mm_mul_ps(v, dt4));
+        __m128 nv = _mm_sub_ps(v, _mm_mul_ps(_mm_loadu_ps(pg + i), dt4));
+        __m128 pousou = _mm_and_ps(ar, _mm_cmple_ps(ny, chao));
+        __m128 segue = _mm_andnot_ps(pousou, ar);
+        ny = _mm_or_ps(_mm_or_ps(_mm_and_ps(segue, ny), _mm_and_ps(pousou, chao)), _mm_andnot_ps(ar, y0));
+        nv = _mm_or_ps(_mm_and_ps(segue, nv), _mm_andnot_ps(ar, v));
+        _mm_storeu_ps(py + i, ny);
+        _mm_storeu_ps(pv + i, nv);
+        _mm_storeu_ps((float *)(pa + i), segue);
+    }
+#endif
+
+    for (; i < n; i++)
+        integraUm(py[i], pv[i], pa[i], pc[i], pg[i], dt);
+}
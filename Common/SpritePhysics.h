@@ -0,0 +1,81 @@
+//
+//  SpritePhysics.h
+//  Pulo com gravidade de muitos sprites de uma vez.
+//
+//  Em vez de cada Sprite guardar velocidade, gravidade e chão entre os seus
+//  outros campos e se integrar sozinho, os corpos ficam em vetores
+//  separados (SoA): altura, velocidade vertical, chão, gravidade e a
+//  máscara "no ar". update() percorre os vetores 4 corpos por vez com SSE
+//  (8 com AVX), sem desvios: a integração vale só onde a máscara está
+//  ligada e o pouso (altura <= chão) é escolhido por máscara também.
+//  Blocos em que ninguém está no ar são pulados.
+//
+//  A conta é a mesma do Sprite::UpdatePhysics original, na mesma ordem,
+//  então o resultado é igual bit a bit ao de um corpo por vez
+//  (updateScalar, usada como referência).
+//
+//  Uso:
+//      SpritePhysics fisica;
+//      int corpo = fisica.add(50.0f, 800.0f);  // no chão em y = 50
+//      fisica.jump(corpo, 350.0f);
+//      ...
+//      fisica.update(dt);
+//      float y = fisica.getY(corpo);
+//
+
+#ifndef SpritePhysics_h
+#define SpritePhysics_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class SpritePhysics {
+public:
+    // Acrescenta um corpo parado no chão em y; devolve o seu índice
+    int add(float y, float gravity);
+    void clear();
+
+    int size() const {
+        return (int)y.size();
+    }
+
+    // Põe o corpo parado em y, que passa a ser o seu chão
+    void place(int body, float groundY);
+
+    // Move o corpo sem mudar o chão (no ar, o pulo continua dali)
+    void setY(int body, float value) {
+        y[body] = value;
+    }
+
+    // Começa um pulo com a velocidade dada, se o corpo estiver no chão
+    void jump(int body, float velocity);
+
+    // Todos os corpos que estão no chão começam um pulo
+    void jumpGrounded(float velocity);
+
+    // Avança dt segundos
+    void update(float dt);
+
+    // A mesma conta, um corpo por vez (referência para conferir o SIMD)
+    void updateScalar(float dt);
+
+    float getY(int body) const {
+        return y[body];
+    }
+
+    bool isJumping(int body) const {
+        return airborne[body] != 0;
+    }
+
+    // Alturas de todos os corpos, em sequência (para enviar a um buffer)
+    const float *getYs() const {
+        return y.data();
+    }
+
+private:
+    std::vector<float> y, vy, ground, gravity;
+    std::vector<uint32_t> airborne;     // ~0 no ar, 0 no chão: já é a máscara
+};
+
+#endif /* SpritePhysics_h */
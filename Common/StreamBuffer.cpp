@@ -0,0 +1,114 @@
+//
+//  StreamBuffer.cpp
+//  Regiões por quadro, cercas e o caminho sem glBufferStorage.
+//
+
+#include "StreamBuffer.h"
+#include "GLInstrumentation.h"
+#include "GLStateCache.h"
+
+StreamBuffer g_streamBuffer;
+
+StreamBuffer::StreamBuffer()
+    : buffer(0), mapped(NULL), regionSize(0), region(0), head(0), regionReady(false), totalBytes(0), waits(0),
+      overflows(0) {
+    for (int i = 0; i < FRAMES; i++) fences[i] = 0;
+}
+
+bool StreamBuffer::create(GLsizeiptr bytesPerFrame) {
+    destroy();
+    regionSize = bytesPerFrame;
+    GLsizeiptr total = regionSize * FRAMES;
+
+    // GL_COPY_WRITE_BUFFER não mexe no GL_ARRAY_BUFFER de quem desenha
+    glGenBuffers(1, &buffer);
+    g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, total, NULL, flags);
+        mapped = (char *)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags);
+    }
+    if (!mapped) {
+        // Sem armazenamento imutável: buffer comum, alocado uma vez só
+        if (GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage) {
+            // Apagar desliga o binding; o driver costuma devolver o mesmo
+            // nome no glGenBuffers e o cache pularia o bind de novo
+            g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        }
+        glBufferData(GL_COPY_WRITE_BUFFER, total, NULL, GL_STREAM_DRAW);
+        staging.resize((size_t)regionSize);
+    }
+    region = 0;
+    head = 0;
+    regionReady = true;
+    return buffer != 0;
+}
+
+void StreamBuffer::destroy() {
+    if (!buffer) return;
+    for (int i = 0; i < FRAMES; i++) {
+        if (fences[i]) glDeleteSync(fences[i]);
+        fences[i] = 0;
+    }
+    if (mapped) {
+        g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        mapped = NULL;
+    }
+    g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &buffer);
+    buffer = 0;
+    staging.clear();
+}
+
+void StreamBuffer::waitRegion() {
+    regionReady = true;
+    GLsync cerca = fences[region];
+    if (!cerca) return;
+    fences[region] = 0;
+    GLenum r = glClientWaitSync(cerca, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED) {
+        waits++;
+        do {
+            r = glClientWaitSync(cerca, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        } while (r == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(cerca);
+}
+
+void *StreamBuffer::allocate(GLsizeiptr bytes, GLsizeiptr alignment, GLintptr &offset) {
+    if (!buffer) return NULL;
+    if (!regionReady) waitRegion();
+    GLsizeiptr inicio = (head + alignment - 1) / alignment * alignment;
+    if (inicio + bytes > regionSize) {
+        overflows++;
+        return NULL;
+    }
+    head = inicio + bytes;
+    totalBytes += bytes;
+    offset = region * regionSize + inicio;
+    return mapped ? mapped + offset : &staging[(size_t)inicio];
+}
+
+void StreamBuffer::commit(GLintptr offset, GLsizeiptr bytes) {
+    if (bytes <= 0) return;
+    if (mapped) {
+        // Coerente: a GPU já vê a escrita. Não passa por glBufferSubData,
+        // então conta aqui o que os contadores de envio veriam
+        g_glInstrumentation.countBufferWrite(bytes);
+        return;
+    }
+    g_glState.bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, &staging[(size_t)(offset - region * regionSize)]);
+}
+
+void StreamBuffer::endFrame() {
+    if (!buffer || !regionReady) return; // quadro sem alocações: a região continua
+    if (head > 0 && glFenceSync) fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    region = (region + 1) % FRAMES;
+    head = 0;
+    regionReady = false;
+}
@@ -0,0 +1,95 @@
+//
+//  StreamBuffer.h
+//  Buffer de vértices dinâmicos dividido em três regiões, uma por quadro
+//  em voo. Cada quadro escreve só na sua região; endFrame() põe uma cerca
+//  (glFenceSync) nela e passa para a próxima. Antes de reescrever uma
+//  região, a primeira alocação espera a cerca de três quadros atrás, que
+//  normalmente já passou. Assim não há glBufferData a cada desenho, nem
+//  órfãos de buffer, nem sincronização implícita no driver.
+//
+//  Com glBufferStorage (GL 4.4 ou ARB_buffer_storage) o buffer fica mapeado
+//  para sempre (MAP_PERSISTENT | MAP_COHERENT) e allocate() devolve um
+//  ponteiro direto para ele. Sem isso, allocate() devolve uma cópia na CPU
+//  e commit() envia com glBufferSubData para a região que a GPU já largou.
+//
+//  Uso:
+//      g_streamBuffer.create(1 << 20);        // depois do gladLoadGLLoader
+//      GLintptr deslocamento;
+//      void *dst = g_streamBuffer.allocate(bytes, 16, deslocamento);
+//      memcpy(dst, vertices, bytes);
+//      g_streamBuffer.commit(deslocamento, bytes);
+//      glDrawArrays(..., deslocamento / 16, n); // VAO aponta para getBuffer()
+//      ...
+//      g_streamBuffer.endFrame();            // depois do último desenho
+//
+
+#ifndef StreamBuffer_h
+#define StreamBuffer_h
+
+#include <glad/glad.h>
+
+#include <stddef.h>
+#include <vector>
+
+class StreamBuffer {
+public:
+    static const int FRAMES = 3;
+
+    StreamBuffer();
+
+    // Cria o buffer com FRAMES regiões de bytesPorQuadro; contexto corrente
+    bool create(GLsizeiptr bytesPerFrame);
+    void destroy();
+
+    bool isCreated() const {
+        return buffer != 0;
+    }
+    bool isPersistent() const {
+        return mapped != NULL;
+    }
+    GLuint getBuffer() const {
+        return buffer;
+    }
+
+    // Reserva bytes na região do quadro. Devolve onde escrever e, em offset,
+    // a posição no buffer (múltipla de alignment). NULL se a região encheu.
+    void *allocate(GLsizeiptr bytes, GLsizeiptr alignment, GLintptr &offset);
+    // Fecha a escrita: sem mapeamento persistente, envia a cópia. Os dois
+    // caminhos entram em GLCounters::bufferBytes
+    void commit(GLintptr offset, GLsizeiptr bytes);
+
+    // Cerca a região do quadro e passa para a próxima
+    void endFrame();
+
+    // Bytes escritos desde create()
+    long long getTotalBytes() const {
+        return totalBytes;
+    }
+    // Vezes em que a GPU ainda usava a região e foi preciso esperar
+    long long getWaits() const {
+        return waits;
+    }
+    // Alocações recusadas por falta de espaço na região
+    long long getOverflows() const {
+        return overflows;
+    }
+
+private:
+    GLuint buffer;
+    char *mapped;                   // mapeamento persistente, ou NULL
+    std::vector<char> staging;      // cópia na CPU sem glBufferStorage
+    GLsizeiptr regionSize;
+    int region;
+    GLsizeiptr head;                // próximo byte livre na região
+    bool regionReady;               // cerca da região já conferida
+    GLsync fences[FRAMES];
+    long long totalBytes;
+    long long waits;
+    long long overflows;
+
+    void waitRegion();
+};
+
+extern StreamBuffer g_streamBuffer;
+
+#endif /* StreamBuffer_h */
@@ -0,0 +1,68 @@
+//
+//  TripleBuffer.h
+//  Troca de estado entre uma thread que produz e uma que consome, sem
+//  travas nem espera.
+//
+//  São três cópias de T: a de escrita (só o produtor toca), a de leitura
+//  (só o consumidor toca) e a do meio, que troca de dono com um exchange
+//  atômico. O produtor preenche a sua e publica, trocando-a pela do meio;
+//  o consumidor, quando há novidade, troca a sua pela do meio. Nenhum lado
+//  espera o outro: o produtor pode publicar mais rápido do que o consumidor
+//  lê (os retratos intermediários são descartados) e o consumidor continua
+//  lendo o último retrato completo enquanto não chega outro.
+//
+//  Uso:
+//      // produtor
+//      Estado &e = buffer.writeBuffer();
+//      preenche(e);
+//      buffer.publish();
+//
+//      // consumidor
+//      buffer.update();                // true se chegou retrato novo
+//      const Estado &e = buffer.readBuffer();
+//
+
+#ifndef TripleBuffer_h
+#define TripleBuffer_h
+
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    TripleBuffer(const TripleBuffer &) = delete;
+    TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+    // --- Produtor ---
+    T &writeBuffer() {
+        return slots[back];
+    }
+    // Entrega o que foi escrito; a nova cópia de escrita tem um retrato antigo
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // --- Consumidor ---
+    // Pega o retrato mais recente, se houver um que ainda não foi lido
+    bool update() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T &readBuffer() const {
+        return slots[front];
+    }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;     // a cópia do meio ainda não foi lida
+
+    T slots[3];
+    int back;
+    std::atomic<int> middle;
+    int front;
+};
+
+#endif /* TripleBuffer_h */
@@ -0,0 +1,243 @@
+//
+//  WalkGrid.cpp
+//  Consultas em lote sobre a grade de bits: vizinhança, linha de visão e
+//  preenchimento de região. Todas trabalham 64 células por vez (ou 128/256
+//  com SSE2/AVX2) aproveitando as palavras-guarda zeradas das bordas.
+//
+
+#include "WalkGrid.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+void WalkGrid::fill(bool walkable) {
+    for (int y = 0; y < height; y++) {
+        uint64_t *r = rowPtr(y);
+        for (int i = 0; i < stride; i++)
+            r[i] = walkable ? validMask(i) : 0;
+    }
+}
+
+size_t WalkGrid::countWalkable() const {
+    size_t total = 0;
+    for (int y = 0; y < height; y++) {
+        const uint64_t *r = row(y);
+        for (int i = 0; i < stride; i++)
+            total += walkgrid_popcount(r[i]);
+    }
+    return total;
+}
+
+// Bits x-1, x e x+1 da linha nos bits 0, 1 e 2 (as guardas cobrem x = 0 e a última coluna)
+static inline unsigned janela3(const uint64_t *r, int x) {
+    int xm = x - 1;
+    int i = xm >> 6;           // -1 para x = 0: cai na palavra-guarda
+    int b = xm & 63;
+    uint64_t v = r[i] >> b;
+    if (b > 61) v |= r[i + 1] << (64 - b);
+    return (unsigned)(v & 7);
+}
+
+bool WalkGrid::allNeighboursWalkable(int x, int y) const {
+    if (!inside(x, y)) return false;
+    return janela3(row(y - 1), x) == 7 &&
+           janela3(row(y + 1), x) == 7 &&
+           (janela3(row(y), x) & 5) == 5;
+}
+
+// Uma célula tem os 8 vizinhos livres quando, nas linhas de cima e de baixo,
+// ela e os dois lados estão livres, e na própria linha os dois lados estão.
+// "Lado esquerdo" de cada bit é a palavra deslocada para cima, trazendo o bit
+// 63 da palavra anterior; o direito é o inverso com a palavra seguinte.
+void WalkGrid::neighbourMaskRow(int y, uint64_t *out) const {
+    if (y < 0 || y >= height) {
+        for (int i = 0; i < stride; i++) out[i] = 0;
+        return;
+    }
+    const uint64_t *cima = row(y - 1);
+    const uint64_t *meio = row(y);
+    const uint64_t *baixo = row(y + 1);
+    int i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 4 <= stride; i += 4) {
+        __m256i m = _mm256_set1_epi64x(-1);
+        const uint64_t *linhas[3] = { cima, meio, baixo };
+        for (int k = 0; k < 3; k++) {
+            const uint64_t *r = linhas[k];
+            __m256i w = _mm256_loadu_si256((const __m256i *)(r + i));
+            __m256i p = _mm256_loadu_si256((const __m256i *)(r + i - 1));
+            __m256i n = _mm256_loadu_si256((const __m256i *)(r + i + 1));
+            __m256i esq = _mm256_or_si256(_mm256_slli_epi64(w, 1), _mm256_srli_epi64(p, 63));
+            __m256i dir = _mm256_or_si256(_mm256_srli_epi64(w, 1), _mm256_slli_epi64(n, 63));
+            __m256i lados = _mm256_and_si256(esq, dir);
+            m = _mm256_and_si256(m, k == 1 ? lados : _mm256_and_si256(lados, w));
+        }
+        _mm256_storeu_si256((__m256i *)(out + i), m);
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    for (; i + 2 <= stride; i += 2) {
+        __m128i m = _mm_set1_epi32(-1);
+        const uint64_t *linhas[3] = { cima, meio, baixo };
+        for (int k = 0; k < 3; k++) {
+            const uint64_t *r = linhas[k];
+            __m128i w = _mm_loadu_si128((const __m128i *)(r + i));
+            __m128i p = _mm_loadu_si128((const __m128i *)(r + i - 1));
+            __m128i n = _mm_loadu_si128((const __m128i *)(r + i + 1));
+            __m128i esq = _mm_or_si128(_mm_slli_epi64(w, 1), _mm_srli_epi64(p, 63));
+            __m128i dir = _mm_or_si128(_mm_srli_epi64(w, 1), _mm_slli_epi64(n, 63));
+            __m128i lados = _mm_and_si128(esq, dir);
+            m = _mm_and_si128(m, k == 1 ? lados : _mm_and_si128(lados, w));
+        }
+        _mm_storeu_si128((__m128i *)(out + i), m);
+    }
+#endif
+
+    for (; i < stride; i++) {
+        uint64_t m = ~0ull;
+        const uint64_t *linhas[3] = { cima, meio, baixo };
+        for (int k = 0; k < 3; k++) {
+            const uint64_t *r = linhas[k];
+            uint64_t esq = (r[i] << 1) | (r[i - 1] >> 63);
+            uint64_t dir = (r[i] >> 1) | (r[i + 1] << 63);
+            m &= (k == 1) ? (esq & dir) : (esq & dir & r[i]);
+        }
+        out[i] = m;
+    }
+}
+
+bool WalkGrid::rangeWalkable(int y, int x0, int x1) const {
+    if (x0 > x1) std::swap(x0, x1);
+    if (y < 0 || y >= height || x0 < 0 || x1 >= width) return false;
+    const uint64_t *r = row(y);
+    int w0 = x0 >> 6, w1 = x1 >> 6;
+    for (int i = w0; i <= w1; i++) {
+        uint64_t mask = ~0ull;
+        if (i == w0) mask &= ~0ull << (x0 & 63);
+        if (i == w1) mask &= ~0ull >> (63 - (x1 & 63));
+        if ((r[i] & mask) != mask) return false;
+    }
+    return true;
+}
+
+// Bresenham agrupando as células de cada linha num trecho contínuo, que é
+// conferido de uma vez por rangeWalkable. Os passos só em x até a próxima
+// troca de linha são dados de uma vez, então cada linha custa O(1) mais os
+// testes de palavra inteira.
+bool WalkGrid::lineOfSight(int x0, int y0, int x1, int y1) const {
+    if (!isWalkable(x0, y0) || !isWalkable(x1, y1)) return false;
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    int x = x0, y = y0;
+    int trechoY = y0, trechoIni = x0;
+    while (x != x1 || y != y1) {
+        int e2 = 2 * err;
+        if (e2 > dx) {
+            // enquanto 2*err > dx o Bresenham só anda em x
+            int n = abs(x1 - x);
+            if (dy != 0) n = std::min(n, (e2 - dx - 2 * dy - 1) / (-2 * dy));
+            x += sx * n;
+            err += n * dy;
+            continue;
+        }
+        int xAnt = x;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+        if (y != trechoY) {
+            if (!rangeWalkable(trechoY, trechoIni, xAnt)) return false;
+            trechoY = y;
+            trechoIni = x;
+        }
+    }
+    return rangeWalkable(trechoY, trechoIni, x);
+}
+
+void WalkGrid::setRange(int y, int x0, int x1) {
+    uint64_t *r = rowPtr(y);
+    int w0 = x0 >> 6, w1 = x1 >> 6;
+    for (int i = w0; i <= w1; i++) {
+        uint64_t mask = ~0ull;
+        if (i == w0) mask &= ~0ull << (x0 & 63);
+        if (i == w1) mask &= ~0ull >> (63 - (x1 & 63));
+        r[i] |= mask;
+    }
+}
+
+// Última célula livre (caminhável e ainda fora da região) a partir de x para a direita
+static int fimDoTrecho(const uint64_t *w, const uint64_t *reg, int x) {
+    int i = x >> 6;
+    uint64_t parada = ~(w[i] & ~reg[i]) & (~0ull << (x & 63));
+    while (!parada) {
+        i++;
+        parada = ~(w[i] & ~reg[i]);   // a guarda à direita é zero: sempre para
+    }
+    return i * 64 + walkgrid_ctz(parada) - 1;
+}
+
+// Primeira célula livre do trecho que contém x, andando para a esquerda
+static int inicioDoTrecho(const uint64_t *w, const uint64_t *reg, int x) {
+    int i = x >> 6;
+    uint64_t parada = ~(w[i] & ~reg[i]) & (~0ull >> (63 - (x & 63)));
+    while (!parada) {
+        i--;
+        parada = ~(w[i] & ~reg[i]);   // a guarda à esquerda (índice -1) também
+    }
+    return i * 64 + (63 - walkgrid_clz(parada)) + 1;
+}
+
+// Preenchimento por trechos (scanline): cada trecho horizontal é achado e
+// marcado com operações de palavra, e nas linhas vizinhas só o início de
+// cada trecho livre vira semente.
+size_t WalkGrid::floodFill(int x, int y, WalkGrid &region) const {
+    region.resize(width, height, false);
+    if (!isWalkable(x, y)) return 0;
+
+    size_t total = 0;
+    std::vector<GridPoint> pilha;
+    GridPoint semente = { x, y };
+    pilha.push_back(semente);
+
+    while (!pilha.empty()) {
+        GridPoint p = pilha.back();
+        pilha.pop_back();
+        const uint64_t *w = row(p.y);
+        const uint64_t *reg = region.row(p.y);
+        if (!((w[p.x >> 6] & ~reg[p.x >> 6]) >> (p.x & 63) & 1)) continue;
+
+        int x0 = inicioDoTrecho(w, reg, p.x);
+        int x1 = fimDoTrecho(w, reg, p.x);
+        region.setRange(p.y, x0, x1);
+        total += x1 - x0 + 1;
+
+        // Vizinhança de 8: nas linhas de cima e de baixo vale de x0-1 a x1+1
+        int a = std::max(0, x0 - 1), b = std::min(width - 1, x1 + 1);
+        for (int ny = p.y - 1; ny <= p.y + 1; ny += 2) {
+            if (ny < 0 || ny >= height) continue;
+            const uint64_t *nw = row(ny);
+            const uint64_t *nreg = region.row(ny);
+            int w0 = a >> 6, w1 = b >> 6;
+            uint64_t vemDeTras = 0;   // último bit livre da palavra anterior
+            for (int i = w0; i <= w1; i++) {
+                uint64_t mask = ~0ull;
+                if (i == w0) mask &= ~0ull << (a & 63);
+                if (i == w1) mask &= ~0ull >> (63 - (b & 63));
+                uint64_t livre = nw[i] & ~nreg[i] & mask;
+                uint64_t inicios = livre & ~((livre << 1) | vemDeTras);
+                vemDeTras = livre >> 63;
+                while (inicios) {
+                    GridPoint s = { i * 64 + walkgrid_ctz(inicios), ny };
+                    pilha.push_back(s);
+                    inicios &= inicios - 1;
+                }
+            }
+        }
+    }
+    return total;
+}
@@ -0,0 +1,149 @@
+//
+//  WalkGrid.h
+//  Grade de caminhabilidade compactada em bits.
+//
+//  Cada célula ocupa 1 bit (1 = caminhável, 0 = bloqueada), com 64 células
+//  por palavra e as linhas armazenadas em sequência (row-major). Consultas
+//  fora dos limites sempre retornam "bloqueado", então quem percorre a grade
+//  não precisa testar bordas.
+//
+//  Cada linha tem uma palavra-guarda zerada antes e depois, e existe uma
+//  linha-guarda zerada acima e abaixo da grade. Assim row(y)[-1],
+//  row(y)[getStride()], row(-1) e row(getHeight()) podem ser lidos sem teste,
+//  o que permite as consultas com SIMD e deslocamentos entre palavras.
+//
+
+#ifndef WalkGrid_h
+#define WalkGrid_h
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+struct GridPoint {
+    int x, y;
+};
+
+inline bool operator==(const GridPoint &a, const GridPoint &b) {
+    return a.x == b.x && a.y == b.y;
+}
+
+inline bool operator!=(const GridPoint &a, const GridPoint &b) {
+    return !(a == b);
+}
+
+class WalkGrid {
+    int width, height;     // dimensões em células
+    int stride;            // palavras de 64 bits úteis por linha
+    int pitch;             // palavras por linha contando as guardas
+    std::vector<uint64_t> bits;
+
+public:
+    WalkGrid() : width(0), height(0), stride(0), pitch(2) {
+        bits.assign(2 * pitch, 0);
+    }
+
+    WalkGrid(int w, int h, bool walkable) {
+        resize(w, h, walkable);
+    }
+
+    void resize(int w, int h, bool walkable) {
+        width = w;
+        height = h;
+        stride = (w + 63) / 64;
+        pitch = stride + 2;
+        bits.assign((size_t)pitch * (h + 2), 0);
+        if (walkable) fill(true);
+    }
+
+    // Marca todas as células como caminháveis ou bloqueadas
+    void fill(bool walkable);
+
+    int getWidth() const {
+        return width;
+    }
+
+    int getHeight() const {
+        return height;
+    }
+
+    int getStride() const {
+        return stride;
+    }
+
+    bool inside(int x, int y) const {
+        return (unsigned)x < (unsigned)width && (unsigned)y < (unsigned)height;
+    }
+
+    bool isWalkable(int x, int y) const {
+        if (!inside(x, y)) return false;
+        return (row(y)[x >> 6] >> (x & 63)) & 1ull;
+    }
+
+    void setWalkable(int x, int y, bool walkable) {
+        if (!inside(x, y)) return;
+        uint64_t &word = rowPtr(y)[x >> 6];
+        uint64_t mask = 1ull << (x & 63);
+        if (walkable) word |= mask;
+        else word &= ~mask;
+    }
+
+    // Linha y como sequência de getStride() palavras (y pode ir de -1 a getHeight())
+    const uint64_t* row(int y) const {
+        return &bits[(size_t)(y + 1) * pitch + 1];
+    }
+
+    // Bytes ocupados pelos dados da grade (incluindo as guardas)
+    size_t memoryBytes() const {
+        return bits.size() * sizeof(uint64_t);
+    }
+
+    // --- Consultas em lote (WalkGrid.cpp) ---
+
+    // Total de células caminháveis
+    size_t countWalkable() const;
+
+    // Os 8 vizinhos de (x, y) são caminháveis?
+    bool allNeighboursWalkable(int x, int y) const;
+
+    // Escreve em out[0..getStride()) a máscara das células da linha y cujos
+    // 8 vizinhos são caminháveis (SSE2/AVX2 quando disponível)
+    void neighbourMaskRow(int y, uint64_t *out) const;
+
+    // Todas as células de x0 a x1 (inclusive) da linha y são caminháveis?
+    bool rangeWalkable(int y, int x0, int x1) const;
+
+    // Linha de Bresenham de (x0, y0) a (x1, y1) só passa por células caminháveis?
+    bool lineOfSight(int x0, int y0, int x1, int y1) const;
+
+    // Preenche "region" (redimensionada para o tamanho desta grade) com as
+    // células alcançáveis a partir de (x, y) em 8 direções. Retorna quantas.
+    size_t floodFill(int x, int y, WalkGrid &region) const;
+
+private:
+    uint64_t* rowPtr(int y) {
+        return &bits[(size_t)(y + 1) * pitch + 1];
+    }
+
+    // Máscara dos bits válidos da palavra w da linha (zera o que passa da largura)
+    uint64_t validMask(int w) const {
+        int resto = width - w * 64;
+        return resto >= 64 ? ~0ull : ((1ull << resto) - 1);
+    }
+
+    void setRange(int y, int x0, int x1);
+};
+
+// Contagem de zeros à direita/esquerda de uma palavra não nula e de bits ligados
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline int walkgrid_ctz(uint64_t v) { unsigned long i; _BitScanForward64(&i, v); return (int)i; }
+inline int walkgrid_clz(uint64_t v) { unsigned long i; _BitScanReverse64(&i, v); return 63 - (int)i; }
+inline int walkgrid_popcount(uint64_t v) { return (int)__popcnt64(v); }
+#else
+inline int walkgrid_ctz(uint64_t v) { return __builtin_ctzll(v); }
+inline int walkgrid_clz(uint64_t v) { return __builtin_clzll(v); }
+inline int walkgrid_popcount(uint64_t v) { return __builtin_popcountll(v); }
+#endif
+
+#endif /* WalkGrid_h */
@@ -18,9 +18,19 @@
 #include <time.h>
 #include <string.h>
 #include <assert.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <vector>
 #define GL_LOG_FILE "gl.log"
 #define MAX_SHADER_LENGTH 262144
 
+/*------------------------------GLOBAL VARIABLES------------------------------*/
+int g_gl_width = 640;
+int g_gl_height = 480;
+GLFWwindow* g_window = NULL;
+
 /*--------------------------------LOG FUNCTIONS-------------------------------*/
 bool restart_gl_log () {
 	FILE* file = fopen (GL_LOG_FILE, "w");
@@ -143,7 +153,8 @@ void glfw_window_size_callback (GLFWwindow* window, int width, int height) {
 	/* update any perspective matrices used here */
 }
 
-void _update_fps_counter (GLFWwindow* window) {
+/* title prefixes the counter, so each program keeps its own window name */
+void _update_fps_counter (GLFWwindow* window, const char* title) {
 	static double previous_seconds = glfwGetTime ();
 	static int frame_count;
 	double current_seconds = glfwGetTime ();
@@ -151,14 +162,165 @@ void _update_fps_counter (GLFWwindow* window) {
 	if (elapsed_seconds > 0.25) {
 		previous_seconds = current_seconds;
 		double fps = (double)frame_count / elapsed_seconds;
-		char tmp[128];
-		 sprintf (tmp, "opengl @ fps: %.2f", fps);
-		 glfwSetWindowTitle (window, tmp);
-		 frame_count = 0;
+		char tmp[256];
+		if (frame_times_enabled ()) {
+			Frame_Time_Stats st = frame_times_stats ();
+			snprintf (
+				tmp, sizeof (tmp), "%s @ fps: %.2f p99: %.2f ms max: %.2f ms", title,
+				fps, st.p99_ms, st.max_ms
+			);
+		} else {
+			snprintf (tmp, sizeof (tmp), "%s @ fps: %.2f", title, fps);
+		}
+		glfwSetWindowTitle (window, tmp);
+		frame_count = 0;
 	}
 	frame_count++;
 }
 
+/*--------------------------------FRAME TIMES---------------------------------*/
+static std::atomic<float> g_frame_ring[FRAME_TIME_RING_SIZE];
+static std::atomic<long long> g_frame_count (0);
+static std::atomic<long long> g_frame_hitches (0);
+static std::atomic<bool> g_frame_times_on (false);
+static double g_frame_hitch_ms = FRAME_TIME_DEFAULT_HITCH_MS;
+static double g_frame_previous_s = -1.0;
+static std::string g_frame_csv_file;
+/* whole session for the CSV; only the render thread touches it */
+static std::vector<float> g_frame_log;
+
+bool frame_times_parse_args (int argc, char** argv) {
+	const char* csv_file_name = NULL;
+	double hitch_ms = FRAME_TIME_DEFAULT_HITCH_MS;
+	for (int i = 1; i + 1 < argc; i++) {
+		if (!strcmp (argv[i], "--tempos-quadro")) {
+			csv_file_name = argv[++i];
+		} else if (!strcmp (argv[i], "--travada-ms")) {
+			hitch_ms = atof (argv[++i]);
+		}
+	}
+	if (!csv_file_name) {
+		return false;
+	}
+	frame_times_enable (csv_file_name, hitch_ms);
+	return true;
+}
+
+static void frame_times_at_exit () { frame_times_write_csv (); }
+
+void frame_times_enable (const char* csv_file_name, double hitch_ms) {
+	g_frame_csv_file = csv_file_name ? csv_file_name : "";
+	g_frame_hitch_ms = hitch_ms > 0.0 ? hitch_ms : FRAME_TIME_DEFAULT_HITCH_MS;
+	g_frame_log.reserve (1 << 16);
+	g_frame_previous_s = -1.0;
+	if (!g_frame_times_on.exchange (true)) {
+		atexit (frame_times_at_exit);
+	}
+}
+
+bool frame_times_enabled () { return g_frame_times_on.load (); }
+
+void frame_times_mark () {
+	if (!g_frame_times_on.load (std::memory_order_relaxed)) {
+		return;
+	}
+	double now_s = glfwGetTime ();
+	double previous_s = g_frame_previous_s;
+	g_frame_previous_s = now_s;
+	if (previous_s < 0.0) {
+		return; // first frame only starts the clock
+	}
+	float ms = (float)((now_s - previous_s) * 1000.0);
+	g_frame_log.push_back (ms);
+	if (ms > g_frame_hitch_ms) {
+		g_frame_hitches.fetch_add (1, std::memory_order_relaxed);
+	}
+	// write the slot, then publish it
+	long long n = g_frame_count.load (std::memory_order_relaxed);
+	g_frame_ring[n & (FRAME_TIME_RING_SIZE - 1)].store (
+		ms, std::memory_order_relaxed
+	);
+	g_frame_count.store (n + 1, std::memory_order_release);
+}
+
+void frame_times_restart () {
+	if (g_frame_times_on.load (std::memory_order_relaxed)) {
+		g_frame_previous_s = glfwGetTime ();
+	}
+}
+
+static double percentile (std::vector<float>& v, double p) {
+	size_t k = (size_t)(p * (v.size () - 1) + 0.5);
+	std::nth_element (v.begin (), v.begin () + k, v.end ());
+	return v[k];
+}
+
+Frame_Time_Stats frame_times_stats () {
+	Frame_Time_Stats st;
+	memset (&st, 0, sizeof (st));
+	long long n = g_frame_count.load (std::memory_order_acquire);
+	st.frames = n;
+	st.hitches = g_frame_hitches.load (std::memory_order_relaxed);
+	int count = (int)std::min (n, (long long)FRAME_TIME_RING_SIZE);
+	if (count == 0) {
+		return st;
+	}
+	// a reader on another thread may see a few slots already overwritten by
+	// newer frames; for rolling stats that is harmless
+	std::vector<float> v (count);
+	for (int i = 0; i < count; i++) {
+		v[i] = g_frame_ring[(n - count + i) & (FRAME_TIME_RING_SIZE - 1)].load (
+			std::memory_order_relaxed
+		);
+	}
+	st.samples = count;
+	st.max_ms = *std::max_element (v.begin (), v.end ());
+	st.p99_ms = percentile (v, 0.99);
+	st.p95_ms = percentile (v, 0.95);
+	st.p50_ms = percentile (v, 0.50);
+	return st;
+}
+
+bool frame_times_write_csv () {
+	if (!g_frame_times_on.load () || g_frame_log.empty ()) {
+		return false;
+	}
+	// session summary: same percentiles as the rolling stats, over every frame
+	std::vector<float> v (g_frame_log);
+	double max_ms = *std::max_element (v.begin (), v.end ());
+	double p99 = percentile (v, 0.99), p95 = percentile (v, 0.95);
+	double p50 = percentile (v, 0.50);
+	printf (
+		"frame times: %lld frames p50 %.2f ms p95 %.2f ms p99 %.2f ms max %.2f ms, "
+		"%lld hitches > %.1f ms\n",
+		(long long)g_frame_log.size (), p50, p95, p99, max_ms,
+		g_frame_hitches.load (), g_frame_hitch_ms
+	);
+	if (g_frame_csv_file.empty ()) {
+		return true;
+	}
+	FILE* file = fopen (g_frame_csv_file.c_str (), "w");
+	if (!file) {
+		gl_log_err (
+			"ERROR: could not open frame time file %s for writing\n",
+			g_frame_csv_file.c_str ()
+		);
+		return false;
+	}
+	fprintf (file, "frame,ms,hitch\n");
+	for (size_t i = 0; i < g_frame_log.size (); i++) {
+		fprintf (
+			file, "%zu,%.3f,%d\n", i, g_frame_log[i],
+			g_frame_log[i] > g_frame_hitch_ms ? 1 : 0
+		);
+	}
+	fclose (file);
+	printf ("frame times written to %s\n", g_frame_csv_file.c_str ());
+	// written once; a later explicit call does not duplicate the work
+	g_frame_log.clear ();
+	return true;
+}
+
 /*-----------------------------------SHADERS----------------------------------*/
 bool parse_file_into_str (
 	const char* file_name, char* shader_str, int max_len
@@ -38,7 +38,35 @@ bool gl_log_err (const char* message, ...);
 bool start_gl ();
 void glfw_error_callback (int error, const char* description);
 void glfw_window_size_callback (GLFWwindow* window, int width, int height);
-void _update_fps_counter (GLFWwindow* window);
+/* fps in the window title, plus the rolling p99/max while frame times are on;
+call once per frame, after frame_times_mark () */
+void _update_fps_counter (GLFWwindow* window, const char* title = "opengl");
+/*--------------------------------FRAME TIMES---------------------------------*/
+/* the fps average hides hitches, so this keeps every frame's duration instead.
+the last FRAME_TIME_RING_SIZE durations live in a lock-free ring (one writer,
+the render thread; any thread may read stats). the whole session is written
+to a CSV file at exit. */
+#define FRAME_TIME_RING_SIZE 1024 // must be a power of two
+#define FRAME_TIME_DEFAULT_HITCH_MS 33.4 // two missed vblanks at 60 Hz
+struct Frame_Time_Stats {
+	int samples; // frames in the rolling window
+	double p50_ms, p95_ms, p99_ms, max_ms;
+	long long frames; // whole session
+	long long hitches; // whole session, frames above the hitch threshold
+};
+/* reads --tempos-quadro file.csv and --travada-ms N; enables the recorder
+if the first one is present. returns true if enabled */
+bool frame_times_parse_args (int argc, char** argv);
+void frame_times_enable (const char* csv_file_name, double hitch_ms);
+bool frame_times_enabled ();
+/* call once per frame, right after glfwSwapBuffers () */
+void frame_times_mark ();
+/* restarts the clock without recording, e.g. after sleeping on purpose while
+waiting for events, so the wait does not count as a hitch */
+void frame_times_restart ();
+Frame_Time_Stats frame_times_stats ();
+/* prints the summary and writes the CSV. registered with atexit () */
+bool frame_times_write_csv ();
 /*-----------------------------------SHADERS----------------------------------*/
 bool parse_file_into_str (const char* file_name, char* shader_str, int max_len);
 void print_shader_info_log (GLuint shader_index);
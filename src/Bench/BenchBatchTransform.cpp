@@ -0,0 +1,247 @@
+/*
+ * BenchBatchTransform.cpp
+ *
+ * Benchmark das funções em lote do maths_funcs (Common/M5-6):
+ * transform_points, transform_vec4s, iso_to_screen e cull_aabbs, sobre
+ * vetores SoA, contra o laço de um ponto por vez que cada programa escreve
+ * hoje (mat4 * vec4 para cada ponto, um if por caixa).
+ *
+ * Uso:
+ *   ./BenchBatchTransform [pontos=100000] [repeticoes=100] [semente=1]
+ *
+ * Pontos, coordenadas de grade e caixas são sorteados; cerca de um quarto
+ * das caixas toca o retângulo da tela. Cada conta roda "repeticoes" vezes
+ * sobre todos os pontos, em 5 rodadas, e vale a melhor rodada. Antes de medir,
+ * confere o lote contra o laço: as transformações somam na mesma ordem que
+ * mat4 * vec4, mas o compilador pode juntar multiplicação e soma em FMA no
+ * código escalar (-march=native), daí a TOLERANCIA; a projeção isométrica
+ * tem de dar os mesmos floats e o recorte a mesma lista de índices, na
+ * mesma ordem. Retorna 1 se algo divergir.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "maths_funcs.h"
+#include "BenchMaze.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+static const int RODADAS = 5;
+static const float TOLERANCIA = 1e-6f;
+
+// Tamanho do losango dos tiles e da tela, como no Joguinho
+static const float TILE_LARGURA = 64.0f;
+static const float TILE_ALTURA = 32.0f;
+static const float TELA_LARGURA = 960.0f;
+static const float TELA_ALTURA = 720.0f;
+
+static float sorteia(BenchRng &rng, int faixa) {
+	return (rng.range(faixa * 100 + 1) - faixa * 50) / 100.0f;
+}
+
+// Diferença relativa ao maior dos dois valores (mínimo 1)
+static float diferenca(float a, float b) {
+	return fabsf(a - b) / max(1.0f, max(fabsf(a), fabsf(b)));
+}
+
+// Melhor rodada de uma conta, em Mpontos/s
+struct Medida {
+	double ms = 1e30;
+	void registra(double t) {
+		ms = min(ms, t);
+	}
+	double mpontos(long long pontos) const {
+		return pontos / ms / 1000.0;
+	}
+};
+
+static void imprime(const char *conta, const Medida &laco, const Medida &lote, long long pontos) {
+	printf("%-16s laco %7.1f Mpontos/s   lote %7.1f Mpontos/s (%.1fx)\n", conta, laco.mpontos(pontos),
+		lote.mpontos(pontos), laco.ms / lote.ms);
+}
+
+int main(int argc, char **argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 100000;
+	int repeticoes = argc > 2 ? atoi(argv[2]) : 100;
+	uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+	if (n < 1) n = 1;
+	if (repeticoes < 1) repeticoes = 1;
+	int erros = 0;
+
+	// Uma view 3D qualquer e pontos espalhados num cubo de 200 unidades
+	mat4 m = perspective(60.0f, TELA_LARGURA / TELA_ALTURA, 0.1f, 1000.0f) *
+		look_at(vec3(30.0f, 40.0f, 150.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+	BenchRng rng(semente);
+	vector<float> x(n), y(n), z(n), w(n), ox(n), oy(n), oz(n), ow(n);
+	vector<float> gx(n), gy(n), sx(n), sy(n);
+	vector<float> minX(n), minY(n), maxX(n), maxY(n);
+	vector<int> visiveis(n), visiveisLaco(n);
+	for (int i = 0; i < n; i++) {
+		x[i] = sorteia(rng, 200);
+		y[i] = sorteia(rng, 200);
+		z[i] = sorteia(rng, 200);
+		w[i] = 1.0f + rng.range(3);
+		gx[i] = (float)rng.range(256);
+		gy[i] = (float)rng.range(256);
+		float cx = sorteia(rng, 4) * TELA_LARGURA / 2.0f;
+		float cy = sorteia(rng, 4) * TELA_ALTURA / 2.0f;
+		minX[i] = cx;
+		minY[i] = cy;
+		maxX[i] = cx + TILE_LARGURA;
+		maxY[i] = cy + TILE_ALTURA;
+	}
+
+#if defined(__AVX__)
+	const char *conjunto = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+	const char *conjunto = "SSE2";
+#else
+	const char *conjunto = "sem SIMD";
+#endif
+	printf("%d pontos, %d repeticoes, %d rodadas (%s)\n", n, repeticoes, RODADAS, conjunto);
+
+	// --- CONFERÊNCIA ---
+	float difPontos = 0.0f, difVec4 = 0.0f;
+	transform_points(m, x.data(), y.data(), z.data(), n, ox.data(), oy.data(), oz.data());
+	for (int i = 0; i < n; i++) {
+		vec4 r = m * vec4(x[i], y[i], z[i], 1.0f);
+		float d = max(diferenca(ox[i], r.v[0]), max(diferenca(oy[i], r.v[1]), diferenca(oz[i], r.v[2])));
+		difPontos = max(difPontos, d);
+		if (d > TOLERANCIA) {
+			if (erros++ < 5) printf("ERRO: transform_points difere no ponto %d (%g)\n", i, d);
+		}
+	}
+	transform_vec4s(m, x.data(), y.data(), z.data(), w.data(), n, ox.data(), oy.data(), oz.data(), ow.data());
+	for (int i = 0; i < n; i++) {
+		vec4 r = m * vec4(x[i], y[i], z[i], w[i]);
+		float d = max(max(diferenca(ox[i], r.v[0]), diferenca(oy[i], r.v[1])),
+			max(diferenca(oz[i], r.v[2]), diferenca(ow[i], r.v[3])));
+		difVec4 = max(difVec4, d);
+		if (d > TOLERANCIA) {
+			if (erros++ < 5) printf("ERRO: transform_vec4s difere no ponto %d (%g)\n", i, d);
+		}
+	}
+
+	// Saída por cima da entrada: a mesma conta, nos mesmos vetores
+	vector<float> ax(x), ay(y);
+	transform_points(m, ax.data(), ay.data(), NULL, n, ax.data(), ay.data(), NULL);
+	transform_points(m, x.data(), y.data(), NULL, n, ox.data(), oy.data(), NULL);
+	if (ax != ox || ay != oy) {
+		printf("ERRO: transform_points com saida sobre a entrada difere\n");
+		erros++;
+	}
+
+	iso_to_screen(gx.data(), gy.data(), n, TILE_LARGURA, TILE_ALTURA, TELA_LARGURA / 2.0f, 0.0f, sx.data(), sy.data());
+	for (int i = 0; i < n; i++) {
+		float ex = TELA_LARGURA / 2.0f + (gx[i] - gy[i]) * TILE_LARGURA / 2.0f;
+		float ey = (gx[i] + gy[i]) * TILE_ALTURA / 2.0f;
+		if (sx[i] != ex || sy[i] != ey) {
+			if (erros++ < 5) printf("ERRO: iso_to_screen difere no tile %d\n", i);
+		}
+	}
+
+	int nVisiveis = cull_aabbs(minX.data(), minY.data(), maxX.data(), maxY.data(), n, 0.0f, 0.0f, TELA_LARGURA,
+		TELA_ALTURA, visiveis.data());
+	int nLaco = 0;
+	for (int i = 0; i < n; i++)
+		if (maxX[i] >= 0.0f && minX[i] <= TELA_LARGURA && maxY[i] >= 0.0f && minY[i] <= TELA_ALTURA)
+			visiveisLaco[nLaco++] = i;
+	if (nVisiveis != nLaco || !equal(visiveis.begin(), visiveis.begin() + nLaco, visiveisLaco.begin())) {
+		printf("ERRO: cull_aabbs achou %d caixas, o laco %d\n", nVisiveis, nLaco);
+		erros++;
+	}
+	printf("Conferencia: transform_points ate %.2g, transform_vec4s ate %.2g, iso igual bit a bit, "
+		"%d de %d caixas visiveis nas duas versoes\n", difPontos, difVec4, nLaco, n);
+
+	// --- MEDIDAS ---
+	// Cada resultado vai para um vetor e a soma final impede o compilador de descartar as contas
+	long long pontos = (long long)n * repeticoes;
+	Medida ptLaco, ptLote, v4Laco, v4Lote, isoLaco, isoLote, culLaco, culLote;
+	for (int rodada = 0; rodada < RODADAS; rodada++) {
+		Relogio::time_point t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) {
+				vec4 r = m * vec4(x[i], y[i], z[i], 1.0f);
+				ox[i] = r.v[0];
+				oy[i] = r.v[1];
+				oz[i] = r.v[2];
+			}
+		ptLaco.registra(msDesde(t0));
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			transform_points(m, x.data(), y.data(), z.data(), n, ox.data(), oy.data(), oz.data());
+		ptLote.registra(msDesde(t0));
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) {
+				vec4 r = m * vec4(x[i], y[i], z[i], w[i]);
+				ox[i] = r.v[0];
+				oy[i] = r.v[1];
+				oz[i] = r.v[2];
+				ow[i] = r.v[3];
+			}
+		v4Laco.registra(msDesde(t0));
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			transform_vec4s(m, x.data(), y.data(), z.data(), w.data(), n, ox.data(), oy.data(), oz.data(), ow.data());
+		v4Lote.registra(msDesde(t0));
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) {
+				sx[i] = TELA_LARGURA / 2.0f + (gx[i] - gy[i]) * TILE_LARGURA / 2.0f;
+				sy[i] = (gx[i] + gy[i]) * TILE_ALTURA / 2.0f;
+			}
+		isoLaco.registra(msDesde(t0));
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			iso_to_screen(gx.data(), gy.data(), n, TILE_LARGURA, TILE_ALTURA, TELA_LARGURA / 2.0f, 0.0f, sx.data(),
+				sy.data());
+		isoLote.registra(msDesde(t0));
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++) {
+			nLaco = 0;
+			for (int i = 0; i < n; i++)
+				if (maxX[i] >= 0.0f && minX[i] <= TELA_LARGURA && maxY[i] >= 0.0f && minY[i] <= TELA_ALTURA)
+					visiveisLaco[nLaco++] = i;
+		}
+		culLaco.registra(msDesde(t0));
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			nVisiveis = cull_aabbs(minX.data(), minY.data(), maxX.data(), maxY.data(), n, 0.0f, 0.0f, TELA_LARGURA,
+				TELA_ALTURA, visiveis.data());
+		culLote.registra(msDesde(t0));
+	}
+
+	imprime("transform_points", ptLaco, ptLote, pontos);
+	imprime("transform_vec4s", v4Laco, v4Lote, pontos);
+	imprime("iso_to_screen", isoLaco, isoLote, pontos);
+	imprime("cull_aabbs", culLaco, culLote, pontos);
+
+	double soma = nVisiveis + nLaco;
+	for (int i = 0; i < n; i++)
+		soma += ox[i] + oy[i] + oz[i] + ow[i] + sx[i] + sy[i];
+	printf("(soma de controle %g)\n", soma);
+
+	if (erros) {
+		printf("ERRO: %d divergencias\n", erros);
+		return 1;
+	}
+	return 0;
+}
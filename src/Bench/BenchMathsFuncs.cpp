@@ -0,0 +1,248 @@
+/*
+ * BenchMathsFuncs.cpp
+ *
+ * Benchmark das contas de mat4 do maths_funcs (Common/M5-6): as versões
+ * SSE/AVX de mat4 * mat4, mat4 * vec4, inverse e transpose contra as
+ * escalares originais (mat4_mul_scalar, ...) e contra a GLM.
+ *
+ * Uso:
+ *   ./BenchMathsFuncs [matrizes=4096] [repeticoes=200] [semente=1]
+ *
+ * As matrizes são sorteadas com a diagonal dominante (sempre inversíveis e
+ * bem condicionadas). Cada conta roda "repeticoes" vezes sobre todas as
+ * matrizes, em 5 rodadas, e vale o tempo da melhor rodada. Antes de medir,
+ * confere cada resultado SIMD com o escalar: a transposta tem de dar os
+ * mesmos floats; os produtos também, já que a soma é feita na mesma ordem,
+ * a menos que o compilador junte multiplicação e soma em FMA no código
+ * escalar (-march=native), daí a TOLERANCIA_PRODUTO; a inversa pode
+ * diferir por arredondamento, até TOLERANCIA_INVERSA do maior elemento.
+ * Os resultados da GLM passam pela tolerância da inversa. Retorna 1 se
+ * algo divergir.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "maths_funcs.h"
+#include "BenchMaze.h"
+
+#include <glm/glm.hpp>
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+static const int RODADAS = 5;
+static const float TOLERANCIA_PRODUTO = 1e-6f;
+static const float TOLERANCIA_INVERSA = 1e-5f;
+
+static float sorteia(BenchRng &rng) {
+	return (rng.range(20001) - 10000) / 10000.0f;
+}
+
+static glm::mat4 paraGlm(const mat4 &m) {
+	glm::mat4 g;
+	memcpy(&g[0][0], m.m, sizeof(m.m));
+	return g;
+}
+
+// Maior diferença entre a e b, relativa ao maior elemento de b (mínimo 1)
+static float diferenca(const float *a, const float *b, int n) {
+	float maior = 1.0f, dif = 0.0f;
+	for (int i = 0; i < n; i++) {
+		maior = max(maior, fabsf(b[i]));
+		dif = max(dif, fabsf(a[i] - b[i]));
+	}
+	return dif / maior;
+}
+
+static bool mesmosFloats(const float *a, const float *b, int n) {
+	for (int i = 0; i < n; i++)
+		if (a[i] != b[i]) return false;
+	return true;
+}
+
+// Tempo por operação, em ns, da melhor rodada
+struct Medida {
+	double ns = 1e30;
+	void registra(double ms, long long operacoes) {
+		ns = min(ns, ms * 1e6 / operacoes);
+	}
+};
+
+static void imprime(const char *conta, const Medida &escalar, const Medida &simd, const Medida &glm) {
+	printf("%-12s escalar %6.2f ns   SIMD %6.2f ns (%.1fx)   GLM %6.2f ns (%.1fx)\n", conta, escalar.ns, simd.ns,
+		escalar.ns / simd.ns, glm.ns, escalar.ns / glm.ns);
+}
+
+int main(int argc, char **argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 4096;
+	int repeticoes = argc > 2 ? atoi(argv[2]) : 200;
+	uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+	if (n < 2) n = 2;
+	int erros = 0;
+
+	BenchRng rng(semente);
+	vector<mat4> a(n), r(n);
+	vector<vec4> v(n), rv(n);
+	vector<glm::mat4> ga(n), gr(n);
+	vector<glm::vec4> gv(n), grv(n);
+	for (int i = 0; i < n; i++) {
+		for (int k = 0; k < 16; k++)
+			a[i].m[k] = sorteia(rng);
+		for (int k = 0; k < 4; k++) {
+			a[i].m[k * 5] += a[i].m[k * 5] < 0.0f ? -4.0f : 4.0f;
+			v[i].v[k] = sorteia(rng) * 100.0f;
+		}
+		ga[i] = paraGlm(a[i]);
+		gv[i] = glm::vec4(v[i].v[0], v[i].v[1], v[i].v[2], v[i].v[3]);
+	}
+
+#if defined(__AVX__)
+	const char *conjunto = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+	const char *conjunto = "SSE2";
+#else
+	const char *conjunto = "sem SIMD";
+#endif
+	printf("%d matrizes, %d repeticoes, %d rodadas (%s)\n", n, repeticoes, RODADAS, conjunto);
+
+	// --- CONFERÊNCIA ---
+	float difProduto = 0.0f, difInversa = 0.0f, difGlm = 0.0f;
+	int produtosDiferentes = 0;
+	for (int i = 0; i < n; i++) {
+		const mat4 &b = a[(i + 1) % n];
+		mat4 simd = a[i] * b;
+		mat4 escalar = mat4_mul_scalar(a[i], b);
+		glm::mat4 g = ga[i] * ga[(i + 1) % n];
+		float d = diferenca(simd.m, escalar.m, 16);
+		difProduto = max(difProduto, d);
+		produtosDiferentes += !mesmosFloats(simd.m, escalar.m, 16);
+		if (d > TOLERANCIA_PRODUTO) {
+			if (erros++ < 5) printf("ERRO: mat4 * mat4 difere na matriz %d (%g)\n", i, d);
+		}
+		difGlm = max(difGlm, diferenca(&g[0][0], escalar.m, 16));
+
+		vec4 sv = a[i] * v[i];
+		vec4 ev = mat4_mul_vec4_scalar(a[i], v[i]);
+		glm::vec4 gvr = ga[i] * gv[i];
+		d = diferenca(sv.v, ev.v, 4);
+		difProduto = max(difProduto, d);
+		produtosDiferentes += !mesmosFloats(sv.v, ev.v, 4);
+		if (d > TOLERANCIA_PRODUTO) {
+			if (erros++ < 5) printf("ERRO: mat4 * vec4 difere na matriz %d (%g)\n", i, d);
+		}
+		difGlm = max(difGlm, diferenca(&gvr[0], ev.v, 4));
+
+		mat4 st = transpose(a[i]);
+		mat4 et = transpose_scalar(a[i]);
+		if (!mesmosFloats(st.m, et.m, 16)) {
+			if (erros++ < 5) printf("ERRO: transpose difere na matriz %d\n", i);
+		}
+
+		mat4 si = inverse(a[i]);
+		mat4 ei = inverse_scalar(a[i]);
+		glm::mat4 gi = glm::inverse(ga[i]);
+		d = diferenca(si.m, ei.m, 16);
+		difInversa = max(difInversa, d);
+		if (d > TOLERANCIA_INVERSA) {
+			if (erros++ < 5) printf("ERRO: inverse difere na matriz %d (%g)\n", i, d);
+		}
+		difGlm = max(difGlm, diferenca(&gi[0][0], ei.m, 16));
+	}
+	if (difGlm > TOLERANCIA_INVERSA) {
+		printf("ERRO: a GLM difere das contas escalares em ate %g\n", difGlm);
+		erros++;
+	}
+	if (produtosDiferentes)
+		printf("Conferencia: %d produtos diferem do escalar (ate %.2g), transposta igual, inversa ate %.2g, GLM ate %.2g\n",
+			produtosDiferentes, difProduto, difInversa, difGlm);
+	else
+		printf("Conferencia: produtos e transposta iguais bit a bit, inversa ate %.2g, GLM ate %.2g\n", difInversa, difGlm);
+
+	// --- MEDIDAS ---
+	// Cada resultado vai para um vetor e a soma final impede o compilador de descartar as contas
+	long long ops = (long long)n * repeticoes;
+	Medida mulEscalar, mulSimd, mulGlm, vecEscalar, vecSimd, vecGlm;
+	Medida invEscalar, invSimd, invGlm, traEscalar, traSimd, traGlm;
+	for (int rodada = 0; rodada < RODADAS; rodada++) {
+		Relogio::time_point t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = mat4_mul_scalar(a[i], a[n - 1 - i]);
+		mulEscalar.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = a[i] * a[n - 1 - i];
+		mulSimd.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) gr[i] = ga[i] * ga[n - 1 - i];
+		mulGlm.registra(msDesde(t0), ops);
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) rv[i] = mat4_mul_vec4_scalar(a[i], v[i]);
+		vecEscalar.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) rv[i] = a[i] * v[i];
+		vecSimd.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) grv[i] = ga[i] * gv[i];
+		vecGlm.registra(msDesde(t0), ops);
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = inverse_scalar(a[i]);
+		invEscalar.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = inverse(a[i]);
+		invSimd.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) gr[i] = glm::inverse(ga[i]);
+		invGlm.registra(msDesde(t0), ops);
+
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = transpose_scalar(a[i]);
+		traEscalar.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) r[i] = transpose(a[i]);
+		traSimd.registra(msDesde(t0), ops);
+		t0 = Relogio::now();
+		for (int k = 0; k < repeticoes; k++)
+			for (int i = 0; i < n; i++) gr[i] = glm::transpose(ga[i]);
+		traGlm.registra(msDesde(t0), ops);
+	}
+
+	imprime("mat4 * mat4", mulEscalar, mulSimd, mulGlm);
+	imprime("mat4 * vec4", vecEscalar, vecSimd, vecGlm);
+	imprime("inverse", invEscalar, invSimd, invGlm);
+	imprime("transpose", traEscalar, traSimd, traGlm);
+
+	double soma = 0.0;
+	for (int i = 0; i < n; i++)
+		soma += r[i].m[i % 16] + rv[i].v[i % 4] + gr[i][i % 4][0] + grv[i][i % 4];
+	printf("(soma de controle %g)\n", soma);
+
+	if (erros) {
+		printf("ERRO: %d divergencias\n", erros);
+		return 1;
+	}
+	return 0;
+}
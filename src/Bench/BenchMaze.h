@@ -0,0 +1,76 @@
+//
+//  BenchMaze.h
+//  Geração de labirintos para os benchmarks de navegação.
+//
+
+#ifndef BenchMaze_h
+#define BenchMaze_h
+
+#include "WalkGrid.h"
+#include <stdint.h>
+#include <vector>
+
+// Gerador pseudoaleatório simples e determinístico (xorshift64*)
+struct BenchRng {
+    uint64_t s;
+    explicit BenchRng(uint64_t seed) : s(seed ? seed : 0x9E3779B97F4A7C15ull) {}
+    uint32_t next() {
+        s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+        return (uint32_t)((s * 0x2545F4914F6CDD1Dull) >> 32);
+    }
+    int range(int n) {
+        return (int)(next() % (uint32_t)n);
+    }
+};
+
+// Labirinto "perfeito" por backtracking iterativo (células nas coordenadas
+// ímpares, paredes de 1 célula) e depois abre aberturas extras ao acaso para
+// criar rotas alternativas.
+inline void generateMaze(WalkGrid &grid, int w, int h, uint64_t seed, int extraOpeningsPercent) {
+    grid.resize(w, h, false);
+    BenchRng rng(seed);
+    int cw = (w - 1) / 2, ch = (h - 1) / 2;
+    std::vector<uint8_t> visitado((size_t)cw * ch, 0);
+    std::vector<int> pilha;
+    pilha.push_back(0);
+    visitado[0] = 1;
+    grid.setWalkable(1, 1, true);
+    static const int DX[4] = { 1, -1, 0, 0 };
+    static const int DY[4] = { 0, 0, 1, -1 };
+    while (!pilha.empty()) {
+        int c = pilha.back();
+        int cx = c % cw, cy = c / cw;
+        int opcoes[4], n = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + DX[d], ny = cy + DY[d];
+            if (nx < 0 || ny < 0 || nx >= cw || ny >= ch) continue;
+            if (!visitado[(size_t)ny * cw + nx]) opcoes[n++] = d;
+        }
+        if (n == 0) {
+            pilha.pop_back();
+            continue;
+        }
+        int d = opcoes[rng.range(n)];
+        int nx = cx + DX[d], ny = cy + DY[d];
+        visitado[(size_t)ny * cw + nx] = 1;
+        grid.setWalkable(2 * cx + 1 + DX[d], 2 * cy + 1 + DY[d], true);
+        grid.setWalkable(2 * nx + 1, 2 * ny + 1, true);
+        pilha.push_back(ny * cw + nx);
+    }
+    // Abre paredes entre duas células para criar ciclos
+    long total = (long)cw * ch * extraOpeningsPercent / 100;
+    for (long i = 0; i < total; i++) {
+        int x = 1 + rng.range(w - 2), y = 1 + rng.range(h - 2);
+        if ((x + y) % 2 == 1) grid.setWalkable(x, y, true);
+    }
+}
+
+// Sorteia uma célula caminhável
+inline GridPoint randomWalkable(const WalkGrid &grid, BenchRng &rng) {
+    while (true) {
+        GridPoint p = { rng.range(grid.getWidth()), rng.range(grid.getHeight()) };
+        if (grid.isWalkable(p.x, p.y)) return p;
+    }
+}
+
+#endif /* BenchMaze_h */
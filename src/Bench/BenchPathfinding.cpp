@@ -0,0 +1,160 @@
+/*
+ * BenchPathfinding.cpp
+ *
+ * Benchmark da busca de caminhos (Common/Pathfinding) em labirintos gerados.
+ *
+ * Uso:
+ *   ./BenchPathfinding [tamanho=1024] [consultas=200] [semente=1] [threads=0]
+ *
+ * Para cada consulta roda A* e JPS entre o mesmo par de células e confere
+ * se os dois chegaram ao mesmo custo. Ao final mostra tempo médio por
+ * consulta, nós expandidos e tamanho dos caminhos compactos.
+ *
+ * Depois repete as consultas JPS como tarefas do JobSystem, com um
+ * Pathfinder por thread (threads conta a principal; 0: uma por núcleo), e
+ * confere que os custos são os mesmos da execução sequencial.
+ *
+ * Antes do labirinto, confere A* e JPS em casos fixos de grades livres em
+ * que o salto horizontal corre até a borda na primeira e na última linha
+ * (rode com -fsanitize=address para pegar leituras fora das guardas).
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "WalkGrid.h"
+#include "Pathfinding.h"
+#include "JobSystem.h"
+#include "BenchMaze.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+// Grade livre, origem, destino e custo esperado (diagonais valem sqrt(2))
+struct CasoFixo {
+	int largura, altura;
+	GridPoint origem, destino;
+};
+
+static const CasoFixo CASOS_FIXOS[] = {
+	{ 15, 15, { 10, 0 }, { 0, 5 } },    // salto para a esquerda até a guarda na linha 0
+	{ 64, 64, { 10, 63 }, { 63, 58 } }, // largura múltipla de 64: para a direita na última linha
+};
+
+static int confereCasosFixos() {
+	int erros = 0;
+	Pathfinder pf;
+	PathResult res;
+	for (size_t c = 0; c < sizeof(CASOS_FIXOS) / sizeof(CASOS_FIXOS[0]); c++) {
+		const CasoFixo &k = CASOS_FIXOS[c];
+		WalkGrid grade(k.largura, k.altura, true);
+		int dx = abs(k.destino.x - k.origem.x), dy = abs(k.destino.y - k.origem.y);
+		float esperado = (float)(max(dx, dy) - min(dx, dy)) + (float)min(dx, dy) * sqrtf(2.0f);
+		PathAlgorithm algoritmos[2] = { PATH_ASTAR, PATH_JPS };
+		for (int a = 0; a < 2; a++) {
+			pf.findPath(grade, k.origem, k.destino, res, algoritmos[a]);
+			if (!res.found || fabs(res.cost - esperado) > 1e-3f) {
+				printf("ERRO: caso fixo %zu (%dx%d, {%d,%d} -> {%d,%d}) com %s: custo %.3f, esperado %.3f\n",
+					c, k.largura, k.altura, k.origem.x, k.origem.y, k.destino.x, k.destino.y,
+					a ? "JPS" : "A*", res.found ? res.cost : -1.0f, esperado);
+				erros++;
+			}
+		}
+	}
+	return erros;
+}
+
+int main(int argc, char **argv)
+{
+	int tamanho = argc > 1 ? atoi(argv[1]) : 1024;
+	int consultas = argc > 2 ? atoi(argv[2]) : 200;
+	uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+	int threads = argc > 4 ? atoi(argv[4]) : 0;
+
+	if (confereCasosFixos()) return 1;
+	printf("Casos fixos de borda conferidos\n");
+
+	WalkGrid grade;
+	Relogio::time_point t0 = Relogio::now();
+	generateMaze(grade, tamanho, tamanho, semente, 10);
+	printf("Labirinto %dx%d gerado em %.1f ms (%zu bytes de grade)\n",
+		tamanho, tamanho, msDesde(t0), grade.memoryBytes());
+
+	BenchRng rng(semente * 7919);
+	vector<GridPoint> origens, destinos;
+	for (int i = 0; i < consultas; i++) {
+		origens.push_back(randomWalkable(grade, rng));
+		destinos.push_back(randomWalkable(grade, rng));
+	}
+
+	Pathfinder pf;
+	PathResult res;
+	double msSequencial = 0.0;
+	const char *nomes[2] = { "A*", "JPS" };
+	PathAlgorithm algoritmos[2] = { PATH_ASTAR, PATH_JPS };
+	vector<float> custos[2];
+	int divergencias = 0;
+
+	for (int a = 0; a < 2; a++) {
+		long expandidos = 0, pontos = 0, encontrados = 0;
+		t0 = Relogio::now();
+		for (int i = 0; i < consultas; i++) {
+			pf.findPath(grade, origens[i], destinos[i], res, algoritmos[a]);
+			custos[a].push_back(res.found ? res.cost : -1.0f);
+			expandidos += res.expanded;
+			pontos += (long)res.waypoints.size();
+			encontrados += res.found;
+		}
+		double ms = msDesde(t0);
+		msSequencial = ms;
+		printf("%-4s %8.3f ms/consulta  %10.0f nos expandidos/consulta  %6.1f pontos/caminho  (%ld/%d encontrados)\n",
+			nomes[a], ms / consultas, (double)expandidos / consultas,
+			encontrados ? (double)pontos / encontrados : 0.0, encontrados, consultas);
+	}
+
+	for (int i = 0; i < consultas; i++) {
+		if (fabs(custos[0][i] - custos[1][i]) > 1e-2f * (1.0f + custos[0][i]))
+			divergencias++;
+	}
+	if (divergencias) {
+		printf("ERRO: %d consultas com custo diferente entre A* e JPS\n", divergencias);
+		return 1;
+	}
+	printf("A* e JPS concordam no custo de todas as consultas\n");
+
+	// As mesmas consultas JPS em paralelo: cada thread usa o seu Pathfinder
+	JobSystem jobs(threads > 0 ? threads - 1 : -1);
+	vector<Pathfinder> porThread(jobs.getThreads());
+	vector<float> custosParalelos(consultas);
+	t0 = Relogio::now();
+	jobs.parallelFor(consultas, 4, [&](int inicio, int fim) {
+		Pathfinder &p = porThread[jobs.currentSlot()];
+		PathResult r;
+		for (int i = inicio; i < fim; i++) {
+			p.findPath(grade, origens[i], destinos[i], r, PATH_JPS);
+			custosParalelos[i] = r.found ? r.cost : -1.0f;
+		}
+	});
+	double msParalelo = msDesde(t0);
+	printf("JPS  %8.3f ms/consulta com %d threads (%.2fx; %lld tarefas, %lld roubadas)\n",
+		msParalelo / consultas, jobs.getThreads(), msParalelo > 0.0 ? msSequencial / msParalelo : 0.0,
+		jobs.getExecuted(), jobs.getStolen());
+	for (int i = 0; i < consultas; i++) {
+		if (custosParalelos[i] != custos[1][i]) divergencias++;
+	}
+	if (divergencias) {
+		printf("ERRO: %d consultas com custo diferente entre JPS sequencial e paralelo\n", divergencias);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,1066 @@
+/*
+ * BenchRender.cpp
+ *
+ * Benchmark de desenho sem janela: cria um contexto OpenGL offscreen pela
+ * EGL (plataforma surfaceless da Mesa, então roda numa máquina sem GPU com
+ * llvmpipe), desenha cenas roteirizadas num FBO e imprime as medidas em JSON.
+ *
+ * Uso:
+ *   ./BenchRender [quadros=300] [cena=todas] [assets=../assets/] [threads=0]
+ *
+ * Cenas (cada uma repete o caminho de desenho do programa de origem):
+ *   joguinho_mapa  mapa isométrico 15x15 do Joguinho, personagem e moedas, com a câmera andando:
+ *                  o mapa fica num VBO montado uma vez e a câmera vai no uniforme view
+ *   joguinho_mapa_por_tile  o mesmo quadro como antes, um desenho por tile com a câmera na model
+ *   m4_parallax    5 camadas de parallax do M4 pelo ParallaxRenderer (opacos da frente
+ *                  para trás com profundidade, só as bordas com blend) e os sprites por cima
+ *   m4_parallax_sprites  o parallax antigo do M4: cada camada em duas cópias pelo Sprite::Draw
+ *   fundo_camadas  as 6 camadas 1920x1080 de backgrounds/layers pelo ParallaxRenderer
+ *   fundo_camadas_sprites  as mesmas 6 camadas em duas cópias de sprite, todas com blend
+ *   hud_texto      80 textos por quadro com stb_easy_font, como o drawText_GL33
+ *   sprites_10k    10.000 sprites desenhados um a um, como o Sprite::Draw do M4
+ *   sprites_100k_pulando  o --estresse do M4: 100.000 sprites pulando (SpritePhysics) num desenho instanciado
+ *   sprites_10k_listas  os mesmos sprites gravados em 8 listas de comandos em paralelo
+ *
+ * joguinho_mapa, joguinho_mapa_por_tile e sprites_10k_listas gravam listas de comandos (RenderCommands.h)
+ * em tarefas do JobSystem com "threads" threads contando a principal (0: uma
+ * por núcleo) e as enviam em ordem; gravacao_ms
+ * é o tempo de gravação por quadro, já incluído em cpu_ms.
+ *
+ * Mede por cena: tempo de CPU para emitir cada quadro (média, p50, p95),
+ * tempo de GPU por consulta GL_TIME_ELAPSED e, pela GLInstrumentation, as
+ * chamadas OpenGL por quadro (desenhos, vértices, binds, uniformes, bytes
+ * enviados para buffers e mudanças de estado redundantes). Para comparar números
+ * entre máquinas, rode com LIBGL_ALWAYS_SOFTWARE=1 (llvmpipe).
+ * Os vértices dinâmicos vão pelo StreamBuffer, como nos programas:
+ * bytes_streaming é o que foi escrito nele por quadro (já incluído em
+ * bytes_buffer) e esperas_streaming, quantas vezes a CPU teve de esperar a
+ * GPU largar uma região.
+ * No llvmpipe a rasterização acontece no glFlush do fim do quadro, então o
+ * custo de preenchimento aparece em cpu_ms e quase nada em gpu_ms.
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glad/glad.h>
+
+#define EGL_NO_X11
+#define MESA_EGL_NO_X11_HEADERS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include "stb_easy_font.h"
+#include "Simulacao.h"
+#include "GLInstrumentation.h"
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
+#include "RenderCommands.h"
+#include "JobSystem.h"
+#include "ParallaxRenderer.h"
+#include "SpritePhysics.h"
+#include "Camera.h"
+
+using namespace std;
+using namespace glm;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+// Listas de comandos gravadas em paralelo e enviadas em ordem, como no Joguinho
+static JobSystem *jobs = NULL;            // criado no main com as threads pedidas
+static RenderQueue fila;
+static double msGravacao = 0.0;           // soma do tempo de gravação da cena
+
+static void gravaEmParalelo(int tarefas, const function<void(int)> &tarefa) {
+	Relogio::time_point t0 = Relogio::now();
+	jobs->parallelFor(tarefas, 1, [&](int i, int) { tarefa(i); });
+	msGravacao += msDesde(t0);
+}
+
+// --- Contexto offscreen ---
+static EGLDisplay tela = EGL_NO_DISPLAY;
+static EGLContext contexto = EGL_NO_CONTEXT;
+static EGLSurface superficie = EGL_NO_SURFACE;
+
+static bool criaContexto() {
+	// Plataforma surfaceless: não precisa de servidor X nem de DRM
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (getPlatformDisplay)
+		tela = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	if (tela == EGL_NO_DISPLAY)
+		tela = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	EGLint maior = 0, menor = 0;
+	if (tela == EGL_NO_DISPLAY || !eglInitialize(tela, &maior, &menor)) {
+		fprintf(stderr, "EGL: nao foi possivel inicializar o display\n");
+		return false;
+	}
+	if (!eglBindAPI(EGL_OPENGL_API)) {
+		fprintf(stderr, "EGL: OpenGL de desktop indisponivel\n");
+		return false;
+	}
+
+	const EGLint atributos[] = {
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+		EGL_NONE
+	};
+	EGLConfig config;
+	EGLint nConfigs = 0;
+	if (!eglChooseConfig(tela, atributos, &config, 1, &nConfigs) || nConfigs == 0) {
+		fprintf(stderr, "EGL: nenhuma configuracao com OpenGL\n");
+		return false;
+	}
+
+	// Perfil de compatibilidade, como a janela dos programas: o texto usa GL_QUADS
+	const EGLint versao[] = {
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_COMPATIBILITY_PROFILE_BIT,
+		EGL_NONE
+	};
+	contexto = eglCreateContext(tela, config, EGL_NO_CONTEXT, versao);
+	if (contexto == EGL_NO_CONTEXT) {
+		fprintf(stderr, "EGL: falha ao criar contexto OpenGL 3.3\n");
+		return false;
+	}
+
+	// Sem EGL_KHR_surfaceless_context, um pbuffer mínimo só para ficar corrente
+	if (!eglMakeCurrent(tela, EGL_NO_SURFACE, EGL_NO_SURFACE, contexto)) {
+		const EGLint pbuffer[] = { EGL_WIDTH, 16, EGL_HEIGHT, 16, EGL_NONE };
+		superficie = eglCreatePbufferSurface(tela, config, pbuffer);
+		if (superficie == EGL_NO_SURFACE || !eglMakeCurrent(tela, superficie, superficie, contexto)) {
+			fprintf(stderr, "EGL: falha ao tornar o contexto corrente\n");
+			return false;
+		}
+	}
+	if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+		fprintf(stderr, "Falha ao inicializar GLAD\n");
+		return false;
+	}
+	return true;
+}
+
+static void liberaContexto() {
+	eglMakeCurrent(tela, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+	if (superficie != EGL_NO_SURFACE) eglDestroySurface(tela, superficie);
+	eglDestroyContext(tela, contexto);
+	eglTerminate(tela);
+}
+
+// --- Recursos compartilhados pelas cenas ---
+static string pastaAssets = "../assets/";
+static int texturasSubstitutas = 0;
+
+static GLuint compilaPrograma(const char *vs, const char *fs) {
+	GLuint v = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(v, 1, &vs, NULL);
+	glCompileShader(v);
+	GLuint f = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(f, 1, &fs, NULL);
+	glCompileShader(f);
+	GLuint p = glCreateProgram();
+	glAttachShader(p, v);
+	glAttachShader(p, f);
+	glLinkProgram(p);
+	GLint ok = 0;
+	glGetProgramiv(p, GL_LINK_STATUS, &ok);
+	if (!ok) {
+		char log[512];
+		glGetProgramInfoLog(p, sizeof(log), NULL, log);
+		fprintf(stderr, "Erro ao ligar o shader: %s\n", log);
+	}
+	glDeleteShader(v);
+	glDeleteShader(f);
+	return p;
+}
+
+// Substituto de uma imagem que falta, em RGBA
+static vector<unsigned char> xadrez(int w, int h) {
+	vector<unsigned char> pixels((size_t)w * h * 4);
+	for (int y = 0; y < h; y++) {
+		for (int x = 0; x < w; x++) {
+			unsigned char *p = &pixels[((size_t)y * w + x) * 4];
+			bool claro = ((x / 16) + (y / 16)) % 2 == 0;
+			p[0] = claro ? 200 : 60;
+			p[1] = claro ? 180 : 90;
+			p[2] = 120;
+			p[3] = (x / 32 + y / 32) % 3 == 0 ? 0 : 255; // buracos transparentes, como nos PNGs
+		}
+	}
+	return pixels;
+}
+
+// Carrega a textura do programa original; sem o arquivo (ou sem o decodificador),
+// usa um xadrez do mesmo tamanho para não mudar o custo de amostragem
+static GLuint carregaTextura(const string &arquivo, int larguraPadrao, int alturaPadrao, int *largura = NULL, int *altura = NULL) {
+	GLuint tex;
+	glGenTextures(1, &tex);
+	glBindTexture(GL_TEXTURE_2D, tex);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	int w = 0, h = 0, canais = 0;
+	unsigned char *dados = stbi_load((pastaAssets + arquivo).c_str(), &w, &h, &canais, 4);
+	if (dados) {
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, dados);
+		stbi_image_free(dados);
+	} else {
+		texturasSubstitutas++;
+		w = larguraPadrao;
+		h = alturaPadrao;
+		vector<unsigned char> pixels = xadrez(w, h);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+	}
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	if (largura) *largura = w;
+	if (altura) *altura = h;
+	return tex;
+}
+
+// Quad de 4 vértices (x, y, z, s, t) em triangle strip
+static GLuint criaQuad(const GLfloat vertices[20]) {
+	GLuint vbo, vao;
+	glGenVertexArrays(1, &vao);
+	glGenBuffers(1, &vbo);
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, 20 * sizeof(GLfloat), vertices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
+	return vao;
+}
+
+// ============================================================================
+// Cena: mapa do Joguinho (gravarMapa, gravarPersonagem, gravarMoedas)
+// ============================================================================
+static const char *JOGUINHO_VS = R"(
+ #version 400
+ layout (location = 0) in vec3 position;
+ layout (location = 1) in vec2 texc;
+ out vec2 tex_coord;
+ uniform mat4 model;
+ uniform mat4 view;
+ uniform mat4 projection;
+ void main()
+ {
+	tex_coord = vec2(texc.s, 1.0 - texc.t);
+	gl_Position = projection * view * model * vec4(position, 1.0);
+ }
+ )";
+
+static const char *JOGUINHO_FS = R"(
+ #version 400
+ in vec2 tex_coord;
+ out vec4 color;
+ uniform sampler2D tex_buff;
+ uniform vec2 offsetTex;
+ void main()
+ {
+	 color = texture(tex_buff,tex_coord + offsetTex);
+ }
+ )";
+
+namespace joguinho {
+	const float LARGURA = 960, ALTURA = 720;
+	const float TILE_W = 100, TILE_H = 50;
+	Simulacao sim;
+	GLuint programa, vaoTile, vaoMigore, vaoMoeda, vaoMapa, texTiles, texMigore, texMoedas;
+	float dsTile, dsMigore, dsMoeda;
+	GLint locModel, locOffsetTex, locView;
+	Camera camera;
+	const int VERTICES_TILE = 6;
+
+	// Ponto da grade isométrica em pixels de mundo, como o noMundo do Joguinho
+	vec2 noMundo(vec2 p) {
+		return vec2((p.x - p.y) * TILE_W / 2.0f, (p.x + p.y) * TILE_H / 2.0f);
+	}
+
+	// O mapa inteiro em coordenadas de mundo num VBO só (verticesTile do Joguinho)
+	GLuint criaMapa() {
+		const float cantos[4][4] = {
+			{ 0.0f, 0.5f, 0.0f, 0.5f }, { 0.5f, 1.0f, dsTile / 2.0f, 1.0f },
+			{ 0.5f, 0.0f, dsTile / 2.0f, 0.0f }, { 1.0f, 0.5f, dsTile, 0.5f }
+		};
+		const int ordem[VERTICES_TILE] = { 0, 1, 2, 1, 3, 2 };
+		vector<GLfloat> v;
+		for (int y = 0; y < TILEMAP_HEIGHT; y++) {
+			for (int x = 0; x < TILEMAP_WIDTH; x++) {
+				vec2 base = noMundo(vec2(x, y)) - vec2(TILE_W / 2.0f, 0.0f);
+				for (int i = 0; i < VERTICES_TILE; i++) {
+					const float *c = cantos[ordem[i]];
+					GLfloat vertice[5] = { base.x + c[0] * TILE_W, base.y + c[1] * TILE_H, 0.0f,
+						sim.mapa[x][y] * dsTile + c[2], c[3] };
+					v.insert(v.end(), vertice, vertice + 5);
+				}
+			}
+		}
+		GLuint vbo, vao;
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &vbo);
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferData(GL_ARRAY_BUFFER, v.size() * sizeof(GLfloat), v.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+		glEnableVertexAttribArray(1);
+		glBindVertexArray(0);
+		return vao;
+	}
+
+	void prepara() {
+		if (!sim.carregaMapas(pastaAssets + "maps/")) {
+			// Sem os mapas, um xadrez com os 7 tiles do tileset
+			for (int x = 0; x < TILEMAP_WIDTH; x++)
+				for (int y = 0; y < TILEMAP_HEIGHT; y++)
+					sim.mapa[x][y] = (x * 3 + y) % 7;
+		} else {
+			sim.reinicia();
+		}
+		programa = compilaPrograma(JOGUINHO_VS, JOGUINHO_FS);
+		glUseProgram(programa);
+		glUniform1i(glGetUniformLocation(programa, "tex_buff"), 0);
+		mat4 projecao = ortho(0.0, 960.0, 720.0, 0.0, -1.0, 1.0);
+		glUniformMatrix4fv(glGetUniformLocation(programa, "projection"), 1, GL_FALSE, value_ptr(projecao));
+		locModel = glGetUniformLocation(programa, "model");
+		locOffsetTex = glGetUniformLocation(programa, "offsetTex");
+		locView = glGetUniformLocation(programa, "view");
+		camera.setViewport(LARGURA, ALTURA);
+
+		texTiles = carregaTextura("tilesets/tilesetIso.png", 700, 50);
+		texMigore = carregaTextura("tilesets/migore.png", 256, 512);
+		texMoedas = carregaTextura("sprites/moedas.png", 160, 32);
+
+		// setupTile(7, ...) do Joguinho: losango 2:1 com a fatia do tileset
+		dsTile = 1.0f / 7.0f;
+		const GLfloat tile[20] = {
+			0.0f, 0.5f, 0.0f, 0.0f, 0.5f,
+			0.5f, 1.0f, 0.0f, dsTile / 2.0f, 1.0f,
+			0.5f, 0.0f, 0.0f, dsTile / 2.0f, 0.0f,
+			1.0f, 0.5f, 0.0f, dsTile, 0.5f
+		};
+		vaoTile = criaQuad(tile);
+		// setupSprite(8 direções, 4 frames) e setupSprite(1, 5) das moedas
+		dsMigore = 1.0f / 4.0f;
+		const GLfloat migore[20] = {
+			-0.5f, 0.5f, 0.0f, 0.0f, 1.0f / 8.0f,
+			-0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+			0.5f, 0.5f, 0.0f, dsMigore, 1.0f / 8.0f,
+			0.5f, -0.5f, 0.0f, dsMigore, 0.0f
+		};
+		vaoMigore = criaQuad(migore);
+		dsMoeda = 1.0f / 5.0f;
+		const GLfloat moeda[20] = {
+			-0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
+			-0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+			0.5f, 0.5f, 0.0f, dsMoeda, 1.0f,
+			0.5f, -0.5f, 0.0f, dsMoeda, 0.0f
+		};
+		vaoMoeda = criaQuad(moeda);
+		vaoMapa = criaMapa();
+
+		glEnable(GL_DEPTH_TEST);
+		glDepthFunc(GL_ALWAYS);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	// Mesmas fatias e camadas do Joguinho
+	const int FATIAS_MAPA = 3;
+	RenderCommandList listas[FATIAS_MAPA + 1];
+
+	void gravaMapa(RenderCommandList &lista, float x0, float y0, int yInicio, int yFim) {
+		for (int y = yInicio; y < yFim; y++) {
+			for (int x = 0; x < TILEMAP_WIDTH; x++) {
+				int iTile = sim.mapa[x][y];
+				mat4 model = mat4(1);
+				model = translate(model, vec3(x0 + (x - y) * TILE_W / 2.0f, y0 + (x + y) * TILE_H / 2.0f, 0.0f));
+				model = scale(model, vec3(TILE_W, TILE_H, 1.0f));
+				RenderCommand &c = lista.draw(RenderCommand::makeKey(0, 0, programa, texTiles), programa, vaoTile, texTiles,
+					GL_TRIANGLE_STRIP, 0, 4);
+				c.setModel(locModel, value_ptr(model));
+				c.setParam(locOffsetTex, 2, iTile * dsTile, 0.0f);
+			}
+		}
+	}
+
+	void gravaSprites(RenderCommandList &lista, int q, float t, vec2 personagem, float x0, float y0) {
+		// Personagem no centro da tela
+		mat4 model = scale(translate(mat4(1), vec3(personagem.x, personagem.y, 0.0f)), vec3(100, 100, 1));
+		RenderCommand &c = lista.draw(RenderCommand::makeKey(1, 0, programa, texMigore), programa, vaoMigore, texMigore,
+			GL_TRIANGLE_STRIP, 0, 4);
+		c.setModel(locModel, value_ptr(model));
+		c.setParam(locOffsetTex, 2, (q / 8 % 4) * dsMigore, 0.0f);
+
+		// Moedas flutuando
+		x0 += TILE_W / 2.0f;
+		for (int i = 0; i < NUM_MOEDAS; i++) {
+			int j = sim.moedasMapa[i].x, k = sim.moedasMapa[i].y;
+			float oy = 12.0f * sinf(t * 1.5f + i);
+			model = scale(translate(mat4(1), vec3(x0 + (j - k) * TILE_W / 2.0f, y0 + (j + k) * TILE_H / 2.0f + oy, 0.0f)),
+				vec3(40, 40, 1));
+			RenderCommand &m = lista.draw(RenderCommand::makeKey(1, 1, programa, texMoedas), programa, vaoMoeda, texMoedas,
+				GL_TRIANGLE_STRIP, 0, 4);
+			m.setModel(locModel, value_ptr(model));
+			m.setParam(locOffsetTex, 2, (q / 6 % 5) * dsMoeda, 0.0f);
+		}
+	}
+
+	// Câmera em círculo pelo mapa, como o personagem andando
+	vec2 posicao(float t) {
+		return vec2(7.0f + 4.0f * sinf(t), 7.0f + 4.0f * cosf(t * 0.7f));
+	}
+
+	// Mapa fixo no mundo e a câmera no uniforme view: o mapa é um desenho só
+	// e nenhuma matriz depende da câmera
+	void quadro(int q) {
+		float t = q / 60.0f;
+		vec2 pos = posicao(t);
+		camera.setPosition(noMundo(pos));
+
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		g_glState.activeTexture(GL_TEXTURE0);
+		g_glState.useProgram(programa);
+		glUniformMatrix4fv(locView, 1, GL_FALSE, value_ptr(camera.getView()));
+
+		gravaEmParalelo(2, [&](int i) {
+			RenderCommandList &lista = listas[i];
+			lista.clear();
+			if (i == 0) {
+				mat4 model = mat4(1);
+				RenderCommand &c = lista.draw(RenderCommand::makeKey(0, 0, programa, texTiles), programa, vaoMapa,
+					texTiles, GL_TRIANGLES, 0, TILEMAP_WIDTH * TILEMAP_HEIGHT * VERTICES_TILE);
+				c.setModel(locModel, value_ptr(model));
+				c.setParam(locOffsetTex, 2, 0.0f, 0.0f);
+			} else {
+				// Os sprites do gravaSprites, já no mundo: x0 e y0 viram a origem
+				gravaSprites(lista, q, t, noMundo(pos), -TILE_W / 2.0f, 0.0f);
+			}
+		});
+		fila.add(listas[0]);
+		fila.add(listas[1]);
+		fila.submit();
+	}
+
+	// Como antes: cada tile é um desenho com a câmera descontada na model
+	void quadroPorTile(int q) {
+		float t = q / 60.0f;
+		vec2 pos = posicao(t);
+
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		g_glState.activeTexture(GL_TEXTURE0);
+		g_glState.useProgram(programa);
+		glUniformMatrix4fv(locView, 1, GL_FALSE, value_ptr(mat4(1)));
+
+		float x0 = LARGURA / 2.0f - (pos.x - pos.y) * TILE_W / 2.0f - TILE_W / 2.0f;
+		float y0 = ALTURA / 2.0f - (pos.x + pos.y) * TILE_H / 2.0f;
+		gravaEmParalelo(FATIAS_MAPA + 1, [&](int i) {
+			listas[i].clear();
+			if (i < FATIAS_MAPA)
+				gravaMapa(listas[i], x0, y0, i * TILEMAP_HEIGHT / FATIAS_MAPA, (i + 1) * TILEMAP_HEIGHT / FATIAS_MAPA);
+			else
+				gravaSprites(listas[i], q, t, vec2(LARGURA / 2.0f, ALTURA / 2.0f), x0, y0);
+		});
+		for (int i = 0; i <= FATIAS_MAPA; i++)
+			fila.add(listas[i]);
+		fila.submit();
+	}
+}
+
+// ============================================================================
+// Cenas do M4: parallax e sprites com o Sprite::Draw original
+// ============================================================================
+static const char *M4_VS = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+uniform mat4 uModel;
+uniform mat4 uProjection;
+out vec2 TexCoord;
+void main()
+{
+    gl_Position = uProjection * uModel * vec4(aPos, 1.0);
+    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
+}
+)";
+
+static const char *M4_FS = R"(
+#version 330 core
+in vec2 TexCoord;
+out vec4 FragColor;
+uniform sampler2D uTexture;
+void main()
+{
+    FragColor = texture(uTexture, TexCoord);
+}
+)";
+
+// Sprites do modo de estresse do M4 (x e y por instância, de dois buffers)
+static const char *M4_ESTRESSE_VS = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in float aX;
+layout (location = 3) in float aY;
+uniform mat4 uProjection;
+uniform vec2 uScale;
+out vec2 TexCoord;
+void main()
+{
+    vec2 p = vec2(aX, aY) + (aPos.xy + 0.5) * uScale;
+    gl_Position = uProjection * vec4(p, 0.0, 1.0);
+    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
+}
+)";
+
+namespace m4 {
+	const float LARGURA = 800, ALTURA = 600;
+	GLuint programa, vaoQuad;
+	GLuint camadas[5], texSprites[3];
+	mat4 projecao;
+
+	// Mesmo trabalho por chamada que o Sprite::Draw do M4
+	void desenhaSprite(GLuint tex, vec2 pos, vec2 escala) {
+		mat4 model = mat4(1.0f);
+		model = translate(model, vec3(pos, 0.0f));
+		model = translate(model, vec3(0.5f * escala.x, 0.5f * escala.y, 0.0f));
+		model = rotate(model, radians(0.0f), vec3(0.0f, 0.0f, 1.0f));
+		model = translate(model, vec3(-0.5f * escala.x, -0.5f * escala.y, 0.0f));
+		model = scale(model, vec3(escala.x, escala.y, 1.0f));
+		g_glState.useProgram(programa);
+		glUniformMatrix4fv(g_glState.uniformLocation(programa, "uModel"), 1, GL_FALSE, value_ptr(model));
+		glUniformMatrix4fv(g_glState.uniformLocation(programa, "uProjection"), 1, GL_FALSE, value_ptr(projecao));
+		g_glState.activeTexture(GL_TEXTURE0);
+		g_glState.bindTexture(GL_TEXTURE_2D, tex);
+		g_glState.bindVertexArray(vaoQuad);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+	void preparaComum() {
+		programa = compilaPrograma(M4_VS, M4_FS);
+		glUseProgram(programa);
+		glUniform1i(glGetUniformLocation(programa, "uTexture"), 0);
+		const GLfloat quad[20] = {
+			-0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
+			-0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+			0.5f, 0.5f, 0.0f, 1.0f, 1.0f,
+			0.5f, -0.5f, 0.0f, 1.0f, 0.0f
+		};
+		vaoQuad = criaQuad(quad);
+		projecao = ortho(0.0f, LARGURA, 0.0f, ALTURA, -1.0f, 1.0f);
+		texSprites[0] = carregaTextura("sprites/jare.png", 128, 128);
+		texSprites[1] = carregaTextura("sprites/fafare.png", 128, 128);
+		texSprites[2] = carregaTextura("sprites/raphare.png", 128, 128);
+		glDisable(GL_DEPTH_TEST);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	const float VELOCIDADES_PARALLAX[5] = { 10.0f, 20.0f, 40.0f, 80.0f, 160.0f };
+
+	// As camadas por ladrilhos opacos e translúcidos, como no M4
+	ParallaxRenderer parallax;
+
+	// Cria o renderer com as imagens "formato" 1..n (ou o xadrez no lugar)
+	void carregaCamadas(ParallaxRenderer &p, const char *formato, int n, int largura, int altura) {
+		vector<Layer> c(n);
+		for (int i = 0; i < n; i++) {
+			c[i].z = (float)i;
+			c[i].filename = NULL;
+			c[i].offsetx = c[i].offsety = 0.0f;
+			c[i].ratex = c[i].ratey = 0.0f;
+		}
+		p.create(c, largura, altura);
+		for (int i = 0; i < n; i++) {
+			char nome[64];
+			snprintf(nome, sizeof(nome), formato, i + 1);
+			int w = 0, h = 0, canais = 0;
+			unsigned char *dados = stbi_load((pastaAssets + nome).c_str(), &w, &h, &canais, 4);
+			if (dados) {
+				p.setLayerImage(i, dados, w, h, 4);
+				stbi_image_free(dados);
+			} else {
+				texturasSubstitutas++;
+				vector<unsigned char> pixels = xadrez(largura, altura);
+				p.setLayerImage(i, pixels.data(), largura, altura, 4);
+			}
+		}
+	}
+
+	// Mesmo deslocamento da versão com sprites, em larguras de tela
+	void desenhaCamadas(ParallaxRenderer &p, const float *velocidades, float largura, float t) {
+		for (int i = 0; i < p.getLayerCount(); i++)
+			p.getLayer(i).offsetx = fmodf(velocidades[i] * t, largura) / largura;
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(p.coversScreen() ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		p.draw();
+	}
+
+	void preparaParallax() {
+		preparaComum();
+		carregaCamadas(parallax, "sprites/parallax%d.png", 5, (int)LARGURA, (int)ALTURA);
+	}
+
+	void quadroParallax(int q) {
+		float t = q / 60.0f;
+		desenhaCamadas(parallax, VELOCIDADES_PARALLAX, LARGURA, t);
+		for (int i = 0; i < 4; i++)
+			desenhaSprite(texSprites[i % 3], vec2(100.0f + 150.0f * i, 150.0f + 20.0f * sinf(t * 3 + i)), vec2(100, 100));
+	}
+
+	void preparaParallaxSprites() {
+		preparaComum();
+		for (int i = 0; i < 5; i++) {
+			char nome[64];
+			snprintf(nome, sizeof(nome), "sprites/parallax%d.png", i + 1);
+			camadas[i] = carregaTextura(nome, 800, 600);
+		}
+	}
+
+	void quadroParallaxSprites(int q) {
+		const float *velocidades = VELOCIDADES_PARALLAX;
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		float t = q / 60.0f;
+		for (int i = 0; i < 5; i++) {
+			float offset = -fmodf(velocidades[i] * t, LARGURA);
+			float centroX = offset + LARGURA / 2.0f, centroY = ALTURA / 2.0f;
+			desenhaSprite(camadas[i], vec2(centroX, centroY), vec2(LARGURA, ALTURA));
+			desenhaSprite(camadas[i], vec2(centroX + LARGURA, centroY), vec2(LARGURA, ALTURA));
+		}
+		for (int i = 0; i < 4; i++)
+			desenhaSprite(texSprites[i % 3], vec2(100.0f + 150.0f * i, 150.0f + 20.0f * sinf(t * 3 + i)), vec2(100, 100));
+	}
+
+	// As seis camadas 1920x1080 de backgrounds/layers, a 1 (céu) sem alfa
+	const float FUNDO_LARGURA = 1920.0f, FUNDO_ALTURA = 1080.0f;
+	const int FUNDO_CAMADAS = 6;
+	const float VELOCIDADES_FUNDO[FUNDO_CAMADAS] = { 5.0f, 15.0f, 30.0f, 60.0f, 120.0f, 240.0f };
+	ParallaxRenderer fundo;
+	GLuint camadasFundo[FUNDO_CAMADAS];
+
+	void preparaFundo() {
+		preparaComum();
+		carregaCamadas(fundo, "backgrounds/layers/%d.png", FUNDO_CAMADAS, (int)FUNDO_LARGURA, (int)FUNDO_ALTURA);
+	}
+
+	void quadroFundo(int q) {
+		desenhaCamadas(fundo, VELOCIDADES_FUNDO, FUNDO_LARGURA, q / 60.0f);
+	}
+
+	// O mesmo fundo com duas cópias de sprite por camada, todas com blend
+	void preparaFundoSprites() {
+		preparaComum();
+		projecao = ortho(0.0f, FUNDO_LARGURA, 0.0f, FUNDO_ALTURA, -1.0f, 1.0f);
+		for (int i = 0; i < FUNDO_CAMADAS; i++) {
+			char nome[64];
+			snprintf(nome, sizeof(nome), "backgrounds/layers/%d.png", i + 1);
+			camadasFundo[i] = carregaTextura(nome, (int)FUNDO_LARGURA, (int)FUNDO_ALTURA);
+		}
+	}
+
+	void quadroFundoSprites(int q) {
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		float t = q / 60.0f;
+		for (int i = 0; i < FUNDO_CAMADAS; i++) {
+			float offset = -fmodf(VELOCIDADES_FUNDO[i] * t, FUNDO_LARGURA);
+			vec2 centro(offset + FUNDO_LARGURA / 2.0f, FUNDO_ALTURA / 2.0f);
+			desenhaSprite(camadasFundo[i], centro, vec2(FUNDO_LARGURA, FUNDO_ALTURA));
+			desenhaSprite(camadasFundo[i], centro + vec2(FUNDO_LARGURA, 0.0f), vec2(FUNDO_LARGURA, FUNDO_ALTURA));
+		}
+	}
+
+	// O --estresse do M4: sprites pulando sem parar pelo SpritePhysics, as
+	// alturas escritas no StreamBuffer e todos num desenho instanciado
+	const int N_PULANDO = 100000;
+	SpritePhysics multidao;
+	GLuint programaPulando, vaoPulando;
+
+	void preparaPulando() {
+		preparaComum();
+		multidao.clear();
+		vector<float> xs(N_PULANDO);
+		srand(1); // mesmos sprites do M4
+		for (int i = 0; i < N_PULANDO; i++) {
+			xs[i] = (float)(rand() % 792);
+			int corpo = multidao.add((float)(rand() % 500), 800.0f);
+			multidao.jump(corpo, (float)(rand() % 350));
+		}
+		programaPulando = compilaPrograma(M4_ESTRESSE_VS, M4_FS);
+		glUseProgram(programaPulando);
+		glUniform1i(glGetUniformLocation(programaPulando, "uTexture"), 0);
+		glUniform2f(glGetUniformLocation(programaPulando, "uScale"), 8.0f, 8.0f);
+		glUniformMatrix4fv(glGetUniformLocation(programaPulando, "uProjection"), 1, GL_FALSE, value_ptr(projecao));
+		const GLfloat quad[20] = {
+			-0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
+			-0.5f, -0.5f, 0.0f, 0.0f, 0.0f,
+			0.5f, 0.5f, 0.0f, 1.0f, 1.0f,
+			0.5f, -0.5f, 0.0f, 1.0f, 0.0f
+		};
+		vaoPulando = criaQuad(quad);
+		GLuint bufferX;
+		glGenBuffers(1, &bufferX);
+		glBindBuffer(GL_ARRAY_BUFFER, bufferX);
+		glBufferData(GL_ARRAY_BUFFER, N_PULANDO * sizeof(float), xs.data(), GL_STATIC_DRAW);
+		glBindVertexArray(vaoPulando);
+		GLuint buffers[2] = { bufferX, g_streamBuffer.getBuffer() };
+		for (int i = 0; i < 2; i++) {
+			glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+			glVertexAttribPointer(2 + i, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)0);
+			glEnableVertexAttribArray(2 + i);
+			glVertexAttribDivisor(2 + i, 1);
+		}
+		glBindVertexArray(0);
+	}
+
+	void quadroPulando(int) {
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		multidao.jumpGrounded(350.0f);
+		multidao.update(1.0f / 60.0f);
+		GLsizeiptr bytes = N_PULANDO * sizeof(float);
+		GLintptr deslocamento;
+		void *destino = g_streamBuffer.allocate(bytes, sizeof(float), deslocamento);
+		if (!destino) return;
+		memcpy(destino, multidao.getYs(), bytes);
+		g_streamBuffer.commit(deslocamento, bytes);
+		g_glState.useProgram(programaPulando);
+		g_glState.activeTexture(GL_TEXTURE0);
+		g_glState.bindTexture(GL_TEXTURE_2D, texSprites[1]);
+		g_glState.bindVertexArray(vaoPulando);
+		// As alturas do quadro ficam na região atual: o atributo segue o deslocamento
+		g_glState.bindBuffer(GL_ARRAY_BUFFER, g_streamBuffer.getBuffer());
+		glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void *)deslocamento);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, N_PULANDO);
+	}
+
+	const int N_SPRITES = 10000;
+
+	void preparaSprites() {
+		preparaComum();
+	}
+
+	// Os mesmos sprites gravados em listas por várias threads; a ordem de
+	// pintura continua a do índice, porque os sprites se sobrepõem
+	const int LISTAS_SPRITES = 8;
+	RenderCommandList listas[LISTAS_SPRITES];
+	GLint locModel;
+
+	void preparaSpritesListas() {
+		preparaComum();
+		glUseProgram(programa);
+		glUniformMatrix4fv(glGetUniformLocation(programa, "uProjection"), 1, GL_FALSE, value_ptr(projecao));
+		locModel = glGetUniformLocation(programa, "uModel");
+	}
+
+	void quadroSpritesListas(int q) {
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		g_glState.activeTexture(GL_TEXTURE0);
+		float t = q / 60.0f;
+		gravaEmParalelo(LISTAS_SPRITES, [&](int l) {
+			RenderCommandList &lista = listas[l];
+			lista.clear();
+			int fim = (l + 1) * N_SPRITES / LISTAS_SPRITES;
+			for (int i = l * N_SPRITES / LISTAS_SPRITES; i < fim; i++) {
+				float x = (i % 125) * 6.4f;
+				float y = (i / 125) * 7.5f + 10.0f * fabsf(sinf(t * 4 + i * 0.37f));
+				mat4 model = mat4(1.0f);
+				model = translate(model, vec3(x, y, 0.0f));
+				model = translate(model, vec3(16.0f, 16.0f, 0.0f));
+				model = rotate(model, radians(0.0f), vec3(0.0f, 0.0f, 1.0f));
+				model = translate(model, vec3(-16.0f, -16.0f, 0.0f));
+				model = scale(model, vec3(32.0f, 32.0f, 1.0f));
+				GLuint tex = texSprites[i % 3];
+				RenderCommand &c = lista.draw(RenderCommand::makeKey(0, i, programa, tex), programa, vaoQuad, tex,
+					GL_TRIANGLE_STRIP, 0, 4);
+				c.setModel(locModel, value_ptr(model));
+			}
+		});
+		for (int l = 0; l < LISTAS_SPRITES; l++)
+			fila.add(listas[l]);
+		fila.submit();
+	}
+
+	void quadroSprites(int q) {
+		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		float t = q / 60.0f;
+		for (int i = 0; i < N_SPRITES; i++) {
+			// Espalhados numa grade com pulos fora de fase
+			float x = (i % 125) * 6.4f;
+			float y = (i / 125) * 7.5f + 10.0f * fabsf(sinf(t * 4 + i * 0.37f));
+			desenhaSprite(texSprites[i % 3], vec2(x, y), vec2(32, 32));
+		}
+	}
+}
+
+// ============================================================================
+// Cena: HUD com muito texto (drawText_GL33 do Joguinho)
+// ============================================================================
+namespace hud {
+	const float LARGURA = 960, ALTURA = 720;
+	GLuint programa, vao;
+	GLint uniCor, uniProjecao;
+
+	void prepara() {
+		programa = compilaPrograma(
+			"#version 330 core\n"
+			"layout(location=0) in vec2 pos;\n"
+			"uniform mat4 projection;\n"
+			"void main(){ gl_Position = projection * vec4(pos,0,1); }\n",
+			"#version 330 core\n"
+			"uniform vec3 color;\n"
+			"out vec4 FragColor;\n"
+			"void main(){ FragColor = vec4(color,1); }\n");
+		uniCor = glGetUniformLocation(programa, "color");
+		uniProjecao = glGetUniformLocation(programa, "projection");
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, g_streamBuffer.getBuffer());
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 16, (void *)0);
+		glUseProgram(programa);
+		const float projecao[16] = {
+			2.0f / LARGURA, 0, 0, 0,
+			0, -2.0f / ALTURA, 0, 0,
+			0, 0, -1, 0,
+			-1, 1, 0, 1
+		};
+		glUniformMatrix4fv(uniProjecao, 1, GL_FALSE, projecao);
+		glDisable(GL_DEPTH_TEST);
+		glDisable(GL_BLEND);
+	}
+
+	void texto(float x, float y, const char *s, float r, float g, float b, float escala) {
+		static char buffer[99999];
+		int quads = stb_easy_font_print(0, 0, (char *)s, NULL, buffer, sizeof(buffer));
+		float *v = (float *)buffer;
+		for (int i = 0; i < quads * 4; i++) {
+			v[i * 4 + 0] = v[i * 4 + 0] * escala + x;
+			v[i * 4 + 1] = v[i * 4 + 1] * escala + y;
+		}
+		GLsizeiptr bytes = quads * 4 * 16;
+		GLintptr deslocamento;
+		void *destino = g_streamBuffer.allocate(bytes, 16, deslocamento);
+		if (!destino) return;
+		memcpy(destino, buffer, bytes);
+		g_streamBuffer.commit(deslocamento, bytes);
+		g_glState.bindVertexArray(vao);
+		g_glState.useProgram(programa);
+		glUniform3f(uniCor, r, g, b);
+		glDrawArrays(GL_QUADS, (GLint)(deslocamento / 16), quads * 4);
+	}
+
+	void quadro(int q) {
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		char linha[128];
+		for (int i = 0; i < 80; i++) {
+			snprintf(linha, sizeof(linha), "Pontos: %d  Vidas: %d  Tempo: %.1fs", q * 10 + i, 3 - i % 3, q / 60.0);
+			texto(10.0f + (i % 2) * 480.0f, 10.0f + (i / 2) * 17.5f, linha, 0.878f, 0.235f, 0.157f, 1.5f);
+		}
+	}
+}
+
+// ============================================================================
+
+struct Cena {
+	const char *nome;
+	int largura, altura;
+	void (*prepara)();
+	void (*quadro)(int q);
+};
+
+static const Cena CENAS[] = {
+	{ "joguinho_mapa", 960, 720, joguinho::prepara, joguinho::quadro },
+	{ "joguinho_mapa_por_tile", 960, 720, joguinho::prepara, joguinho::quadroPorTile },
+	{ "m4_parallax", 800, 600, m4::preparaParallax, m4::quadroParallax },
+	{ "m4_parallax_sprites", 800, 600, m4::preparaParallaxSprites, m4::quadroParallaxSprites },
+	{ "fundo_camadas", 1920, 1080, m4::preparaFundo, m4::quadroFundo },
+	{ "fundo_camadas_sprites", 1920, 1080, m4::preparaFundoSprites, m4::quadroFundoSprites },
+	{ "hud_texto", 960, 720, hud::prepara, hud::quadro },
+	{ "sprites_10k", 800, 600, m4::preparaSprites, m4::quadroSprites },
+	{ "sprites_100k_pulando", 800, 600, m4::preparaPulando, m4::quadroPulando },
+	{ "sprites_10k_listas", 800, 600, m4::preparaSpritesListas, m4::quadroSpritesListas },
+};
+
+struct Resultado {
+	double cpuMedia, cpuP50, cpuP95, gpuMedia, paredeMedia, gravacaoMedia;
+	GLCounters gl;   // soma dos quadros medidos
+	long long bytesStreaming, esperasStreaming;
+	bool temGpu;
+};
+
+static double percentil(vector<double> v, double p) {
+	size_t k = (size_t)(p * (v.size() - 1) + 0.5);
+	nth_element(v.begin(), v.begin() + k, v.end());
+	return v[k];
+}
+
+static Resultado rodaCena(const Cena &cena, int quadros) {
+	// FBO do tamanho da janela do programa original
+	GLuint fbo, cor, profundidade;
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glGenRenderbuffers(1, &cor);
+	glBindRenderbuffer(GL_RENDERBUFFER, cor);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, cena.largura, cena.altura);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, cor);
+	glGenRenderbuffers(1, &profundidade);
+	glBindRenderbuffer(GL_RENDERBUFFER, profundidade);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, cena.largura, cena.altura);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, profundidade);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		fprintf(stderr, "%s: FBO incompleto\n", cena.nome);
+	glViewport(0, 0, cena.largura, cena.altura);
+
+	cena.prepara();
+	g_glState.invalidate(); // a preparação mexe no GL direto
+	// Aquece: compilação tardia de shaders e alocação de buffers no driver
+	for (int q = 0; q < 10; q++) {
+		cena.quadro(q);
+		g_streamBuffer.endFrame();
+	}
+	glFinish();
+
+	bool temGpu = GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query;
+	vector<GLuint> consultas(temGpu ? quadros : 0);
+	if (temGpu) glGenQueries(quadros, consultas.data());
+
+	vector<double> cpu(quadros);
+	msGravacao = 0.0;
+	g_glInstrumentation.endFrame();
+	GLCounters antes = g_glInstrumentation.total();
+	long long bytesAntes = g_streamBuffer.getTotalBytes(), esperasAntes = g_streamBuffer.getWaits();
+	Relogio::time_point inicio = Relogio::now();
+	for (int q = 0; q < quadros; q++) {
+		Relogio::time_point t0 = Relogio::now();
+		if (temGpu) glBeginQuery(GL_TIME_ELAPSED, consultas[q]);
+		cena.quadro(q);
+		g_streamBuffer.endFrame();
+		if (temGpu) glEndQuery(GL_TIME_ELAPSED);
+		glFlush(); // o que a troca de buffers faria na janela
+		cpu[q] = msDesde(t0);
+		g_glInstrumentation.endFrame();
+	}
+	glFinish();
+	double parede = msDesde(inicio);
+
+	Resultado r;
+	r.temGpu = temGpu;
+	r.gpuMedia = 0.0;
+	if (temGpu) {
+		for (int q = 0; q < quadros; q++) {
+			GLuint64 ns = 0;
+			glGetQueryObjectui64v(consultas[q], GL_QUERY_RESULT, &ns);
+			r.gpuMedia += ns * 1e-6;
+		}
+		r.gpuMedia /= quadros;
+		glDeleteQueries(quadros, consultas.data());
+	}
+	double soma = 0.0;
+	for (int q = 0; q < quadros; q++) soma += cpu[q];
+	r.cpuMedia = soma / quadros;
+	r.cpuP50 = percentil(cpu, 0.50);
+	r.cpuP95 = percentil(cpu, 0.95);
+	r.paredeMedia = parede / quadros;
+	r.gravacaoMedia = msGravacao / quadros;
+	long long *gl = &r.gl.drawCalls;
+	const long long *depois = &g_glInstrumentation.total().drawCalls, *inicial = &antes.drawCalls;
+	for (size_t i = 0; i < sizeof(GLCounters) / sizeof(long long); i++)
+		gl[i] = depois[i] - inicial[i];
+	r.bytesStreaming = g_streamBuffer.getTotalBytes() - bytesAntes;
+	r.esperasStreaming = g_streamBuffer.getWaits() - esperasAntes;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glDeleteRenderbuffers(1, &cor);
+	glDeleteRenderbuffers(1, &profundidade);
+	glDeleteFramebuffers(1, &fbo);
+	return r;
+}
+
+int main(int argc, char **argv)
+{
+	int quadros = argc > 1 ? max(1, atoi(argv[1])) : 300;
+	string filtro = argc > 2 ? argv[2] : "todas";
+	if (argc > 3) pastaAssets = argv[3];
+	int threads = argc > 4 ? atoi(argv[4]) : 0;
+
+	if (!criaContexto()) return 1;
+	g_glInstrumentation.install();
+	g_streamBuffer.create(1 << 20);
+	JobSystem sistema(threads > 0 ? threads - 1 : -1);
+	jobs = &sistema;
+
+	printf("{\n");
+	printf("  \"renderer\": \"%s\",\n", (const char *)glGetString(GL_RENDERER));
+	printf("  \"version\": \"%s\",\n", (const char *)glGetString(GL_VERSION));
+	printf("  \"streaming\": \"%s\",\n", g_streamBuffer.isPersistent() ? "persistente" : "glBufferSubData");
+	printf("  \"quadros\": %d,\n", quadros);
+	printf("  \"threads_gravacao\": %d,\n", sistema.getThreads());
+	printf("  \"cenas\": [");
+	int rodadas = 0;
+	for (const Cena &cena : CENAS) {
+		if (filtro != "todas" && filtro != cena.nome) continue;
+		texturasSubstitutas = 0;
+		fprintf(stderr, "%s...\n", cena.nome);
+		Resultado r = rodaCena(cena, quadros);
+		printf("%s\n    {\"nome\": \"%s\", \"largura\": %d, \"altura\": %d,\n", rodadas ? "," : "", cena.nome, cena.largura, cena.altura);
+		printf("     \"cpu_ms\": {\"media\": %.4f, \"p50\": %.4f, \"p95\": %.4f}, \"parede_ms\": %.4f, \"gravacao_ms\": %.4f,\n",
+			r.cpuMedia, r.cpuP50, r.cpuP95, r.paredeMedia, r.gravacaoMedia);
+		if (r.temGpu) printf("     \"gpu_ms\": %.4f,\n", r.gpuMedia);
+		else printf("     \"gpu_ms\": null,\n");
+		// Chamadas OpenGL por quadro (GLInstrumentation)
+		const GLCounters &c = r.gl;
+		double n = quadros;
+		printf("     \"por_quadro\": {\"desenhos\": %.1f, \"vertices\": %.1f, \"trocas_programa\": %.1f, \"binds_textura\": %.1f,\n",
+			c.drawCalls / n, c.vertices / n, c.programSwitches / n, c.textureBinds / n);
+		printf("       \"binds_vao\": %.1f, \"uniformes\": %.1f, \"consultas_uniforme\": %.1f, \"envios_buffer\": %.1f,\n",
+			c.vaoBinds / n, c.uniformUploads / n, c.uniformLocationQueries / n, c.bufferUploads / n);
+		printf("       \"bytes_buffer\": %.0f, \"estado_redundante\": %.1f, \"bytes_streaming\": %.0f,\n",
+			c.bufferBytes / n, c.redundantStateSets / n, r.bytesStreaming / n);
+		printf("       \"esperas_streaming\": %lld},\n", r.esperasStreaming);
+		printf("     \"texturas_substitutas\": %d}", texturasSubstitutas);
+		rodadas++;
+	}
+	printf("\n  ]\n}\n");
+
+	liberaContexto();
+	if (rodadas == 0) {
+		fprintf(stderr, "Cena desconhecida: %s\n", filtro.c_str());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ * BenchSpritePhysics.cpp
+ *
+ * Benchmark do pulo em lote (Common/SpritePhysics) contra o laço de objetos
+ * do M4, em que cada Sprite guarda velocidade, gravidade e chão entre os
+ * seus outros campos e chama UpdatePhysics sozinho.
+ *
+ * Uso:
+ *   ./BenchSpritePhysics [sprites=100000] [passos=600] [semente=1]
+ *
+ * Todos os sprites pulam sem parar (quem pousa pula de novo), a 60 passos
+ * por segundo, em 5 rodadas de "passos" passos. Mede o tempo por passo da
+ * melhor rodada dos objetos, dos vetores SoA um corpo por vez e dos vetores
+ * SoA com SIMD, e confere se as três versões chegam às mesmas alturas, bit
+ * a bit (retorna 1 se houver diferença).
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SpritePhysics.h"
+#include "BenchMaze.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+static const float GRAVIDADE = 800.0f;
+static const float VELOCIDADE_PULO = 350.0f;
+static const float DT = 1.0f / 60.0f;
+static const int RODADAS = 5;
+
+// Os campos do Sprite do M4, na mesma ordem (sem o GL)
+struct SpriteObjeto {
+	float position[2];
+	float scale[2];
+	unsigned shaderID, VAO, textureID;
+	float rotation;
+	bool facingRight;
+	bool isJumping;
+	float velocityY;
+	float gravity;
+	float initialJumpV;
+	float groundY;
+
+	void andaCima() {
+		if (!isJumping) {
+			isJumping = true;
+			velocityY = initialJumpV;
+		}
+	}
+
+	void UpdatePhysics(float deltaTime) {
+		if (isJumping) {
+			position[1] += velocityY * deltaTime;
+			velocityY -= gravity * deltaTime;
+			if (position[1] <= groundY) {
+				position[1] = groundY;
+				isJumping = false;
+				velocityY = 0.0f;
+			}
+		}
+	}
+};
+
+static bool mesmoFloat(float a, float b) {
+	return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int main(int argc, char **argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 100000;
+	int passos = argc > 2 ? atoi(argv[2]) : 600;
+	uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+	int erros = 0;
+
+	// Chão entre 0 e 500 px e um primeiro pulo de força variada, para que
+	// os sprites não pousem todos no mesmo passo
+	BenchRng rng(semente);
+	vector<SpriteObjeto> objetos(n);
+	SpritePhysics escalar, simd;
+	for (int i = 0; i < n; i++) {
+		float chao = (float)rng.range(500);
+		float pulo = (float)rng.range((int)VELOCIDADE_PULO);
+		SpriteObjeto &o = objetos[i];
+		memset(&o, 0, sizeof(o));
+		o.position[0] = (float)rng.range(800);
+		o.position[1] = o.groundY = chao;
+		o.scale[0] = o.scale[1] = 8.0f;
+		o.facingRight = true;
+		o.gravity = GRAVIDADE;
+		o.initialJumpV = pulo;
+		o.andaCima();
+		o.initialJumpV = VELOCIDADE_PULO;
+		escalar.jump(escalar.add(chao, GRAVIDADE), pulo);
+		simd.jump(simd.add(chao, GRAVIDADE), pulo);
+	}
+
+#if defined(__AVX__)
+	const char *conjunto = "AVX";
+#elif defined(__SSE2__) || defined(_M_X64)
+	const char *conjunto = "SSE2";
+#else
+	const char *conjunto = "sem SIMD";
+#endif
+	printf("%d sprites, %d rodadas de %d passos de 1/60 s\n", n, RODADAS, passos);
+
+	// Rodadas alternadas, ficando com a melhor de cada versão (a máquina
+	// pode estar ocupada com outra coisa durante uma delas)
+	double msObjetos = 1e30, msEscalar = 1e30, msSimd = 1e30;
+	for (int r = 0; r < RODADAS; r++) {
+		Relogio::time_point t0 = Relogio::now();
+		for (int p = 0; p < passos; p++) {
+			for (int i = 0; i < n; i++) {
+				objetos[i].andaCima();
+				objetos[i].UpdatePhysics(DT);
+			}
+		}
+		msObjetos = min(msObjetos, msDesde(t0) / passos);
+
+		t0 = Relogio::now();
+		for (int p = 0; p < passos; p++) {
+			escalar.jumpGrounded(VELOCIDADE_PULO);
+			escalar.updateScalar(DT);
+		}
+		msEscalar = min(msEscalar, msDesde(t0) / passos);
+
+		t0 = Relogio::now();
+		for (int p = 0; p < passos; p++) {
+			simd.jumpGrounded(VELOCIDADE_PULO);
+			simd.update(DT);
+		}
+		msSimd = min(msSimd, msDesde(t0) / passos);
+	}
+
+	printf("Objetos (um por vez): %.3f ms por passo, %.1f Msprites/s\n", msObjetos, n / msObjetos / 1000.0);
+	printf("SoA escalar:          %.3f ms por passo, %.1f Msprites/s (%.1fx)\n",
+		msEscalar, n / msEscalar / 1000.0, msObjetos / msEscalar);
+	printf("SoA %-17s %.3f ms por passo, %.1f Msprites/s (%.1fx)\n",
+		(string(conjunto) + ":").c_str(), msSimd, n / msSimd / 1000.0, msObjetos / msSimd);
+
+	int noAr = 0;
+	for (int i = 0; i < n; i++) {
+		noAr += simd.isJumping(i);
+		if (!mesmoFloat(objetos[i].position[1], escalar.getY(i)) || !mesmoFloat(escalar.getY(i), simd.getY(i)) ||
+			objetos[i].isJumping != escalar.isJumping(i) || escalar.isJumping(i) != simd.isJumping(i)) {
+			if (erros < 5)
+				printf("ERRO: sprite %d difere (objeto %.6f, escalar %.6f, SIMD %.6f)\n",
+					i, objetos[i].position[1], escalar.getY(i), simd.getY(i));
+			erros++;
+		}
+	}
+	if (erros) {
+		printf("ERRO: %d sprites divergentes\n", erros);
+		return 1;
+	}
+	printf("As três versões concordam em todos os sprites (%d no ar no fim)\n", noAr);
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * BenchWalkGrid.cpp
+ *
+ * Benchmark da grade de bits (Common/WalkGrid) contra a mesma grade guardada
+ * como matriz de int, do jeito que o Joguinho guardava as barreiras.
+ *
+ * Uso:
+ *   ./BenchWalkGrid [tamanho=2048] [consultas=20000] [semente=1]
+ *
+ * Mede memória, "8 vizinhos livres" na grade inteira, linha de visão e
+ * preenchimento de região, e confere se as duas versões dão o mesmo
+ * resultado (retorna 1 se houver diferença).
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <deque>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "WalkGrid.h"
+#include "BenchMaze.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+static double msDesde(Relogio::time_point t0) {
+	return chrono::duration<double, milli>(Relogio::now() - t0).count();
+}
+
+// Grade de referência: um int por célula (1 = bloqueado, como barreiras.txt)
+struct GradeInt {
+	int w, h;
+	vector<int> c;
+	bool livre(int x, int y) const {
+		return x >= 0 && y >= 0 && x < w && y < h && c[(size_t)y * w + x] == 0;
+	}
+};
+
+static bool vizinhosLivresInt(const GradeInt &g, int x, int y) {
+	for (int dy = -1; dy <= 1; dy++)
+		for (int dx = -1; dx <= 1; dx++)
+			if ((dx || dy) && !g.livre(x + dx, y + dy)) return false;
+	return true;
+}
+
+static bool visaoInt(const GradeInt &g, int x0, int y0, int x1, int y1) {
+	int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+	int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+	int err = dx + dy;
+	while (true) {
+		if (!g.livre(x0, y0)) return false;
+		if (x0 == x1 && y0 == y1) return true;
+		int e2 = 2 * err;
+		if (e2 >= dy) { err += dy; x0 += sx; }
+		if (e2 <= dx) { err += dx; y0 += sy; }
+	}
+}
+
+static size_t preencheInt(const GradeInt &g, int x, int y, vector<char> &visto) {
+	visto.assign(g.c.size(), 0);
+	deque<int> fila;
+	fila.push_back(y * g.w + x);
+	visto[(size_t)y * g.w + x] = 1;
+	size_t total = 0;
+	while (!fila.empty()) {
+		int i = fila.front();
+		fila.pop_front();
+		total++;
+		int cx = i % g.w, cy = i / g.w;
+		for (int dy = -1; dy <= 1; dy++)
+			for (int dx = -1; dx <= 1; dx++) {
+				int nx = cx + dx, ny = cy + dy;
+				if (!g.livre(nx, ny)) continue;
+				int ni = ny * g.w + nx;
+				if (visto[ni]) continue;
+				visto[ni] = 1;
+				fila.push_back(ni);
+			}
+	}
+	return total;
+}
+
+int main(int argc, char **argv)
+{
+	int tamanho = argc > 1 ? atoi(argv[1]) : 2048;
+	int consultas = argc > 2 ? atoi(argv[2]) : 20000;
+	uint64_t semente = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+	int erros = 0;
+
+	// Labirinto com bastante abertura para ter corredores largos e áreas livres
+	WalkGrid grade;
+	generateMaze(grade, tamanho, tamanho, semente, 400);
+	GradeInt ref;
+	ref.w = ref.h = tamanho;
+	ref.c.resize((size_t)tamanho * tamanho);
+	for (int y = 0; y < tamanho; y++)
+		for (int x = 0; x < tamanho; x++)
+			ref.c[(size_t)y * tamanho + x] = grade.isWalkable(x, y) ? 0 : 1;
+
+	size_t bytesInt = ref.c.size() * sizeof(int);
+	printf("Grade %dx%d: int %zu bytes, bits %zu bytes (%.1fx menor)\n",
+		tamanho, tamanho, bytesInt, grade.memoryBytes(), (double)bytesInt / grade.memoryBytes());
+
+	// --- 8 vizinhos livres em todas as células
+	Relogio::time_point t0 = Relogio::now();
+	long livresInt = 0;
+	for (int y = 0; y < tamanho; y++)
+		for (int x = 0; x < tamanho; x++)
+			livresInt += vizinhosLivresInt(ref, x, y);
+	double msInt = msDesde(t0);
+
+	vector<uint64_t> mascara(grade.getStride());
+	long livresBits = 0;
+	t0 = Relogio::now();
+	for (int y = 0; y < tamanho; y++) {
+		grade.neighbourMaskRow(y, mascara.data());
+		for (int i = 0; i < grade.getStride(); i++)
+			livresBits += walkgrid_popcount(mascara[i]);
+	}
+	double msBits = msDesde(t0);
+	printf("8 vizinhos livres: int %.2f ms, bits %.2f ms (%.1fx), %ld celulas\n",
+		msInt, msBits, msInt / msBits, livresBits);
+	if (livresInt != livresBits) {
+		printf("ERRO: contagem de vizinhanca livre difere (%ld contra %ld)\n", livresInt, livresBits);
+		erros++;
+	}
+	for (int k = 0; k < 1000; k++) {
+		int x = rand() % tamanho, y = rand() % tamanho;
+		if (grade.allNeighboursWalkable(x, y) != vizinhosLivresInt(ref, x, y)) erros++;
+	}
+
+	// --- Linha de visão entre pares de células livres
+	BenchRng rng(semente * 131);
+	vector<GridPoint> a(consultas), b(consultas);
+	for (int i = 0; i < consultas; i++) {
+		a[i] = randomWalkable(grade, rng);
+		// metade das consultas na mesma linha, que é o caso mais comum no jogo
+		b[i] = randomWalkable(grade, rng);
+		if (i & 1) {
+			b[i].y = a[i].y;
+			b[i].x = rng.range(tamanho);
+		}
+	}
+	vector<char> visInt(consultas), visBits(consultas);
+	t0 = Relogio::now();
+	for (int i = 0; i < consultas; i++) visInt[i] = visaoInt(ref, a[i].x, a[i].y, b[i].x, b[i].y);
+	msInt = msDesde(t0);
+	t0 = Relogio::now();
+	for (int i = 0; i < consultas; i++) visBits[i] = grade.lineOfSight(a[i].x, a[i].y, b[i].x, b[i].y);
+	msBits = msDesde(t0);
+	int divergentes = 0;
+	for (int i = 0; i < consultas; i++) divergentes += visInt[i] != visBits[i];
+	printf("Linha de visao: int %.3f us, bits %.3f us por consulta (%.1fx)\n",
+		msInt * 1000.0 / consultas, msBits * 1000.0 / consultas, msInt / msBits);
+	if (divergentes) {
+		printf("ERRO: %d consultas de linha de visao divergentes\n", divergentes);
+		erros++;
+	}
+
+	// --- Preenchimento da região alcançável
+	GridPoint s = randomWalkable(grade, rng);
+	vector<char> visto;
+	t0 = Relogio::now();
+	size_t regiaoInt = preencheInt(ref, s.x, s.y, visto);
+	msInt = msDesde(t0);
+	WalkGrid regiao;
+	t0 = Relogio::now();
+	size_t regiaoBits = grade.floodFill(s.x, s.y, regiao);
+	msBits = msDesde(t0);
+	printf("Preenchimento: int %.2f ms, bits %.2f ms (%.1fx), %zu celulas\n",
+		msInt, msBits, msInt / msBits, regiaoBits);
+	if (regiaoInt != regiaoBits || regiao.countWalkable() != regiaoBits) {
+		printf("ERRO: regiao difere (%zu contra %zu)\n", regiaoInt, regiaoBits);
+		erros++;
+	}
+	for (int y = 0; y < tamanho && !erros; y++)
+		for (int x = 0; x < tamanho; x++)
+			if ((visto[(size_t)y * tamanho + x] != 0) != regiao.isWalkable(x, y)) {
+				printf("ERRO: celula (%d,%d) da regiao difere\n", x, y);
+				erros++;
+				break;
+			}
+
+	if (erros) return 1;
+	printf("Grade de bits e grade de int concordam em todas as consultas\n");
+	return 0;
+}
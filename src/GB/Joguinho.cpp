@@ -30,9 +30,14 @@
 #include <fstream>
 #include <sstream>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <algorithm>
+#include <filesystem>
 
 using namespace std;
 
@@ -42,6 +47,18 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Ritmo de quadros (vsync e limitador)
+#include "FramePacing.h"
+#include "gl_utils.h" // tempos de quadro
+#include "Profiler.h"
+#include "GLInstrumentation.h"
+#include "GLStateCache.h"
+#include "StreamBuffer.h"
+#include "RenderCommands.h"
+#include "JobSystem.h"
+#include "TripleBuffer.h"
+#include "Camera.h"
+
 // STB_IMAGE
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -53,8 +70,10 @@ using namespace std;
 
 using namespace glm;
 
- #define TILEMAP_WIDTH 15
- #define TILEMAP_HEIGHT 15
+// Lógica do jogo, sem OpenGL (também usada pelo JoguinhoHeadless)
+#include "Simulacao.h"
+#include "Replay.h"
+#include "Salvamento.h"
 
 struct Sprite
 {
@@ -87,12 +106,9 @@ struct Personagem {
 	vec3 position;
 	vec3 dimensions;
 	float ds, dt;
-	int direcao; // 0=N, 1=NE, 2=L, 3=SE, 4=S, 5=SO, 6=O, 7=NO
-	int frame;
 	int nDirecoes;
 	int nFrames;
-	bool andando = false; // novo campo para controle de movimento
-	int grupoAnimacao = 0; // 0: frames baixos, 1: frames altos
+	// direção e frame atuais vêm de sim.migore
 };
 
 // Protótipo da função de callback de teclado
@@ -102,17 +118,22 @@ void key_callback(GLFWwindow *window, int key, int scancode, int action, int mod
 int setupShader();
 int setupSprite(int nAnimations, int nFrames, float &ds, float &dt);
 int setupTile(int nTiles, float &ds, float &dt);
-int loadTexture(string filePath, int &width, int &height);
-void desenharMapa(GLuint shaderID);
-void desenharPersonagem(GLuint shaderID);
-void leMapa(const std::string& path, int map[][TILEMAP_WIDTH]);
-void imprimeMapa(int map[][TILEMAP_WIDTH]);
-void desenharMoedas(GLuint shaderID);
-void verificaEventoMapa(int posx, int posy);
-void liberarTileComAnimacao(int x, int y, bool &evento_ativado);
-void desenharGreatJareSpirit(GLuint shaderID);
-void coletarMoeda(int indice);
-void drawText_GL33(float x, float y, const char* text, float r, float g, float b, float scale);
+struct ImagemDecodificada;
+void decodificaImagem(ImagemDecodificada &img);
+int loadTexture(ImagemDecodificada &img, int &width, int &height);
+void criaMapaEstatico();
+void atualizaMapaEstatico(const int mapa[][TILEMAP_HEIGHT]);
+void gravarMapa(RenderCommandList &lista, GLuint shaderID);
+void gravarPersonagem(RenderCommandList &lista, GLuint shaderID);
+void imprimeMapa(int map[][TILEMAP_HEIGHT]);
+void imprimeBarreiras();
+void gravarMoedas(RenderCommandList &lista, GLuint shaderID);
+void posicionaGreatJareSpirit();
+void gravarGreatJareSpirit(RenderCommandList &lista, GLuint shaderID);
+void gravarHud(RenderCommandList &lista, GLuint shaderID, bool fimDeJogo);
+void preparaTexto();
+void gravarTexto(RenderCommandList &lista, float x, float y, const char* text, float r, float g, float b, float scale);
+int direcaoDaTecla(int key);
 
 // Dimensões da janela (pode ser alterado em tempo de execução)
 const GLuint WIDTH = 960, HEIGHT = 720;
@@ -124,11 +145,12 @@ const GLchar *vertexShaderSource = R"(
  layout (location = 1) in vec2 texc;
  out vec2 tex_coord;
  uniform mat4 model;
+ uniform mat4 view;
  uniform mat4 projection;
  void main()
  {
 	tex_coord = vec2(texc.s, 1.0 - texc.t);
-	gl_Position = projection * model * vec4(position, 1.0);
+	gl_Position = projection * view * model * vec4(position, 1.0);
  }
  )";
 
@@ -148,134 +170,473 @@ const GLchar *fragmentShaderSource = R"(
 
 
 
-int map[TILEMAP_WIDTH][TILEMAP_HEIGHT]; // Mapa principal
-int barreiras[TILEMAP_WIDTH][TILEMAP_HEIGHT]; // Mapa das barreiras
+Simulacao sim; // Estado e regras do jogo (Simulacao.h)
 Personagem migore; // Personagem principal
 Sprite moedas;  // Sprite das moedas
 Sprite greatJareSpirit; // Sprite do great_jare_spirit
 Sprite topBar; // Sprite da barra superior
-bool greatJareSpirit_ativo = false; // Controla se o sprite será exibido
-double pontuacao = 0;
-int vidas = 5;
-
-// INICIALIZA OS CONTROLES DE EVENTOS
-static bool evento_38_ativado = false;
-static bool evento_210_ativado = false;
-static bool evento_45_ativado = false;
-static bool evento_512_ativado = false;
-static bool evento_82_ativado = false;
-static bool evento_83_ativado = false;
-static bool evento_71_ativado = false;
-static bool evento_41_ativado = false;
-static bool evento_118_ativado = false;
-static bool evento_1312_ativado = false;
-static bool evento_jare_capturado = false;
-
-// --- Controle de animação de troca de tile ---
-struct AnimacaoTile {
-    bool ativa = true;
-    int x = 0, y = 0;
-    int tileInicial = 0;
-    int tileFinal = 0;
-    double tempo = 0.0;
-    double tempoTotal = 1.0; // duração total da animação em segundos
+
+vector <Tile> tileset;
+
+// --- IMAGENS ---
+// Decodificadas por tarefas do JobSystem enquanto a janela é criada;
+// loadTexture só envia os pixels prontos para o OpenGL
+struct ImagemDecodificada {
+	string caminho;
+	unsigned char *data;
+	int width, height, nrChannels;
 };
-static std::vector<AnimacaoTile> animacoesTile;
-
-void animarTrocaTile(int x, int y, int tileFinal) {
-    AnimacaoTile novaAnim;
-    novaAnim.x = x;
-    novaAnim.y = y;
-    novaAnim.tileInicial = map[x][y];
-    novaAnim.tileFinal = tileFinal;
-    novaAnim.tempo = 0.0;
-    novaAnim.tempoTotal = 1.0;
-    novaAnim.ativa = true;
-    animacoesTile.push_back(novaAnim);
+enum { IMG_TILESET, IMG_MIGORE, IMG_MOEDAS, IMG_JARE, IMG_TOPBAR, NUM_IMAGENS };
+const char *CAMINHOS_IMAGENS[NUM_IMAGENS] = {
+	"../assets/tilesets/tilesetIso.png",
+	"../assets/tilesets/migore.png",
+	"../assets/sprites/moedas.png",
+	"../assets/sprites/great_jare_spirit.png",
+	"../assets/sprites/top_bar.png"
+};
+
+// --- LISTAS DE COMANDOS ---
+// O quadro é gravado em listas (RenderCommands.h) por várias tarefas ao
+// mesmo tempo; só o envio, já ordenado, acontece na thread do OpenGL. As
+// camadas garantem a ordem de pintura: mapa, sprites e HUD por cima.
+enum { CAMADA_MAPA, CAMADA_SPRITES, CAMADA_HUD };
+enum { LISTA_MAPA, LISTA_SPRITES, LISTA_HUD, LISTAS_QUADRO };
+// Locais de uniforme consultados no início: quem grava não chama o GL. O
+// HUD usa outro programa com os mesmos shaders e a view identidade, para
+// não andar com a câmera.
+GLint locModel = -1, locOffsetTex = -1, locView = -1;
+GLuint hudShaderID = 0;
+GLint locModelHud = -1, locOffsetTexHud = -1;
+GLuint textoShader = 0, textoVAO = 0;
+GLint textoCor = -1;
+
+// --- THREAD DA SIMULAÇÃO ---
+// A simulação roda numa thread própria, em passos de Simulacao::PASSO
+// segundos no relógio de parede, e a cada passo publica um retrato
+// (RetratoDesenho) num TripleBuffer. O desenho pega sempre o retrato
+// completo mais recente e nunca lê "sim": um quadro lento ou uma espera
+// do driver não atrasa a entrada nem os passos, e um passo demorado não
+// segura o quadro. Teclas, reinício e salvamentos chegam à simulação por
+// uma fila de comandos; tudo que mexe em "sim" roda na thread dela.
+const int MAX_PASSOS_SEGUIDOS = 8; // depois de uma travada, descarta o atraso em vez de tentar alcançá-lo
+
+// Um retrato e o que o desenho precisa para interpolar e medir a latência
+struct QuadroSimulado {
+	RetratoDesenho estado;
+	vec2 posAnterior;             // posição visual no passo anterior
+	double tempoAnterior;         // tempo de jogo no passo anterior
+	double relogio;               // horário (glfwGetTime) do passo que gerou o retrato
+	long long passosComEntrada;   // passos iniciados por tecla até aqui
+	double tempoEntradaPasso;     // horário da tecla do último deles
+};
+TripleBuffer<QuadroSimulado> retratos;
+
+enum TipoComando { COMANDO_ENTRADA, COMANDO_REINICIA, COMANDO_SALVA, COMANDO_CARREGA };
+struct ComandoSimulacao {
+	TipoComando tipo;
+	int direcao, acao;  // COMANDO_ENTRADA
+	double tempo;
+};
+std::mutex travaComandos;
+std::condition_variable sinalComandos;
+vector<ComandoSimulacao> comandos;
+bool encerrarSimulacao = false;
+
+void enviaComando(TipoComando tipo, int direcao = 0, int acao = 0, double tempo = 0.0) {
+	ComandoSimulacao c;
+	c.tipo = tipo;
+	c.direcao = direcao;
+	c.acao = acao;
+	c.tempo = tempo;
+	{
+		std::lock_guard<std::mutex> l(travaComandos);
+		comandos.push_back(c);
+	}
+	sinalComandos.notify_one();
 }
 
-// Struct para representar uma moeda no mapa
-struct Moeda {
-    int x, y;
-    bool ativa;
+// Latência da tecla até o primeiro quadro apresentado com o passo
+struct MedidorLatencia {
+	int amostras = 0;
+	double soma = 0.0, maxima = 0.0, ultima = 0.0;
+	void registra(double s) {
+		amostras++;
+		soma += s;
+		ultima = s;
+		if (s > maxima) maxima = s;
+	}
+	double media() const {
+		return amostras ? soma / amostras : 0.0;
+	}
 };
+MedidorLatencia latenciaEntrada;
+double latenciaAguardaTroca = -1.0;  // tecla cujo passo já foi desenhado, aguardando a troca de buffers
+long long passosComEntradaVistos = 0;
+MedidorLatencia tempoPasso;          // custo de cada passo, na thread da simulação
+
+// Lado da simulação: posição e tempo do passo anterior, para interpolar
+vec2 posAnterior;
+double tempoAnterior = 0.0;
+long long passosComEntrada = 0;
+double tempoEntradaPasso = -1.0;
+
+// Lado do desenho: o retrato do quadro e o estado interpolado entre os dois
+// últimos passos
+const RetratoDesenho *retrato = NULL;
+vec2 posRender;
+double tempoRender = 0.0;
+
+// --- CÂMERA ---
+// O mundo fica em pixels de mundo, com o canto de cima do losango do tile
+// (0, 0) na origem; a câmera (Camera.h) persegue o personagem e leva o
+// deslocamento para o uniforme "view", então nenhuma matriz model depende
+// dela. Treme quando o personagem cai na lava; "=" e "-" mudam o zoom.
+const float TILE_LARGURA = 100.0f, TILE_ALTURA = 50.0f;
+const float CAMERA_MEIA_VIDA = 0.06f;  // segundos para andar metade do caminho até o personagem
+const float TREMIDA_LAVA = 10.0f;      // pixels de tela
+const float ZOOM_MINIMO = 0.5f, ZOOM_MAXIMO = 2.0f;
+Camera camera;
+double relogioCamera = 0.0;
+bool lavaNaTela = false;
+
+// Ponto (x, y) da grade isométrica em pixels de mundo
+vec2 noMundo(vec2 p) {
+	return vec2((p.x - p.y) * TILE_LARGURA / 2.0f, (p.x + p.y) * TILE_ALTURA / 2.0f);
+}
 
-// Array estático com as posições das moedas
-Moeda moedasMapa[] = {
-    {4, 0, false},
-    {6, 2, true},
-    {7, 13, true},
-	{13, 11, false}
+// --- MAPA ESTÁTICO ---
+// Os losangos de todos os tiles ficam num VBO só, em coordenadas de mundo,
+// e o mapa inteiro sai num desenho. O buffer é montado uma vez; quando um
+// tile troca (moeda pega, passagem aberta, piscada da troca), só os seus
+// vértices são reenviados.
+const int VERTICES_TILE = 6;  // dois triângulos
+struct MapaEstatico {
+	GLuint VAO = 0, VBO = 0;
+	int mapa[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+	bool montado = false;
 };
-const int NUM_MOEDAS = sizeof(moedasMapa) / sizeof(Moeda);
+MapaEstatico mapaEstatico;
+mat4 modelGreatJareSpirit;  // parado no mundo: montada uma vez
+
+vec2 posVisualSim() {
+	return vec2(sim.visualX(), sim.visualY());
+}
 
+// --- REPLAY ---
+// Toda sessão grava as entradas (padrão: ultima_sessao.jrp). Com --replay, as
+// entradas vêm do arquivo em vez do teclado, no ritmo normal do jogo.
+GravadorReplay gravador;
+ReprodutorReplay replay;
+std::atomic<bool> reproduzindo(false); // a simulação desliga no fim do replay
+bool sessaoDeReplay = false; // começou por --replay: continua valendo depois do fim dele
+string caminhoGravacao = "ultima_sessao.jrp";
+string caminhoPerfil;  // --perfil arquivo.json: trace do chrome://tracing na saída
+bool contarChamadasGL = false; // --contadores-gl: conta as chamadas OpenGL de cada quadro
+double duracaoPasso = Simulacao::DURACAO_PASSO_TILE_PADRAO; // --duracao-passo s: tempo de um passo de tile
+
+// Entrega à simulação os registros do replay; no fim confere o estado e
+// devolve o controle ao teclado
+bool avancaReplay() {
+	if (replay.aplica(sim)) return true;
+	reproduzindo = false;
+	if (!replay.temHashFinal())
+		cout << "Replay terminou (sessao sem hash final para conferir)" << endl;
+	else if (replay.confere(sim))
+		cout << "Replay terminou no mesmo estado da gravacao" << endl;
+	else
+		cout << "Replay DIVERGIU do estado gravado" << endl;
+	return false;
+}
 
-vector <Tile> tileset;
-vec2 pos; //armazena o indice i e j de onde o "personagem" está na cena
-
-// --- VARIÁVEIS DE ESTADO DO JOGO ---
-bool jogo_pausado = false;
-bool jogador_ganhou = false;
-bool jogador_perdeu = false;
-double tempo_final = 0.0; // Tempo congelado ao finalizar o jogo
-double tempo_inicio = 0.0; // Novo: tempo de início do jogo
-// Mensagem temporária de morte na lava
-std::string mensagem_morte_lava = "";
-double tempo_mensagem_lava = 0.0;
+// Sem interpolar entre o fim da partida anterior e o começo da nova
+void resetarInterpolacao() {
+    posAnterior = posVisualSim();
+    tempoAnterior = sim.tempo_jogo;
+}
 
 void resetarJogo() {
-    // Resetar mapas e barreiras
-    leMapa("../assets/maps/mapa.txt", map);
-    leMapa("../assets/maps/barreiras.txt", barreiras);
-    // Resetar personagem
-    pos.x = 0; pos.y = 0;
-    migore.direcao = 3;
-    migore.frame = 0;
-    migore.andando = false;
-    migore.grupoAnimacao = 0;
-    // Resetar moedas
-    moedasMapa[0].x = 4; moedasMapa[0].y = 0; moedasMapa[0].ativa = false;
-    moedasMapa[1].x = 6; moedasMapa[1].y = 2; moedasMapa[1].ativa = true;
-    moedasMapa[2].x = 7; moedasMapa[2].y = 13; moedasMapa[2].ativa = true;
-    moedasMapa[3].x = 13; moedasMapa[3].y = 11; moedasMapa[3].ativa = false;
-    // Resetar eventos
-    evento_38_ativado = false;
-    evento_210_ativado = false;
-    evento_45_ativado = false;
-    evento_512_ativado = false;
-    evento_82_ativado = false;
-    evento_83_ativado = false;
-    evento_71_ativado = false;
-    evento_41_ativado = false;
-    evento_118_ativado = false;
-    evento_1312_ativado = false;
-    evento_jare_capturado = false;
-    greatJareSpirit_ativo = false;
-    pontuacao = 0;
-    vidas = 5;
-    animacoesTile.clear();
-    jogo_pausado = false;
-    jogador_ganhou = false;
-    jogador_perdeu = false;
-    tempo_final = 0.0; // Reseta o tempo congelado
-    tempo_inicio = glfwGetTime(); // Novo: reseta o tempo de início
+    sim.reinicia();
+    resetarInterpolacao();
+}
+
+// --- JOGO SALVO ---
+// Autosave a cada passo de tile terminado (e F5); F9 volta ao último
+// salvamento. O arquivo some quando a partida acaba, para a próxima
+// abertura começar do zero. A escrita fica numa thread: o passo só paga a
+// cópia do estado. Numa sessão de replay o arquivo é do jogador, não do
+// replay: nem depois do fim do replay ele é gravado ou apagado.
+SalvamentoEmSegundoPlano salvador("joguinho.sav");
+long long movimentosSalvos = 0;
+bool salvamentoDescartado = false;
+MedidorLatencia tempoSalvamento; // custo de cada pedido no passo
+
+void salvarJogo() {
+	if (sessaoDeReplay) return;
+	double t0 = glfwGetTime();
+	salvador.pede(sim);
+	tempoSalvamento.registra(glfwGetTime() - t0);
+	movimentosSalvos = sim.movimentosConcluidos;
+	salvamentoDescartado = false;
+}
+
+// Carrega o jogo salvo; o replay da sessão recomeça a partir dele
+bool carregarJogo() {
+	EstadoSalvo e;
+	salvador.espera();
+	if (!carregaEstado(salvador.getCaminho(), e) || !sim.importa(e)) return false;
+	resetarInterpolacao();
+	movimentosSalvos = sim.movimentosConcluidos;
+	if (sim.gravador) gravador.abre(caminhoGravacao, sim, &e);
+	cout << "Jogo carregado de " << salvador.getCaminho() << endl;
+	return true;
+}
+
+void descartarSalvamento() {
+	if (sessaoDeReplay) return;
+	std::error_code erro;
+	salvador.espera();
+	std::filesystem::remove(salvador.getCaminho(), erro);
+	salvamentoDescartado = true;
+}
+
+// --- DESENHO SOB DEMANDA ---
+// O jogo anda de tile em tile: sem passo, animação ou texto mudando, o quadro
+// sairia igual ao anterior. Então só desenha quando algo muda e, no resto do
+// tempo, dorme em glfwWaitEventsTimeout até o próximo evento. A simulação
+// acorda o desenho (glfwPostEmptyEvent) quando publica um retrato que muda
+// a tela; o tempo limite da espera é só uma garantia.
+bool desenhoSobDemanda = true; // --desenho-continuo desliga
+bool quadroSujo = true;        // tecla, janela exposta ou redimensionada
+
+// O que aparece na tela e pode mudar sem haver animação em andamento
+struct EstadoDesenhado {
+	long long decimosRelogio, pontos;
+	int vidas, amostrasLatencia;
+	GridPoint pos;
+	int direcao, frame;
+	bool lava, jare, fim;
 };
+EstadoDesenhado ultimoDesenhado;
+
+EstadoDesenhado estadoDesenhado(const RetratoDesenho &r, int amostrasLatencia) {
+	EstadoDesenhado e;
+	e.decimosRelogio = (long long)floor(r.tempo_jogo * 10.0 + 0.5); // como o "%.1f" do HUD arredonda
+	e.pontos = (long long)r.pontuacao;
+	e.vidas = r.vidas;
+	e.amostrasLatencia = amostrasLatencia;
+	e.pos = r.pos;
+	e.direcao = r.migore.direcao;
+	e.frame = r.migore.frame;
+	e.lava = r.mensagemLava[0] != '\0';
+	e.jare = r.greatJareSpirit_ativo;
+	e.fim = r.fimDeJogo;
+	return e;
+}
+
+bool mesmoDesenho(const EstadoDesenhado &a, const EstadoDesenhado &b) {
+	return a.decimosRelogio == b.decimosRelogio && a.pontos == b.pontos && a.vidas == b.vidas &&
+		a.amostrasLatencia == b.amostrasLatencia && a.pos == b.pos && a.direcao == b.direcao &&
+		a.frame == b.frame && a.lava == b.lava && a.jare == b.jare && a.fim == b.fim;
+}
+
+bool emMovimento(const RetratoDesenho &r) {
+	return r.movendo || r.migore.andando || r.animandoTiles;
+}
+
+bool precisaDesenhar() {
+	if (!desenhoSobDemanda || quadroSujo || reproduzindo) return true;
+	if (emMovimento(*retrato) || camera.isMoving()) return true;
+	return !mesmoDesenho(estadoDesenhado(*retrato, latenciaEntrada.amostras), ultimoDesenhado);
+}
+
+void marcaDesenhado() {
+	ultimoDesenhado = estadoDesenhado(*retrato, latenciaEntrada.amostras);
+	quadroSujo = false;
+}
+
+// Quanto dá para dormir até a próxima mudança prevista: o próximo décimo do
+// relógio ou o fim da mensagem da lava (com uma folga para o passo cruzá-los)
+double tempoAteProximaMudanca() {
+	if (retrato->fimDeJogo) return 0.5;   // tela parada: só eventos a acordam
+	double t = (floor(retrato->tempo_jogo * 10.0 + 0.5) + 0.5) / 10.0 - retrato->tempo_jogo;
+	if (retrato->tempo_mensagem_lava > 0.0) t = std::min(t, retrato->tempo_mensagem_lava);
+	return t + 0.002;
+}
+
+void janelaInvalidada(GLFWwindow *, int, int) {
+	quadroSujo = true;
+}
+
+void janelaExposta(GLFWwindow *) {
+	quadroSujo = true;
+}
+
+// Publica o estado atual de "sim"; relogio é o horário do passo que o gerou.
+// Acorda o desenho se a tela vai mudar.
+EstadoDesenhado ultimoAvisado;
+
+void publicaRetrato(double relogio) {
+	QuadroSimulado &q = retratos.writeBuffer();
+	sim.retrata(q.estado);
+	q.posAnterior = posAnterior;
+	q.tempoAnterior = tempoAnterior;
+	q.relogio = relogio;
+	q.passosComEntrada = passosComEntrada;
+	q.tempoEntradaPasso = tempoEntradaPasso;
+	EstadoDesenhado e = estadoDesenhado(q.estado, 0);
+	bool acorda = emMovimento(q.estado) || !mesmoDesenho(e, ultimoAvisado);
+	ultimoAvisado = e;
+	retratos.publish();
+	if (acorda) glfwPostEmptyEvent();
+}
+
+// Aplica os comandos vindos do teclado. Devolve true se o estado mudou
+// fora de um passo (reinício ou jogo carregado).
+bool aplicaComandos(const vector<ComandoSimulacao> &lista) {
+	bool mudou = false;
+	for (size_t i = 0; i < lista.size(); i++) {
+		const ComandoSimulacao &c = lista[i];
+		switch (c.tipo) {
+		case COMANDO_ENTRADA:
+			if (!sim.fimDeJogo()) sim.entrada(c.direcao, c.acao, c.tempo);
+			break;
+		case COMANDO_REINICIA:
+			if (sim.fimDeJogo()) {
+				resetarJogo();
+				mudou = true;
+			}
+			break;
+		case COMANDO_SALVA:
+			if (!sim.fimDeJogo()) salvarJogo();
+			break;
+		case COMANDO_CARREGA:
+			mudou = carregarJogo() || mudou;
+			break;
+		}
+	}
+	return mudou;
+}
+
+// Laço da thread da simulação: dorme até o horário do próximo passo (ou
+// até chegar um comando), dá os passos devidos e publica o retrato
+void rodaSimulacao() {
+	double proximoPasso = glfwGetTime();
+	vector<ComandoSimulacao> recebidos;
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> l(travaComandos);
+			double espera = proximoPasso - glfwGetTime();
+			if (espera > 0.0 && comandos.empty() && !encerrarSimulacao)
+				sinalComandos.wait_for(l, std::chrono::duration<double>(espera));
+			if (encerrarSimulacao) return;
+			recebidos.swap(comandos);
+		}
+		bool mudou = aplicaComandos(recebidos);
+		recebidos.clear();
+		double agora = glfwGetTime();
+
+		// --- PAUSA: tela de fim, sem passos ---
+		if (sim.fimDeJogo()) {
+			// No replay, o reinício gravado tira o jogo da tela de fim
+			if (reproduzindo && avancaReplay()) {
+				resetarInterpolacao();
+				mudou = true;
+			}
+			if (!sessaoDeReplay && !salvamentoDescartado)
+				descartarSalvamento();
+			// O tempo parado não vira passos ao sair da tela de fim
+			proximoPasso = agora + (reproduzindo ? Simulacao::PASSO : 0.1);
+			if (mudou) {
+				proximoPasso = agora;
+				publicaRetrato(agora);
+			}
+			continue;
+		}
+		if (mudou) {
+			proximoPasso = agora;
+			publicaRetrato(agora);
+		}
+
+		// --- PASSO FIXO ---
+		int passos = 0;
+		while (proximoPasso <= agora && passos < MAX_PASSOS_SEGUIDOS && !sim.fimDeJogo()) {
+			double t0 = glfwGetTime();
+			if (reproduzindo) avancaReplay();
+			posAnterior = posVisualSim();
+			tempoAnterior = sim.tempo_jogo;
+			sim.passo(Simulacao::PASSO);
+			proximoPasso += Simulacao::PASSO;
+			passos++;
+			tempoPasso.registra(glfwGetTime() - t0);
+		}
+		if (passos == 0) continue;
+		if (proximoPasso <= agora || sim.fimDeJogo())
+			proximoPasso = agora + Simulacao::PASSO;
+		if (!sessaoDeReplay && sim.movimentosConcluidos != movimentosSalvos && !sim.fimDeJogo())
+			salvarJogo();
+		if (sim.tempoEntradaPassoIniciado >= 0.0) {
+			passosComEntrada++;
+			tempoEntradaPasso = sim.tempoEntradaPassoIniciado;
+			sim.tempoEntradaPassoIniciado = -1.0;
+		}
+		publicaRetrato(proximoPasso - Simulacao::PASSO);
+	}
+}
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--desenho-continuo")) desenhoSobDemanda = false;
+		else if (!strcmp(argv[i], "--replay") && i + 1 < argc) reproduzindo = replay.abre(argv[++i]);
+		else if (!strcmp(argv[i], "--gravar") && i + 1 < argc) caminhoGravacao = argv[++i];
+		else if (!strcmp(argv[i], "--perfil") && i + 1 < argc) caminhoPerfil = argv[++i];
+		else if (!strcmp(argv[i], "--contadores-gl")) contarChamadasGL = true;
+		else if (!strcmp(argv[i], "--duracao-passo") && i + 1 < argc) duracaoPasso = atof(argv[++i]);
+	}
+
 	// Inicialização da GLFW
 	glfwInit();
 
-	// Preenche o mapa a partir do arquivo
-	leMapa("../assets/maps/mapa.txt", map);
-	leMapa("../assets/maps/barreiras.txt", barreiras); // Lê o novo mapa de barreiras
+	// Tarefas da carga e da gravação dos quadros; a thread principal ajuda
+	JobSystem jobs;
+
+	// Começa a decodificar as imagens já: o resto da carga segue em paralelo
+	// (a inversão vertical do stb_image vale para todas as threads)
+	stbi_set_flip_vertically_on_load(true);
+	ImagemDecodificada imagens[NUM_IMAGENS];
+	JobCounter imagensProntas;
+	for (int i = 0; i < NUM_IMAGENS; i++) {
+		imagens[i].caminho = CAMINHOS_IMAGENS[i];
+		jobs.run([&imagens, i] { decodificaImagem(imagens[i]); }, &imagensProntas);
+	}
+
+	// Semente do sorteio: a do replay ou uma nova por sessão. O replay também
+	// traz a duração do passo com que foi gravado
+	sim.defineSemente(reproduzindo ? replay.getSemente() : (uint64_t)time(nullptr));
+	sim.defineDuracaoPasso(reproduzindo ? replay.getDuracaoPasso() : duracaoPasso);
+
+	// Preenche o mapa e as barreiras a partir dos arquivos
+	sim.carregaMapas("../assets/maps/");
+	if (reproduzindo && replay.getEstadoInicial() && !sim.importa(*replay.getEstadoInicial())) {
+		cout << "Estado inicial do replay invalido" << endl;
+		reproduzindo = false;
+	}
+	sessaoDeReplay = reproduzindo;
+	if (!reproduzindo && gravador.abre(caminhoGravacao, sim))
+		sim.gravador = &gravador;
+	// Continua de onde o jogador parou, se houver jogo salvo
+	if (!reproduzindo)
+		carregarJogo();
+	// carregaMapas já deixou a partida no começo; daqui em diante reiniciar
+	// apagaria o jogo carregado ou o estado inicial do replay
+	resetarInterpolacao();
 
 	// Debug: imprime os mapas lidos
 	std::cout << "Mapa principal:" << std::endl;
-	imprimeMapa(map);
+	imprimeMapa(sim.mapa);
 	std::cout << "Mapa de barreiras:" << std::endl;
-	imprimeMapa(barreiras);
+	imprimeBarreiras();
 
 	// Muita atenção aqui: alguns ambientes não aceitam essas configurações
 	// Você deve adaptar para a versão do OpenGL suportada por sua placa
@@ -304,8 +665,17 @@ int main()
 	}
 	glfwMakeContextCurrent(window);
 
+	// Vsync e limite de FPS: --vsync on|off|adaptive, --fps N, --fps-pausa N
+	FramePacer pacer;
+	pacer.parseArgs(argc, argv);
+	pacer.apply();
+	// --tempos-quadro arq.csv [--travada-ms N]: p50/p95/p99 e travadas, CSV na saída
+	frame_times_parse_args(argc, argv);
+
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
+	glfwSetWindowRefreshCallback(window, janelaExposta);
+	glfwSetFramebufferSizeCallback(window, janelaInvalidada);
 
 	// GLAD: carrega todos os ponteiros d funções da OpenGL
 	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
@@ -320,18 +690,29 @@ int main()
 	cout << "Renderer: " << renderer << endl;
 	cout << "OpenGL version supported " << version << endl;
 
+	// Perfil de quadro: ligado por --perfil ou pelo F3
+	if (!caminhoPerfil.empty())
+		g_profiler.setEnabled(true);
+	// Contadores de chamadas OpenGL, mostrados na sobreposição do F3
+	if (contarChamadasGL)
+		g_glInstrumentation.install();
+	// Vértices dinâmicos (textos e sobreposição do F3), um pedaço por quadro
+	g_streamBuffer.create(1 << 20);
+
 	// Definindo as dimensões da viewport com as mesmas dimensões da janela da aplicação
 	int width, height;
 	glfwGetFramebufferSize(window, &width, &height);
 	glViewport(0, 0, width, height);
 
-	// Compilando e buildando o programa de shader
+	// Compilando e buildando o programa de shader (e a cópia do HUD)
 	GLuint shaderID = setupShader();
+	hudShaderID = setupShader();
 
 	//Carregando uma textura 
+	jobs.wait(imagensProntas);
 	int imgWidth, imgHeight;
 	//GLuint texID = loadTexture("../assets/sprites/Vampires1_Walk_full.png",imgWidth,imgHeight);
-	GLuint texID = loadTexture("../assets/tilesets/tilesetIso.png",imgWidth,imgHeight);
+	GLuint texID = loadTexture(imagens[IMG_TILESET],imgWidth,imgHeight);
 	// Gerando um buffer simples, com a geometria de um triângulo
 	/* Sprite vampirao;
 	vampirao.nAnimations = 4;
@@ -344,40 +725,34 @@ int main()
 	vampirao.iFrame = 0; */
 
 	// Configura o tileset - conjunto de tiles do mapa
-	for (int i=0; i < 7; i++)
+	for (int i=0; i < NUM_TILES; i++)
 	{
 		Tile tile;
-		tile.dimensions = vec3(100,50,1.0); // Tiles maiores para melhor visualização
+		tile.dimensions = vec3(TILE_LARGURA,TILE_ALTURA,1.0); // Tiles maiores para melhor visualização
 		tile.iTile = i;
 		tile.texID = texID;
-		tile.VAO = setupTile(7,tile.ds,tile.dt);
+		tile.VAO = setupTile(NUM_TILES,tile.ds,tile.dt);
 		tile.caminhavel = true;
 		tileset.push_back(tile);
 	}
 
 	// tileset[4].caminhavel = false; // Removido, pois o sistema usa apenas o mapa de barreiras
 
-	// Inicializar a posição do "personagem"
-	pos.x = 0;
-	pos.y = 0;
-
 	// Carrega o sprite animado do Migoré
 	int migoreWidth, migoreHeight;
 	migore.nDirecoes = 8;
-	migore.nFrames = 4;
-	migore.texID = loadTexture("../assets/tilesets/migore.png", migoreWidth, migoreHeight);
+	migore.nFrames = NUM_FRAMES_MIGORE;
+	migore.texID = loadTexture(imagens[IMG_MIGORE], migoreWidth, migoreHeight);
 	migore.dimensions = vec3(100, 100, 1.0);
 	migore.ds = 1.0f / migore.nFrames;
 	migore.dt = 1.0f / migore.nDirecoes;
 	migore.VAO = setupSprite(migore.nDirecoes, migore.nFrames, migore.ds, migore.dt);
-	migore.direcao = 3; // Inicializa olhando para SO (Sudoeste)
-	migore.frame = 0;
 
 	// Carrega o sprite das moedas
 	int moedasWidth, moedasHeight;
 	moedas.nAnimations = 1;
 	moedas.nFrames = 1; // Agora moedas são estáticas
-	moedas.texID = loadTexture("../assets/sprites/moedas.png", moedasWidth, moedasHeight);
+	moedas.texID = loadTexture(imagens[IMG_MOEDAS], moedasWidth, moedasHeight);
 	moedas.dimensions = vec3(64, 64, 1.0); // Tamanho anterior
 	moedas.ds = 1.0f; // Apenas um frame
 	moedas.dt = 1.0f;
@@ -389,19 +764,20 @@ int main()
 	int jareWidth, jareHeight;
 	greatJareSpirit.nAnimations = 1;
 	greatJareSpirit.nFrames = 1;
-	greatJareSpirit.texID = loadTexture("../assets/sprites/great_jare_spirit.png", jareWidth, jareHeight);
+	greatJareSpirit.texID = loadTexture(imagens[IMG_JARE], jareWidth, jareHeight);
 	greatJareSpirit.dimensions = vec3(128, 128, 1.0); // Tamanho ajustável
 	greatJareSpirit.ds = 1.0f;
 	greatJareSpirit.dt = 1.0f;
 	greatJareSpirit.VAO = setupSprite(greatJareSpirit.nAnimations, greatJareSpirit.nFrames, greatJareSpirit.ds, greatJareSpirit.dt);
 	greatJareSpirit.iAnimation = 0;
 	greatJareSpirit.iFrame = 0;
+	posicionaGreatJareSpirit();
 
 	// Carrega o sprite da top_bar
 	int topBarWidth, topBarHeight;
 	topBar.nAnimations = 1;
 	topBar.nFrames = 1;
-	topBar.texID = loadTexture("../assets/sprites/top_bar.png", topBarWidth, topBarHeight);
+	topBar.texID = loadTexture(imagens[IMG_TOPBAR], topBarWidth, topBarHeight);
 	topBar.dimensions = vec3(topBarWidth, topBarHeight, 1.0);
 	topBar.ds = 1.0f;
 	topBar.dt = 1.0f;
@@ -409,206 +785,218 @@ int main()
 	topBar.iAnimation = 0;
 	topBar.iFrame = 0;
 
-	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
+	preparaTexto();
+	criaMapaEstatico();
 
-	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
-	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
+	// O setup acima faz binds direto no GL: o cache recomeça daqui
+	g_glState.invalidate();
+	g_glState.useProgram(shaderID);
 
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
-	glActiveTexture(GL_TEXTURE0);
+	g_glState.activeTexture(GL_TEXTURE0);
 
 	// Criando a variável uniform pra mandar a textura pro shader
-	glUniform1i(glGetUniformLocation(shaderID, "tex_buff"), 0);
+	glUniform1i(g_glState.uniformLocation(shaderID, "tex_buff"), 0);
 
 	// Matriz de projeção paralela ortográfica
 	mat4 projection = ortho(0.0, 960.0, 720.0, 0.0, -1.0, 1.0);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
-
-	glEnable(GL_DEPTH_TEST); // Habilita o teste de profundidade
-	glDepthFunc(GL_ALWAYS); // Testa a cada ciclo
-
-	glEnable(GL_BLEND); //Habilita a transparência -- canal alpha
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); //Seta função de transparência
-
-
-	double lastTime = 0.0;
-	double deltaT = 0.0;
-	double currTime = glfwGetTime();
-	double FPS = 24.0;
-	
+	glUniformMatrix4fv(g_glState.uniformLocation(shaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	locModel = g_glState.uniformLocation(shaderID, "model");
+	locOffsetTex = g_glState.uniformLocation(shaderID, "offsetTex");
+	locView = g_glState.uniformLocation(shaderID, "view");
+
+	// O HUD fica parado na tela: view identidade, enviada uma vez
+	g_glState.useProgram(hudShaderID);
+	glUniform1i(g_glState.uniformLocation(hudShaderID, "tex_buff"), 0);
+	glUniformMatrix4fv(g_glState.uniformLocation(hudShaderID, "projection"), 1, GL_FALSE, value_ptr(projection));
+	glUniformMatrix4fv(g_glState.uniformLocation(hudShaderID, "view"), 1, GL_FALSE, value_ptr(mat4(1)));
+	locModelHud = g_glState.uniformLocation(hudShaderID, "model");
+	locOffsetTexHud = g_glState.uniformLocation(hudShaderID, "offsetTex");
+
+	RenderCommandList listas[LISTAS_QUADRO];
+	RenderQueue fila;
+
+	// Primeiro retrato e a thread da simulação; daqui em diante só ela mexe em "sim"
+	resetarInterpolacao();
+	publicaRetrato(glfwGetTime());
+	retratos.update();
+	retrato = &retratos.readBuffer().estado;
+	std::thread threadSimulacao(rodaSimulacao);
+
+	// A câmera começa no personagem, sem vir deslizando de outro lugar
+	camera.setViewport(WIDTH, HEIGHT);
+	camera.setFollowHalfLife(CAMERA_MEIA_VIDA);
+	camera.setPosition(noMundo(vec2(retrato->visualX, retrato->visualY)));
+	relogioCamera = glfwGetTime();
+
+	bool esperarEventos = false; // nada mudou no último frame: pode dormir
 
 	// Loop da aplicação - "game loop"
-    static double prev_anim_s = glfwGetTime(); // Corrigido: fora do if
 	while (!glfwWindowShouldClose(window))
 	{
-		// Checa eventos de input
-		glfwPollEvents();
-
-		// --- PAUSA: impede atualização do jogo se pausado ---
-        if (jogo_pausado) {
-            // Limpa tela
-            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            // --- DESENHA TOP BAR COMO FUNDO DO HUD (igual ao modo normal) ---
-            {
-                float x = ((topBar.dimensions.x) / 3 )* 2;
-                float y = 30.0f; // Topo da janela
-                mat4 model = mat4(1);
-                model = translate(model, vec3(x, y, 0.0f));
-                model = scale(model, topBar.dimensions);
-                glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-                vec2 offsetTex;
-                offsetTex.s = topBar.iFrame * topBar.ds;
-                offsetTex.t = topBar.iAnimation * topBar.dt;
-                glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
-                glBindVertexArray(topBar.VAO);
-                glBindTexture(GL_TEXTURE_2D, topBar.texID);
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-            }
-            // --- HUD alinhado bonito ---
-            char info[128];
-            float y_hud = 25.0f;
-            sprintf(info, "Pontos: %.0f", pontuacao);
-            drawText_GL33(WIDTH/2 - 260, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-            sprintf(info, "Vidas: %d", vidas);
-            drawText_GL33(WIDTH/2 - 40, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-            double tempo_jogo = tempo_final - tempo_inicio; // Corrigido
-            sprintf(info, "Tempo: %.1fs", tempo_jogo);
-            drawText_GL33(WIDTH/2 + 140, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-            // --- Mensagem de fim de jogo ---
-            const char* msg = jogador_ganhou ? "VOCE GANHOU!" : "GAME OVER";
-            // Centralização simples, igual ao HUD
-            drawText_GL33(WIDTH/2-120, HEIGHT/2-40, msg, 1, 1, 0, 3.0f);
-            drawText_GL33(WIDTH/2-190, HEIGHT/2+20, "Pressione ENTER para reiniciar.", 1, 1, 1, 2.0f);
-            glUseProgram(shaderID);
-            glBindVertexArray(0);
-            glfwSwapBuffers(window);
-            continue;
-        }
+		// Checa eventos de input; sob demanda e sem nada mudando, dorme até
+		// chegar um evento, um retrato que muda a tela ou a próxima mudança
+		// prevista (quadro que acaba sem desenhar é descartado no próximo beginFrame)
+		g_profiler.beginFrame();
+		if (esperarEventos) {
+			PROFILE_ZONE("Espera");
+			glfwWaitEventsTimeout(tempoAteProximaMudanca());
+			frame_times_restart(); // dormir de propósito não é travada
+		} else {
+			PROFILE_ZONE("Entrada");
+			glfwPollEvents();
+		}
+
+		// Única leitura do relógio no frame
+		double tempo_frame = glfwGetTime();
+
+		// O quadro com o último passo iniciado já foi trocado: fecha a medição
+		if (latenciaAguardaTroca >= 0.0) {
+			latenciaEntrada.registra(tempo_frame - latenciaAguardaTroca);
+			latenciaAguardaTroca = -1.0;
+		}
+
+		// --- RETRATO: o estado completo mais recente da simulação ---
+		int zonaRetrato = g_profiler.beginZone("Retrato");
+		retratos.update();
+		const QuadroSimulado &quadro = retratos.readBuffer();
+		retrato = &quadro.estado;
+
+		// Fração do próximo passo já decorrida: o desenho fica entre o passo anterior e o atual
+		float alpha = (float)glm::clamp((tempo_frame - quadro.relogio) / Simulacao::PASSO, 0.0, 1.0);
+		posRender = mix(quadro.posAnterior, vec2(retrato->visualX, retrato->visualY), alpha);
+		tempoRender = quadro.tempoAnterior + (retrato->tempo_jogo - quadro.tempoAnterior) * alpha;
+
+		// Câmera: persegue o personagem já interpolado e treme quando ele cai na lava
+		bool lava = retrato->mensagemLava[0] != '\0';
+		if (lava && !lavaNaTela) camera.shake(TREMIDA_LAVA);
+		lavaNaTela = lava;
+		camera.follow(noMundo(posRender));
+		camera.update((float)(tempo_frame - relogioCamera));
+		relogioCamera = tempo_frame;
+		g_profiler.endZone(zonaRetrato);
+
+		// Quadro igual ao que já está na tela: não desenha nem troca buffers
+		pacer.setIdle(retrato->fimDeJogo); // tela de fim parada: poucos quadros bastam
+		esperarEventos = !precisaDesenhar();
+		if (esperarEventos) continue;
+
+		// Passo iniciado por tecla neste retrato: mede até a troca de buffers
+		if (quadro.passosComEntrada != passosComEntradaVistos) {
+			passosComEntradaVistos = quadro.passosComEntrada;
+			latenciaAguardaTroca = quadro.tempoEntradaPasso;
+		}
 
 		// Limpa o buffer de cor
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // cor de fundo
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        
-
-		// Desenhar o mapa
-		verificaEventoMapa(pos.x, pos.y);
-		desenharMapa(shaderID);
-		desenharPersonagem(shaderID);
-		desenharMoedas(shaderID);
-		desenharGreatJareSpirit(shaderID);
-
-
-		// Atualiza animação do personagem
-		currTime = glfwGetTime();
-		deltaT += currTime - lastTime;
-		lastTime = currTime;
-		static int frameAnim = 0;
-		if (migore.andando) {
-			if (deltaT >= 1.0 / FPS) {
-				frameAnim = (frameAnim + 1) % 2; // Só 2 frames por grupo
-				migore.frame = migore.grupoAnimacao * 2 + frameAnim;
-				deltaT = 0.0;
-			}
+		// Estado do quadro a cada quadro: a sobreposição do F3 troca pelo
+		// cache e não desfaz (só custa chamada o que ela mudou)
+		g_glState.setEnabled(GL_DEPTH_TEST, true); // Habilita o teste de profundidade
+		g_glState.depthFunc(GL_ALWAYS); // Testa a cada ciclo
+		g_glState.setEnabled(GL_BLEND, true); //Habilita a transparência -- canal alpha
+		g_glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA); //Seta função de transparência
+
+		if (retrato->fimDeJogo) {
+			// --- PAUSA: só o HUD com a mensagem de fim ---
+			PROFILE_ZONE("HUD");
+			listas[LISTA_HUD].clear();
+			gravarHud(listas[LISTA_HUD], hudShaderID, true);
+			fila.add(listas[LISTA_HUD]);
+			fila.submit();
 		} else {
-			migore.frame = 0;
-			frameAnim = 0;
+			// Tiles que trocaram desde o último quadro (em geral nenhum)
+			atualizaMapaEstatico(retrato->mapa);
+			// Grava o quadro em paralelo: mapa, sprites e HUD
+			{
+				PROFILE_ZONE("Gravacao");
+				jobs.parallelFor(LISTAS_QUADRO, 1, [&](int i, int) {
+					RenderCommandList &lista = listas[i];
+					lista.clear();
+					if (i == LISTA_MAPA) {
+						gravarMapa(lista, shaderID);
+					} else if (i == LISTA_SPRITES) {
+						gravarPersonagem(lista, shaderID);
+						gravarMoedas(lista, shaderID);
+						gravarGreatJareSpirit(lista, shaderID);
+					} else {
+						gravarHud(lista, hudShaderID, false);
+					}
+				});
+			}
+			// A câmera do quadro e as listas ordenadas por camada, programa e textura
+			{
+				PROFILE_ZONE("Envio");
+				g_glState.useProgram(shaderID);
+				glUniformMatrix4fv(locView, 1, GL_FALSE, value_ptr(camera.getView()));
+				for (int i = 0; i < LISTAS_QUADRO; i++)
+					fila.add(listas[i]);
+				fila.submit();
+			}
 		}
+        g_profiler.drawOverlay(WIDTH, HEIGHT);
+        g_streamBuffer.endFrame();
 
-		// --- Atualiza animações de troca de tile, se houver ---
-        double curr_s = glfwGetTime();
-        double elapsed = curr_s - prev_anim_s;
-        prev_anim_s = curr_s;
-        if (!animacoesTile.empty()) {
-            for (auto &anim : animacoesTile) {
-                anim.tempo += elapsed;
-                // alterna o tile a cada 0.08s
-                if (fmod(anim.tempo, 0.16) < 0.08) {
-                    map[anim.x][anim.y] = anim.tileInicial;
-                } else {
-                    map[anim.x][anim.y] = anim.tileFinal;
-                }
-            }
-            // Remove animações finalizadas
-            animacoesTile.erase(
-                std::remove_if(animacoesTile.begin(), animacoesTile.end(), [](AnimacaoTile &anim) {
-                    if (anim.tempo >= anim.tempoTotal) {
-                        map[anim.x][anim.y] = anim.tileFinal;
-                        return true;
-                    }
-                    return false;
-                }),
-                animacoesTile.end()
-            );
-        }
+        // Troca os buffers da tela
+		{
+			PROFILE_ZONE("Troca");
+			glfwSwapBuffers(window);
+		}
+		frame_times_mark();
+		_update_fps_counter(window, "Labirintaré - A jornada."); // FPS (e p99/max, se gravando) no título
+		g_profiler.endFrame();
+		g_glInstrumentation.endFrame();
+		marcaDesenhado();
+		pacer.waitForNextFrame();
+		if (retrato->fimDeJogo)
+			frame_times_restart(); // a tela de fim anda devagar de propósito
+	}
 
-		// --- CHECA CONDIÇÃO DE VITÓRIA/DERROTA ---
-        // Vitória: chegou ao final (exemplo: tile 14,5)
-        if (!jogo_pausado && pos.x == 14 && pos.y == 5) {
-            jogo_pausado = true;
-            jogador_ganhou = true;
-            jogador_perdeu = false;
-            tempo_final = glfwGetTime(); // Congela o tempo
-        }
-        // Derrota: ficou sem vidas
-        if (!jogo_pausado && vidas <= 0) {
-            jogo_pausado = true;
-            jogador_perdeu = true;
-            jogador_ganhou = false;
-            tempo_final = glfwGetTime(); // Congela o tempo
-        }
+	// Para a simulação antes de ler "sim" de novo
+	{
+		std::lock_guard<std::mutex> l(travaComandos);
+		encerrarSimulacao = true;
+	}
+	sinalComandos.notify_one();
+	threadSimulacao.join();
 
-		// --- DESENHA TOP BAR COMO FUNDO DO HUD ---
-        {
-            float x = ((topBar.dimensions.x) / 3 )* 2;
-            float y = 30.0f; // Agora, topo da janela
-            mat4 model = mat4(1);
-            model = translate(model, vec3(x, y, 0.0f));
-            model = scale(model, topBar.dimensions);
-            glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-            vec2 offsetTex;
-            offsetTex.s = topBar.iFrame * topBar.ds;
-            offsetTex.t = topBar.iAnimation * topBar.dt;
-            glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
-            glBindVertexArray(topBar.VAO);
-            glBindTexture(GL_TEXTURE_2D, topBar.texID);
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        }
-		
-        // --- DESENHO DE TEXTOS (HUD) ---
-        char info[128];
-        float y_hud = 25.0f;
-        // Pontos à esquerda
-        sprintf(info, "Pontos: %.0f", pontuacao);
-        drawText_GL33(WIDTH/2 - 260, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-        // Vidas ao centro
-        sprintf(info, "Vidas: %d", vidas);
-        drawText_GL33(WIDTH/2 - 40, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-        // Tempo à direita
-        double tempo_jogo = jogo_pausado ? (tempo_final - tempo_inicio) : (glfwGetTime() - tempo_inicio); // Corrigido
-        sprintf(info, "Tempo: %.1fs", tempo_jogo);
-        drawText_GL33(WIDTH/2 + 140, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
-        
-        // --- MENSAGEM TEMPORÁRIA DE MORTE NA LAVA ---
-        if (!mensagem_morte_lava.empty() && tempo_mensagem_lava > 0.0) {
-            drawText_GL33(WIDTH/2-200, HEIGHT/2-100, mensagem_morte_lava.c_str(), 1, 0.2f, 0.2f, 2.5f);
-            tempo_mensagem_lava -= deltaT;
-            if (tempo_mensagem_lava <= 0.0) {
-                mensagem_morte_lava = "";
-                tempo_mensagem_lava = 0.0;
-            }
-        }
+	if (tempoPasso.amostras > 0) {
+		cout << "Passo da simulacao: media " << tempoPasso.media() * 1000.0 << " ms, max "
+			 << tempoPasso.maxima * 1000.0 << " ms em " << tempoPasso.amostras << " passos" << endl;
+	}
+	if (tempoSalvamento.amostras > 0) {
+		cout << "Salvamento no quadro: media " << tempoSalvamento.media() * 1000.0 << " ms, max "
+			 << tempoSalvamento.maxima * 1000.0 << " ms em " << tempoSalvamento.amostras << " pedidos ("
+			 << salvador.getGravacoes() << " gravados)" << endl;
+	}
+	if (gravador.aberto()) {
+		gravador.fecha(sim);
+		cout << "Sessao gravada em " << caminhoGravacao << " (" << gravador.getRegistros() << " registros)" << endl;
+	}
+	if (latenciaEntrada.amostras > 0) {
+		cout << "Latencia de entrada: media " << latenciaEntrada.media() * 1000.0 << " ms, max "
+			 << latenciaEntrada.maxima * 1000.0 << " ms em " << latenciaEntrada.amostras << " passos" << endl;
+	}
 
-        // Garante que o shader do jogo está ativo após desenhar texto
-        glUseProgram(shaderID);
-        glBindVertexArray(0);
-        // Troca os buffers da tela
-		glfwSwapBuffers(window);
+	if (!caminhoPerfil.empty()) {
+		if (g_profiler.writeChromeTrace(caminhoPerfil))
+			cout << "Perfil gravado em " << caminhoPerfil << " (abrir em chrome://tracing)" << endl;
+		else
+			cout << "Falha ao gravar o perfil em " << caminhoPerfil << endl;
 	}
-		
+	g_profiler.shutdown();
+	if (g_glInstrumentation.getFrames() > 0) {
+		const GLCounters &c = g_glInstrumentation.total();
+		double n = (double)g_glInstrumentation.getFrames();
+		cout << "Chamadas OpenGL por quadro: " << c.drawCalls / n << " desenhos, " << c.programSwitches / n
+			 << " glUseProgram, " << c.textureBinds / n << " binds de textura, " << c.vaoBinds / n << " binds de VAO, "
+			 << c.uniformUploads / n << " uniformes, " << c.uniformLocationQueries / n << " glGetUniformLocation, "
+			 << c.bufferBytes / n << " bytes em buffers, " << c.redundantStateSets / n << " redundantes" << endl;
+	}
+
 	// Finaliza a execução da GLFW, limpando os recursos alocados por ela
 	glfwTerminate();
 	return 0;
@@ -619,179 +1007,78 @@ int main()
 // ou solta via GLFW
 void key_callback(GLFWwindow *window, int key, int scancode, int action, int mode)
 {
+    quadroSujo = true;
+
     // Permite fechar com ESC sempre
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
         glfwSetWindowShouldClose(window, GL_TRUE);
 
-    // --- Se o jogo está pausado, só aceita ENTER para resetar ---
-    if (jogo_pausado) {
-        if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
-            resetarJogo();
-        }
+    // F3 mostra/esconde o perfil de quadro (e liga o perfil na primeira vez)
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS) {
+        if (!g_profiler.isEnabled())
+            g_profiler.setEnabled(true);
+        g_profiler.setOverlayVisible(!g_profiler.isOverlayVisible());
         return;
     }
 
-	vec2 aux = pos;
-
-	migore.andando = false; // por padrão, parado
-
-	if (key == GLFW_KEY_W && action == GLFW_PRESS) // NORTE
-	{
-		if (pos.x > 0) pos.x--;
-		if (pos.y > 0) pos.y--;
-		migore.direcao = 0; // N
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2; // sorteia grupo
-	}
-	if (key == GLFW_KEY_Q && action == GLFW_PRESS) // NOROESTE
-	{
-		if (pos.x > 0) pos.x--;
-		migore.direcao = 1; // NO
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_A && action == GLFW_PRESS) // OESTE
-	{
-		if (pos.x > 0) pos.x--;
-		if (pos.y <= TILEMAP_HEIGHT - 2) pos.y++;
-		migore.direcao = 2; // O
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_Z && action == GLFW_PRESS) // SUDOESTE
-	{
-		if (pos.y <= TILEMAP_HEIGHT - 2) pos.y++;
-		migore.direcao = 3; // SO
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_S && action == GLFW_PRESS) // SUL
-	{
-		if (pos.x <= TILEMAP_WIDTH -2) pos.x++;
-		if (pos.y <= TILEMAP_HEIGHT - 2) pos.y++;
-		migore.direcao = 4; // S
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_C && action == GLFW_PRESS) // SUDESTE
-	{
-		if (pos.x <= TILEMAP_WIDTH -2) pos.x++;
-		migore.direcao = 5; // SE
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_D && action == GLFW_PRESS) // LESTE
-	{
-		if (pos.x <= TILEMAP_WIDTH -2) pos.x++;
-		if (pos.y > 0) pos.y--;
-		migore.direcao = 6; // L
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	if (key == GLFW_KEY_E && action == GLFW_PRESS) // NORDESTE
-	{
-		if (pos.y > 0) pos.y--;
-		migore.direcao = 7; // NE
-		migore.andando = true;
-		migore.grupoAnimacao = rand() % 2;
-	}
-	// Nova lógica de colisão: só permite andar se barreiras[x][y] == 0
-	if (barreiras[(int)pos.x][(int)pos.y] != 0)
-	{
-		pos = aux; //recebe a pos não mudada :P
-	}
-
-	cout << "(" << pos.x <<"," << pos.y << ")" << endl;
-
-	
-}
-
-// Função para verificar eventos do tile atual do mapa (lava, moedas, etc)
-void verificaEventoMapa(int posx, int posy) {
-
-	// --------------------- LÓGICA DA LAVA
-    if (map[posx][posy] == 3) {
-        std::cout << "Voce morreu! Caiu na lava!" << std::endl;
-        pos.x = 0;
-        pos.y = 0;
-        vidas--;
-        mensagem_morte_lava = "Voce morreu! Caiu na lava!";
-        tempo_mensagem_lava = 3.5; // Exibe por 3.5 segundos
+    // "=" e "-" aproximam e afastam a câmera (também no replay)
+    if ((key == GLFW_KEY_EQUAL || key == GLFW_KEY_KP_ADD) && action != GLFW_RELEASE) {
+        camera.setZoom(std::min(camera.getZoom() * 1.25f, ZOOM_MAXIMO));
+        return;
+    }
+    if ((key == GLFW_KEY_MINUS || key == GLFW_KEY_KP_SUBTRACT) && action != GLFW_RELEASE) {
+        camera.setZoom(std::max(camera.getZoom() / 1.25f, ZOOM_MINIMO));
+        return;
     }
 
-	// --------------------- LÓGICA DAS MOEDAS
-	if(posx == 4 && posy == 0 && moedasMapa[0].ativa) {
-		coletarMoeda(0);
-	}
-	if(posx == 6 && posy == 2 && moedasMapa[1].ativa) {
-		coletarMoeda(1);
-	}
-	if(posx == 7 && posy == 13 && moedasMapa[2].ativa) {
-		coletarMoeda(2);
-	}
-	if(posx == 13 && posy == 11 && moedasMapa[3].ativa) {
-		coletarMoeda(3);
-	}
-
-	// --------------------- LÓGICA DO GREAT JARE SPIRIT
-	if (posx == 12 && posy == 11 && greatJareSpirit_ativo && !evento_jare_capturado) {
-		std::cout << "Voce encontrou o Great Jare Spirit!" << std::endl;
-		animarTrocaTile(12, 11, 5);
-		greatJareSpirit_ativo = false;
-		evento_jare_capturado = true;
-		pontuacao *= 1.25f;
-		
-	}
+    // Durante o replay a entrada vem do arquivo
+    if (reproduzindo)
+        return;
 
-	// --------------------- LOGICAS DOS BOTOES
-    // Primeiro botão
-    if (posx == 3 && posy == 7 && !evento_38_ativado) {
-        liberarTileComAnimacao(2, 8, evento_38_ativado);
-    }
-    // Segundo botão
-    if (posx == 1 && posy == 9 && !evento_210_ativado) {
-        liberarTileComAnimacao(2, 10, evento_210_ativado);
-    }
-    // Terceiro botão
-    if (posx == 2 && posy == 13 && !evento_45_ativado) {
-        liberarTileComAnimacao(4, 5, evento_45_ativado);
-    }
-    // Quarto botão
-    if (posx == 5 && posy == 11 && !evento_512_ativado) {
-        liberarTileComAnimacao(5, 12, evento_512_ativado);
-    }
-    // Quinto botão
-    if (posx == 9 && posy == 13 && (!evento_82_ativado)) {
-        liberarTileComAnimacao(8, 2, evento_82_ativado);
-		liberarTileComAnimacao(8, 3, evento_83_ativado);
-    }
-    // Sexto botão
-    if (posx == 13 && posy == 1 && !evento_71_ativado) {
-        liberarTileComAnimacao(7, 1, evento_71_ativado);
-    }
-    // Sétimo botão
-    if (posx == 5 && posy == 1 && !evento_41_ativado) {
-        liberarTileComAnimacao(4, 1, evento_41_ativado);
-		moedasMapa[0].ativa = true; // Ativa a moeda que está escondida
+    // F5 salva na hora, F9 volta ao último salvamento
+    if (key == GLFW_KEY_F9 && action == GLFW_PRESS) {
+        enviaComando(COMANDO_CARREGA);
+        return;
     }
-    // Oitavo botão
-    if (posx == 5 && posy == 2 && !evento_118_ativado) {
-        liberarTileComAnimacao(11, 8, evento_118_ativado);
+    if (key == GLFW_KEY_F5 && action == GLFW_PRESS && !retrato->fimDeJogo) {
+        enviaComando(COMANDO_SALVA);
+        return;
     }
-    // Nono botão
-    if (posx == 14 && posy == 3 && !evento_1312_ativado) {
-        liberarTileComAnimacao(12, 10, evento_1312_ativado);
-		// barreiras[12][12] = 1; // Bloqueia a coordenada 12,12
-		// barreiras[13][12] = 1; // Bloqueia a coordenada 13,12
-		moedasMapa[3].ativa = true; // Ativa a moeda final
-		greatJareSpirit_ativo = true; // Ativa o sprite do Great Jare Spirit
+
+    // --- Se o jogo está pausado, só aceita ENTER para resetar ---
+    if (retrato->fimDeJogo) {
+        if (key == GLFW_KEY_ENTER && action == GLFW_PRESS) {
+            enviaComando(COMANDO_REINICIA);
+        }
+        return;
     }
 
-    
+	// Teclas de direção vão para a fila com o horário de chegada. A repetição
+	// automática do sistema (GLFW_REPEAT) é ignorada: enquanto a tecla está
+	// segurada, quem emenda um passo no outro é a simulação.
+	int direcao = direcaoDaTecla(key);
+	if (direcao < 0 || action == GLFW_REPEAT) return;
+	enviaComando(COMANDO_ENTRADA, direcao, action == GLFW_PRESS ? ENTRADA_PRESSIONA : ENTRADA_SOLTA, glfwGetTime());
+}
+
+// Direção (numeração de sim.migore.direcao) de cada tecla de movimento, ou -1
+int direcaoDaTecla(int key)
+{
+	switch (key) {
+	case GLFW_KEY_W: return 0; // NORTE
+	case GLFW_KEY_Q: return 1; // NOROESTE
+	case GLFW_KEY_A: return 2; // OESTE
+	case GLFW_KEY_Z: return 3; // SUDOESTE
+	case GLFW_KEY_S: return 4; // SUL
+	case GLFW_KEY_C: return 5; // SUDESTE
+	case GLFW_KEY_D: return 6; // LESTE
+	case GLFW_KEY_E: return 7; // NORDESTE
+	}
+	return -1;
 }
 
 // Função utilitária para imprimir o mapa no console PARA DEBUG
-void imprimeMapa(int map[][TILEMAP_WIDTH]) {
+void imprimeMapa(int map[][TILEMAP_HEIGHT]) {
     for (int y = 0; y < TILEMAP_HEIGHT; y++) {
         for (int x = 0; x < TILEMAP_WIDTH; x++) {
             std::cout << map[x][y];
@@ -971,7 +1258,12 @@ int setupTile(int nTiles, float &ds, float &dt)
 	return VAO;
 }
 
-int loadTexture(string filePath, int &width, int &height)
+void decodificaImagem(ImagemDecodificada &img)
+{
+	img.data = stbi_load(img.caminho.c_str(), &img.width, &img.height, &img.nrChannels, 0);
+}
+
+int loadTexture(ImagemDecodificada &img, int &width, int &height)
 {
 	GLuint texID;
 
@@ -985,12 +1277,11 @@ int loadTexture(string filePath, int &width, int &height)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	int nrChannels;
-
-	// Corrige a orientação vertical das imagens (OpenGL espera origem no canto inferior esquerdo)
-	stbi_set_flip_vertically_on_load(true);
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
+	// A orientação vertical já foi corrigida na decodificação (OpenGL espera origem no canto inferior esquerdo)
+	unsigned char *data = img.data;
+	int nrChannels = img.nrChannels;
+	width = img.width;
+	height = img.height;
 
 	if (data)
 	{
@@ -1010,259 +1301,285 @@ int loadTexture(string filePath, int &width, int &height)
 	}
 
 	stbi_image_free(data);
+	img.data = NULL;
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
 	return texID;
 }
 
-void leMapa(const std::string& path, int map[][TILEMAP_WIDTH]) {
-    std::ifstream arquivo(path);
-    if (!arquivo.is_open()) {
-        std::cerr << "Erro ao abrir o arquivo: " << path << std::endl;
-        return;
-    }
-    std::string linha;
-    int y = 0;
-    while (std::getline(arquivo, linha) && y < TILEMAP_HEIGHT) {
-        int x = 0;
-        size_t start = 0, end;
-        while (x < TILEMAP_WIDTH && (end = linha.find(',', start)) != std::string::npos) {
-            std::string valor = linha.substr(start, end - start);
-            if (!valor.empty() && valor.find_first_not_of(" \t\n\r") != std::string::npos)
-                map[x++][y] = std::stoi(valor);
-            start = end + 1;
-        }
-        // Último valor da linha (após a última vírgula)
-        if (x < TILEMAP_WIDTH && start < linha.size()) {
-            std::string valor = linha.substr(start);
-            if (!valor.empty() && valor.find_first_not_of(" \t\n\r") != std::string::npos)
-                map[x++][y] = std::stoi(valor);
-        }
-        y++;
-    }
+// Losango do tile (x, y) em coordenadas de mundo: os 4 cantos do
+// setupTile, escalados e transladados como a matriz model fazia
+void verticesTile(int x, int y, int iTile, GLfloat *v)
+{
+	const Tile &t = tileset[iTile];
+	vec2 base = noMundo(vec2(x, y)) - vec2(t.dimensions.x / 2.0f, 0.0f);
+	float s = t.iTile * t.ds;
+	// x, y, s, t de A, B, D, C; os triângulos são ABD e BCD
+	const float cantos[4][4] = {
+		{ 0.0f, 0.5f, 0.0f, t.dt / 2.0f },
+		{ 0.5f, 1.0f, t.ds / 2.0f, t.dt },
+		{ 0.5f, 0.0f, t.ds / 2.0f, 0.0f },
+		{ 1.0f, 0.5f, t.ds, t.dt / 2.0f }
+	};
+	const int ordem[VERTICES_TILE] = { 0, 1, 2, 1, 3, 2 };
+	for (int i = 0; i < VERTICES_TILE; i++) {
+		const float *c = cantos[ordem[i]];
+		*v++ = base.x + c[0] * t.dimensions.x;
+		*v++ = base.y + c[1] * t.dimensions.y;
+		*v++ = 0.0f;
+		*v++ = s + c[2];
+		*v++ = c[3];
+	}
 }
 
-void desenharMapa(GLuint shaderID)
+// VBO e VAO do mapa, no mesmo formato de vértice do setupTile
+void criaMapaEstatico()
 {
-	// Calcula o centro da tela
-	float tela_cx = WIDTH / 2.0f;
-	float tela_cy = HEIGHT / 2.0f;
-
-	// Tile do personagem
-	Tile tile_central = tileset[6];
-	float tile_w = tile_central.dimensions.x;
-	float tile_h = tile_central.dimensions.y;
-
-	// Offset para centralizar o personagem
-	float x0 = tela_cx - (pos.x - pos.y) * tile_w / 2.0f - tile_w / 2.0f; // desloca meio tile para a esquerda
-	float y0 = tela_cy - (pos.x + pos.y) * tile_h / 2.0f;
-
-	for(int y=0; y<TILEMAP_HEIGHT; y++)
-	{
-		for (int x=0; x < TILEMAP_WIDTH; x++)
-		{
-			mat4 model = mat4(1);
-			Tile curr_tile = tileset[map[x][y]];
-
-			float draw_x = x0 + (x-y) * curr_tile.dimensions.x/2.0;
-			float draw_y = y0 + (x+y) * curr_tile.dimensions.y/2.0;
-
-			model = translate(model, vec3(draw_x,draw_y,0.0));
-			model = scale(model,curr_tile.dimensions);
-			glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-
-			vec2 offsetTex;
-			offsetTex.s = curr_tile.iTile * curr_tile.ds;
-			offsetTex.t = 0.0;
-			glUniform2f(glGetUniformLocation(shaderID, "offsetTex"),offsetTex.s, offsetTex.t);
+	glGenBuffers(1, &mapaEstatico.VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, mapaEstatico.VBO);
+	glBufferData(GL_ARRAY_BUFFER, TILEMAP_WIDTH * TILEMAP_HEIGHT * VERTICES_TILE * 5 * sizeof(GLfloat), NULL, GL_STATIC_DRAW);
+	glGenVertexArrays(1, &mapaEstatico.VAO);
+	glBindVertexArray(mapaEstatico.VAO);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(GLfloat), (GLvoid *)(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(1);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	mapaEstatico.montado = false;
+}
 
-			glBindVertexArray(curr_tile.VAO);
-			glBindTexture(GL_TEXTURE_2D, curr_tile.texID);
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+// Na thread do GL, antes de gravar o quadro: reenvia só os tiles que
+// mudaram desde o último envio (todos, na primeira vez)
+void atualizaMapaEstatico(const int mapa[][TILEMAP_HEIGHT])
+{
+	if (mapaEstatico.montado && !memcmp(mapaEstatico.mapa, mapa, sizeof(mapaEstatico.mapa)))
+		return;
+	const GLsizeiptr bytesTile = VERTICES_TILE * 5 * sizeof(GLfloat);
+	GLfloat v[VERTICES_TILE * 5];
+	g_glState.bindBuffer(GL_ARRAY_BUFFER, mapaEstatico.VBO);
+	if (!mapaEstatico.montado) {
+		vector<GLfloat> tudo;
+		tudo.reserve(TILEMAP_WIDTH * TILEMAP_HEIGHT * VERTICES_TILE * 5);
+		for (int y = 0; y < TILEMAP_HEIGHT; y++) {
+			for (int x = 0; x < TILEMAP_WIDTH; x++) {
+				verticesTile(x, y, mapa[x][y], v);
+				tudo.insert(tudo.end(), v, v + VERTICES_TILE * 5);
+			}
+		}
+		glBufferSubData(GL_ARRAY_BUFFER, 0, tudo.size() * sizeof(GLfloat), tudo.data());
+	} else {
+		for (int y = 0; y < TILEMAP_HEIGHT; y++) {
+			for (int x = 0; x < TILEMAP_WIDTH; x++) {
+				if (mapaEstatico.mapa[x][y] == mapa[x][y]) continue;
+				verticesTile(x, y, mapa[x][y], v);
+				glBufferSubData(GL_ARRAY_BUFFER, (y * TILEMAP_WIDTH + x) * bytesTile, bytesTile, v);
+			}
 		}
 	}
+	memcpy(mapaEstatico.mapa, mapa, sizeof(mapaEstatico.mapa));
+	mapaEstatico.montado = true;
+}
+
+void gravarMapa(RenderCommandList &lista, GLuint shaderID)
+{
+	// O mapa inteiro num desenho: a câmera entra pela view
+	const Tile &t = tileset[0];
+	RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_MAPA, 0, shaderID, t.texID),
+		shaderID, mapaEstatico.VAO, t.texID, GL_TRIANGLES, 0, TILEMAP_WIDTH * TILEMAP_HEIGHT * VERTICES_TILE);
+	mat4 model = mat4(1);
+	cmd.setModel(locModel, value_ptr(model));
+	cmd.setParam(locOffsetTex, 2, 0.0f, 0.0f);
 }
 
-void desenharPersonagem(GLuint shaderID)
+void gravarPersonagem(RenderCommandList &lista, GLuint shaderID)
 {
 	// Desenha o Migoré animado no centro do tile onde ele está
-	float tela_cx = WIDTH / 2.0f;
-	float tela_cy = HEIGHT / 2.0f;
-	Tile tile_central = tileset[6];
-	float tile_w = tile_central.dimensions.x;
-	float tile_h = tile_central.dimensions.y;
-	float x0 = tela_cx - (pos.x - pos.y) * tile_w / 2.0f;
-	float y0 = tela_cy - (pos.x + pos.y) * tile_h / 2.0f;
-	float x = x0 + (pos.x - pos.y) * tile_w / 2.0f;
-	float y = y0 + (pos.x + pos.y) * tile_h / 2.0f;
+	vec2 p = noMundo(posRender);
 
 	mat4 model = mat4(1);
-	model = translate(model, vec3(x, y, 0.0));
+	model = translate(model, vec3(p.x, p.y, 0.0));
 	model = scale(model, migore.dimensions);
-	glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
 
 	vec2 offsetTex;
-	offsetTex.s = migore.frame * migore.ds;
-	offsetTex.t = migore.direcao * migore.dt;
-	glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
+	offsetTex.s = retrato->migore.frame * migore.ds;
+	offsetTex.t = retrato->migore.direcao * migore.dt;
 
-	glBindVertexArray(migore.VAO);
-	glBindTexture(GL_TEXTURE_2D, migore.texID);
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_SPRITES, 0, shaderID, migore.texID),
+		shaderID, migore.VAO, migore.texID, GL_TRIANGLE_STRIP, 0, 4);
+	cmd.setModel(locModel, value_ptr(model));
+	cmd.setParam(locOffsetTex, 2, offsetTex.s, offsetTex.t);
 }
 
-void desenharMoedas(GLuint shaderID) {
-    float tela_cx = WIDTH / 2.0f;
-    float tela_cy = HEIGHT / 2.0f;
-    Tile tile_central = tileset[6];
-    float tile_w = tile_central.dimensions.x;
-    float tile_h = tile_central.dimensions.y;
-    float x0 = tela_cx - (pos.x - pos.y) * tile_w / 2.0f;
-    float y0 = tela_cy - (pos.x + pos.y) * tile_h / 2.0f;
-
-    double tempo = glfwGetTime();
+void gravarMoedas(RenderCommandList &lista, GLuint shaderID) {
+    double tempo = tempoRender; // tempo simulado interpolado
     float amplitude = 12.0f; // altura máxima do pulo
     float freq = 1.5f; // velocidade da flutuação
 
     for (int i = 0; i < NUM_MOEDAS; i++) {
-        if (!moedasMapa[i].ativa) continue;
-        int j = moedasMapa[i].x;
-        int k = moedasMapa[i].y;
-        float x = x0 + (j - k) * tile_w / 2.0f;
-        float y = y0 + (j + k) * tile_h / 2.0f;
+        if (!retrato->moedas[i].ativa) continue;
+        vec2 p = noMundo(vec2(retrato->moedas[i].x, retrato->moedas[i].y));
         // Aplica deslocamento vertical animado
         float offsetY = amplitude * sinf((float)tempo * freq + i);
         mat4 model = mat4(1);
-        model = translate(model, vec3(x, y + offsetY, 0.0));
+        model = translate(model, vec3(p.x, p.y + offsetY, 0.0));
         model = scale(model, moedas.dimensions);
-        glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
         vec2 offsetTex;
         offsetTex.s = moedas.iFrame * moedas.ds;
         offsetTex.t = moedas.iAnimation * moedas.dt;
-        glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
-        glBindVertexArray(moedas.VAO);
-        glBindTexture(GL_TEXTURE_2D, moedas.texID);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        // Moedas por cima do personagem, como antes
+        RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_SPRITES, 1, shaderID, moedas.texID),
+            shaderID, moedas.VAO, moedas.texID, GL_TRIANGLE_STRIP, 0, 4);
+        cmd.setModel(locModel, value_ptr(model));
+        cmd.setParam(locOffsetTex, 2, offsetTex.s, offsetTex.t);
     }
 }
 
-// Função para desenhar o great_jare_spirit
-void desenharGreatJareSpirit(GLuint shaderID) {
-    if (!greatJareSpirit_ativo) return;
-    // Desenha centralizando o centro do sprite no centro do tile (13,11)
-    Tile tile_central = tileset[6];
-    float tile_w = tile_central.dimensions.x;
-    float tile_h = tile_central.dimensions.y;
-    float tela_cx = WIDTH / 2.0f;
-    float tela_cy = HEIGHT / 2.0f;
-    float x0 = tela_cx - (pos.x - pos.y) * tile_w / 2.0f - tile_w / 2.0f;
-    float y0 = tela_cy - (pos.x + pos.y) * tile_h / 2.0f;
-    int j = 13, k = 11;
-    float x = x0 + (j - k) * tile_w / 2.0f;
-    float y = y0 + (j + k) * tile_h / 2.0f;
-    // Centraliza o sprite no tile
-    x = x + tile_w / 2.0f - greatJareSpirit.dimensions.x / 2.0f;
-    y = y + tile_h / 2.0f - greatJareSpirit.dimensions.y / 2.0f;
-    mat4 model = mat4(1);
-    model = translate(model, vec3(x, y, 0.0));
-    model = scale(model, greatJareSpirit.dimensions);
-    glUniformMatrix4fv(glGetUniformLocation(shaderID, "model"), 1, GL_FALSE, value_ptr(model));
-    vec2 offsetTex;
-    offsetTex.s = 0.0f;
-    offsetTex.t = 0.0f;
-    glUniform2f(glGetUniformLocation(shaderID, "offsetTex"), offsetTex.s, offsetTex.t);
-    glBindVertexArray(greatJareSpirit.VAO);
-    glBindTexture(GL_TEXTURE_2D, greatJareSpirit.texID);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+// O great_jare_spirit fica parado no tile (13,11): a model é montada uma vez
+void posicionaGreatJareSpirit() {
+    // Centraliza o centro do sprite no centro do tile
+    vec2 p = noMundo(vec2(13, 11));
+    float x = p.x - greatJareSpirit.dimensions.x / 2.0f;
+    float y = p.y + TILE_ALTURA / 2.0f - greatJareSpirit.dimensions.y / 2.0f;
+    modelGreatJareSpirit = translate(mat4(1), vec3(x, y, 0.0));
+    modelGreatJareSpirit = scale(modelGreatJareSpirit, greatJareSpirit.dimensions);
 }
 
-// Função genérica para animar e liberar tile
-void liberarTileComAnimacao(int x, int y, bool &evento_ativado) {
-    if (!evento_ativado) {
-        animarTrocaTile(x, y, 0); // anima para chão
-        barreiras[x][y] = 0; // libera barreira
-        evento_ativado = true;
-        cout << "[LOG] Evento especial em (" << x << "," << y << "): ANIMANDO tile para liberar!" << std::endl;
-    }
-}
-
-// Função para coletar moeda
-void coletarMoeda(int indice) {
-    moedasMapa[indice].ativa = false;
-    pontuacao += 340;
-    std::cout << "Voce coletou uma moeda! Pontuação: " << pontuacao << std::endl;
-    animarTrocaTile(moedasMapa[indice].x, moedasMapa[indice].y, 5);
+// Função para desenhar o great_jare_spirit
+void gravarGreatJareSpirit(RenderCommandList &lista, GLuint shaderID) {
+    if (!retrato->greatJareSpirit_ativo) return;
+    RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_SPRITES, 2, shaderID, greatJareSpirit.texID),
+        shaderID, greatJareSpirit.VAO, greatJareSpirit.texID, GL_TRIANGLE_STRIP, 0, 4);
+    cmd.setModel(locModel, value_ptr(modelGreatJareSpirit));
+    cmd.setParam(locOffsetTex, 2, 0.0f, 0.0f);
 }
 
-#include "../../include/glad/stb_easy_font.h"
-
-// Função utilitária para desenhar texto usando stb_easy_font e OpenGL moderno
-void drawText_GL33(float x, float y, const char* text, float r, float g, float b, float scale) {
-    static GLuint vbo = 0, vao = 0;
-    static GLuint shader = 0;
-    static GLint uniColor = -1, uniProjection = -1;
-
-    char buffer[99999];
-    int num_quads = stb_easy_font_print(0, 0, (char*)text, NULL, buffer, sizeof(buffer));
+// Barra superior e textos do HUD; no fim de jogo, a mensagem no lugar dos avisos
+void gravarHud(RenderCommandList &lista, GLuint shaderID, bool fimDeJogo) {
+    // --- TOP BAR COMO FUNDO DO HUD ---
+    float x = ((topBar.dimensions.x) / 3 )* 2;
+    float y = 30.0f; // topo da janela
+    mat4 model = mat4(1);
+    model = translate(model, vec3(x, y, 0.0f));
+    model = scale(model, topBar.dimensions);
+    RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_HUD, 0, shaderID, topBar.texID),
+        shaderID, topBar.VAO, topBar.texID, GL_TRIANGLE_STRIP, 0, 4);
+    cmd.setModel(locModelHud, value_ptr(model));
+    cmd.setParam(locOffsetTexHud, 2, topBar.iFrame * topBar.ds, topBar.iAnimation * topBar.dt);
+
+    // --- TEXTOS ---
+    char info[128];
+    float y_hud = 25.0f;
+    // Pontos à esquerda
+    sprintf(info, "Pontos: %.0f", retrato->pontuacao);
+    gravarTexto(lista, WIDTH/2 - 260, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
+    // Vidas ao centro
+    sprintf(info, "Vidas: %d", retrato->vidas);
+    gravarTexto(lista, WIDTH/2 - 40, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
+    // Tempo à direita
+    sprintf(info, "Tempo: %.1fs", retrato->tempo_jogo);
+    gravarTexto(lista, WIDTH/2 + 140, y_hud, info, 0.878f, 0.235f, 0.157f, 2.0f);
+
+    if (fimDeJogo) {
+        // --- Mensagem de fim de jogo ---
+        const char* msg = retrato->jogador_ganhou ? "VOCE GANHOU!" : "GAME OVER";
+        // Centralização simples, igual ao HUD
+        gravarTexto(lista, WIDTH/2-120, HEIGHT/2-40, msg, 1, 1, 0, 3.0f);
+        gravarTexto(lista, WIDTH/2-190, HEIGHT/2+20, "Pressione ENTER para reiniciar.", 1, 1, 1, 2.0f);
+        return;
+    }
 
-    // Aplica escala nos vértices
-    float* verts = (float*)buffer;
-    for (int i = 0; i < num_quads * 4; ++i) {
-        verts[i * 4 + 0] = verts[i * 4 + 0] * scale + x;
-        verts[i * 4 + 1] = verts[i * 4 + 1] * scale + y;
+    // --- MENSAGEM TEMPORÁRIA DE MORTE NA LAVA ---
+    if (retrato->mensagemLava[0] != '\0') {
+        gravarTexto(lista, WIDTH/2-200, HEIGHT/2-100, retrato->mensagemLava, 1, 0.2f, 0.2f, 2.5f);
     }
 
-    if (shader == 0) {
-        // Vertex shader simples para 2D
-        const char* vs =
-            "#version 330 core\n"
-            "layout(location=0) in vec2 pos;\n"
-            "uniform mat4 projection;\n"
-            "void main(){ gl_Position = projection * vec4(pos,0,1); }\n";
-        // Fragment shader simples para cor uniforme
-        const char* fs =
-            "#version 330 core\n"
-            "uniform vec3 color;\n"
-            "out vec4 FragColor;\n"
-            "void main(){ FragColor = vec4(color,1); }\n";
-        GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
-        GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(vsId, 1, &vs, NULL); glCompileShader(vsId);
-        glShaderSource(fsId, 1, &fs, NULL); glCompileShader(fsId);
-        shader = glCreateProgram();
-        glAttachShader(shader, vsId); glAttachShader(shader, fsId);
-        glLinkProgram(shader);
-        glDeleteShader(vsId); glDeleteShader(fsId);
-        uniColor = glGetUniformLocation(shader, "color");
-        uniProjection = glGetUniformLocation(shader, "projection");
+    // Latência de entrada no rodapé
+    if (latenciaEntrada.amostras > 0) {
+        sprintf(info, "Latencia: %.1f ms (media %.1f, max %.1f)", latenciaEntrada.ultima * 1000.0,
+                latenciaEntrada.media() * 1000.0, latenciaEntrada.maxima * 1000.0);
+        gravarTexto(lista, 10, HEIGHT - 20, info, 0.8f, 0.8f, 0.8f, 1.5f);
     }
+}
 
-    if (vao == 0) {
-        glGenVertexArrays(1, &vao);
-        glGenBuffers(1, &vbo);
+// Imprime a grade de barreiras no mesmo formato do arquivo
+void imprimeBarreiras() {
+    for (int y = 0; y < TILEMAP_HEIGHT; y++) {
+        for (int x = 0; x < TILEMAP_WIDTH; x++) {
+            std::cout << (sim.gradeCaminhavel.isWalkable(x, y) ? 0 : 1);
+            if (x < TILEMAP_WIDTH - 1)
+                std::cout << ",";
+        }
+        std::cout << std::endl;
     }
+}
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, num_quads * 4 * 16, buffer, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 16, (void*)0);
 
-    glUseProgram(shader);
+#include "../../include/glad/stb_easy_font.h"
 
-    // Projeção ortográfica para 2D
+// Shader e VAO do texto; o VAO lê os vértices do buffer de streaming
+void preparaTexto() {
+    // Vertex shader simples para 2D
+    const char* vs =
+        "#version 330 core\n"
+        "layout(location=0) in vec2 pos;\n"
+        "uniform mat4 projection;\n"
+        "void main(){ gl_Position = projection * vec4(pos,0,1); }\n";
+    // Fragment shader simples para cor uniforme
+    const char* fs =
+        "#version 330 core\n"
+        "uniform vec3 color;\n"
+        "out vec4 FragColor;\n"
+        "void main(){ FragColor = vec4(color,1); }\n";
+    GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
+    GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(vsId, 1, &vs, NULL); glCompileShader(vsId);
+    glShaderSource(fsId, 1, &fs, NULL); glCompileShader(fsId);
+    textoShader = glCreateProgram();
+    glAttachShader(textoShader, vsId); glAttachShader(textoShader, fsId);
+    glLinkProgram(textoShader);
+    glDeleteShader(vsId); glDeleteShader(fsId);
+    textoCor = glGetUniformLocation(textoShader, "color");
+
+    // Projeção ortográfica para 2D; a janela não muda de tamanho
     float ortho[16] = {
         2.0f/WIDTH, 0, 0, 0,
         0, -2.0f/HEIGHT, 0, 0,
         0, 0, -1, 0,
         -1, 1, 0, 1
     };
-    glUniformMatrix4fv(uniProjection, 1, GL_FALSE, ortho);
-    glUniform3f(uniColor, r, g, b);
-
-    glDrawArrays(GL_QUADS, 0, num_quads * 4);
+    glUseProgram(textoShader);
+    glUniformMatrix4fv(glGetUniformLocation(textoShader, "projection"), 1, GL_FALSE, ortho);
 
+    glGenVertexArrays(1, &textoVAO);
+    glBindVertexArray(textoVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, g_streamBuffer.getBuffer());
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 16, (void*)0);
     glBindVertexArray(0);
-    glUseProgram(0);
+}
+
+// Gera os quads do texto com stb_easy_font direto no bloco de vértices da lista
+void gravarTexto(RenderCommandList &lista, float x, float y, const char* text, float r, float g, float b, float scale) {
+    char buffer[99999];
+    int num_quads = stb_easy_font_print(0, 0, (char*)text, NULL, buffer, sizeof(buffer));
+    if (num_quads == 0) return;
+
+    // Aplica escala nos vértices
+    GLint primeiro;
+    float* destino = (float*)lista.vertices(num_quads * 4, 16, primeiro);
+    const float* verts = (const float*)buffer;
+    for (int i = 0; i < num_quads * 4; ++i) {
+        destino[i * 4 + 0] = verts[i * 4 + 0] * scale + x;
+        destino[i * 4 + 1] = verts[i * 4 + 1] * scale + y;
+        destino[i * 4 + 2] = verts[i * 4 + 2];
+        destino[i * 4 + 3] = verts[i * 4 + 3];
+    }
+
+    // Textos por cima da barra
+    RenderCommand &cmd = lista.draw(RenderCommand::makeKey(CAMADA_HUD, 1, textoShader, 0),
+        textoShader, textoVAO, 0, GL_QUADS, primeiro, num_quads * 4);
+    cmd.stride = 16;
+    cmd.setParam(textoCor, 3, r, g, b);
 }
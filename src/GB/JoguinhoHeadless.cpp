@@ -0,0 +1,275 @@
+/*
+ * JoguinhoHeadless.cpp
+ *
+ * Roda a simulação do Joguinho (Simulacao.h) sem janela nem OpenGL, a passo
+ * fixo e o mais rápido possível. Serve para medir o custo da lógica, repetir
+ * uma sequência de teclas e conferir que duas execuções terminam no mesmo
+ * estado (o hash impresso no final tem que ser igual).
+ *
+ * Uso:
+ *   ./JoguinhoHeadless [roteiro.txt] [--ticks N] [--aleatorio semente] [--mapas pasta/]
+ *                      [--gravar arquivo.jrp] [--carregar jogo.sav] [--autosave jogo.sav]
+ *                      [--duracao-passo segundos]
+ *   ./JoguinhoHeadless --replay arquivo.jrp [--tempo-real] [--mapas pasta/]
+ *
+ * Roteiro: uma entrada por linha, "<tick> press|release <W|Q|A|Z|S|C|D|E>".
+ * Linhas vazias ou começando com '#' são ignoradas. Com --aleatorio, um
+ * jogador automático aperta direções sorteadas; quando a partida acaba, o
+ * jogo é reiniciado e a rodada continua até completar os ticks.
+ *
+ * --replay reproduz uma sessão gravada (pelo Joguinho ou com --gravar) e
+ * confere o hash do estado final com o gravado; retorna 1 se divergir.
+ * Sem --tempo-real os passos rodam sem pausa, para comparar builds.
+ *
+ * --duracao-passo muda quanto o Migoré leva de um tile ao vizinho (padrão
+ * 0.15 s); a gravação guarda o valor e o replay usa o gravado.
+ *
+ * --carregar parte de um jogo salvo; --autosave salva a cada passo de tile
+ * terminado, como o Joguinho, e mede quanto cada pedido custa para quem
+ * simula (a escrita em si fica na thread do salvamento).
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "Simulacao.h"
+#include "Replay.h"
+#include "Salvamento.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Relogio;
+
+struct EntradaRoteiro {
+	long long tick;
+	int direcao;
+	int acao;
+};
+
+// Mesma numeração de EstadoMigore::direcao
+static int direcaoDaLetra(char c)
+{
+	switch (toupper((unsigned char)c)) {
+	case 'W': return 0;
+	case 'Q': return 1;
+	case 'A': return 2;
+	case 'Z': return 3;
+	case 'S': return 4;
+	case 'C': return 5;
+	case 'D': return 6;
+	case 'E': return 7;
+	}
+	return -1;
+}
+
+static bool leRoteiro(const string &caminho, vector<EntradaRoteiro> &roteiro)
+{
+	ifstream arquivo(caminho);
+	if (!arquivo.is_open()) {
+		cerr << "Erro ao abrir o roteiro: " << caminho << endl;
+		return false;
+	}
+	string linha;
+	int numero = 0;
+	while (getline(arquivo, linha)) {
+		numero++;
+		if (linha.empty() || linha[0] == '#') continue;
+		istringstream campos(linha);
+		EntradaRoteiro e;
+		string acao, tecla;
+		if (!(campos >> e.tick >> acao >> tecla) || tecla.size() != 1 ||
+			(e.direcao = direcaoDaLetra(tecla[0])) < 0 || (acao != "press" && acao != "release")) {
+			cerr << "Linha " << numero << " invalida no roteiro: " << linha << endl;
+			return false;
+		}
+		e.acao = acao == "press" ? ENTRADA_PRESSIONA : ENTRADA_SOLTA;
+		roteiro.push_back(e);
+	}
+	stable_sort(roteiro.begin(), roteiro.end(),
+		[](const EntradaRoteiro &a, const EntradaRoteiro &b) { return a.tick < b.tick; });
+	return true;
+}
+
+static void imprimeResultado(const Simulacao &sim, long long ticks, double segundos)
+{
+	printf("Ticks: %lld em %.3f s (%.0f ticks/s, %.1fx tempo real)\n",
+		ticks, segundos, ticks / segundos, ticks * Simulacao::PASSO / segundos);
+	printf("Estado final: tile (%d,%d), pontuacao %.0f, vidas %d, tempo %.2f s%s%s\n",
+		sim.pos.x, sim.pos.y, sim.pontuacao, sim.vidas, sim.tempo_jogo,
+		sim.jogador_ganhou ? ", ganhou" : "", sim.jogador_perdeu ? ", perdeu" : "");
+	printf("Hash do estado: %016llx\n", (unsigned long long)sim.hashEstado());
+}
+
+// Reproduz a sessão gravada; o tempo real só espera entre os passos
+static int reproduz(const string &caminho, const string &pastaMapas, bool tempoReal)
+{
+	ReprodutorReplay replay;
+	if (!replay.abre(caminho)) return 1;
+
+	Simulacao sim;
+	sim.verboso = false;
+	sim.defineSemente(replay.getSemente());
+	sim.defineDuracaoPasso(replay.getDuracaoPasso());
+	if (!sim.carregaMapas(pastaMapas)) return 1;
+	if (replay.getEstadoInicial() && !sim.importa(*replay.getEstadoInicial())) {
+		printf("ERRO: estado inicial do replay invalido\n");
+		return 1;
+	}
+
+	long long ticks = 0;
+	Relogio::time_point t0 = Relogio::now();
+	while (replay.aplica(sim)) {
+		sim.passo(Simulacao::PASSO);
+		ticks++;
+		if (tempoReal)
+			this_thread::sleep_until(t0 + chrono::duration_cast<Relogio::duration>(
+				chrono::duration<double>(ticks * Simulacao::PASSO)));
+	}
+	double segundos = chrono::duration<double>(Relogio::now() - t0).count();
+
+	printf("Replay %s: %zu registros, semente %llu\n", caminho.c_str(),
+		replay.getRegistros(), (unsigned long long)replay.getSemente());
+	imprimeResultado(sim, ticks, segundos);
+	if (!replay.temHashFinal()) {
+		printf("Replay sem hash final (sessao interrompida): nada a conferir\n");
+		return 0;
+	}
+	if (!replay.confere(sim)) {
+		printf("ERRO: estado final difere do gravado\n");
+		return 1;
+	}
+	printf("Estado final igual ao gravado\n");
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	string caminhoRoteiro, caminhoReplay, caminhoGravacao, caminhoCarregar, caminhoAutosave;
+	string pastaMapas = "../assets/maps/";
+	long long totalTicks = -1;
+	bool aleatorio = false, tempoReal = false;
+	unsigned semente = 1;
+	double duracaoPasso = Simulacao::DURACAO_PASSO_TILE_PADRAO;
+
+	for (int i = 1; i < argc; i++) {
+		if (!strcmp(argv[i], "--ticks") && i + 1 < argc) totalTicks = atoll(argv[++i]);
+		else if (!strcmp(argv[i], "--aleatorio") && i + 1 < argc) { aleatorio = true; semente = (unsigned)strtoul(argv[++i], NULL, 10); }
+		else if (!strcmp(argv[i], "--mapas") && i + 1 < argc) pastaMapas = argv[++i];
+		else if (!strcmp(argv[i], "--replay") && i + 1 < argc) caminhoReplay = argv[++i];
+		else if (!strcmp(argv[i], "--gravar") && i + 1 < argc) caminhoGravacao = argv[++i];
+		else if (!strcmp(argv[i], "--tempo-real")) tempoReal = true;
+		else if (!strcmp(argv[i], "--carregar") && i + 1 < argc) caminhoCarregar = argv[++i];
+		else if (!strcmp(argv[i], "--autosave") && i + 1 < argc) caminhoAutosave = argv[++i];
+		else if (!strcmp(argv[i], "--duracao-passo") && i + 1 < argc) duracaoPasso = atof(argv[++i]);
+		else if (argv[i][0] != '-') caminhoRoteiro = argv[i];
+		else {
+			cerr << "Uso: " << argv[0] << " [roteiro.txt] [--ticks N] [--aleatorio semente] [--mapas pasta/] [--gravar arquivo.jrp]"
+				 << " [--carregar jogo.sav] [--autosave jogo.sav] [--duracao-passo segundos]" << endl;
+			cerr << "     " << argv[0] << " --replay arquivo.jrp [--tempo-real] [--mapas pasta/]" << endl;
+			return 2;
+		}
+	}
+
+	if (pastaMapas.back() != '/') pastaMapas += '/';
+	if (!caminhoReplay.empty()) return reproduz(caminhoReplay, pastaMapas, tempoReal);
+
+	vector<EntradaRoteiro> roteiro;
+	if (!caminhoRoteiro.empty() && !leRoteiro(caminhoRoteiro, roteiro)) return 1;
+	if (totalTicks < 0)
+		totalTicks = roteiro.empty() ? 120 * 60 : roteiro.back().tick + 120 * 5; // sobra para o último passo terminar
+
+	// O jogador automático usa rand(); a simulação tem o próprio sorteio
+	srand(semente);
+
+	Simulacao sim;
+	sim.verboso = false;
+	sim.defineSemente(semente);
+	sim.defineDuracaoPasso(duracaoPasso);
+	if (!sim.carregaMapas(pastaMapas)) return 1;
+
+	EstadoSalvo salvo;
+	bool carregado = false;
+	if (!caminhoCarregar.empty()) {
+		if (!carregaEstado(caminhoCarregar, salvo) || !sim.importa(salvo)) return 1;
+		carregado = true;
+	}
+
+	GravadorReplay gravador;
+	if (!caminhoGravacao.empty()) {
+		if (!gravador.abre(caminhoGravacao, sim, carregado ? &salvo : nullptr)) return 1;
+		sim.gravador = &gravador;
+	}
+
+	long long movimentosSalvos = sim.movimentosConcluidos;
+	int salvamentos = 0;
+	double msSalvando = 0.0, msSalvamentoMax = 0.0;
+	SalvamentoEmSegundoPlano salvador(caminhoAutosave.empty() ? "joguinho.sav" : caminhoAutosave);
+
+	size_t proxima = 0;
+	long long ticksRodados = 0;
+	int partidas = 1, vitorias = 0, derrotas = 0;
+	int direcaoBot = -1;
+	Relogio::time_point t0 = Relogio::now();
+
+	for (long long t = 0; t < totalTicks; t++) {
+		double tempo = t * Simulacao::PASSO;
+		while (proxima < roteiro.size() && roteiro[proxima].tick <= t) {
+			sim.entrada(roteiro[proxima].direcao, roteiro[proxima].acao, tempo);
+			proxima++;
+		}
+
+		// Jogador automático: segura uma direção por um tempo e troca
+		if (aleatorio && t % 30 == 0) {
+			if (direcaoBot >= 0) sim.entrada(direcaoBot, ENTRADA_SOLTA, tempo);
+			direcaoBot = rand() % 8;
+			sim.entrada(direcaoBot, ENTRADA_PRESSIONA, tempo);
+		}
+
+		sim.passo(Simulacao::PASSO);
+		ticksRodados++;
+
+		if (!caminhoAutosave.empty() && sim.movimentosConcluidos != movimentosSalvos && !sim.fimDeJogo()) {
+			Relogio::time_point s0 = Relogio::now();
+			salvador.pede(sim);
+			double ms = chrono::duration<double, milli>(Relogio::now() - s0).count();
+			msSalvando += ms;
+			msSalvamentoMax = max(msSalvamentoMax, ms);
+			salvamentos++;
+			movimentosSalvos = sim.movimentosConcluidos;
+		}
+
+		if (sim.fimDeJogo()) {
+			if (sim.jogador_ganhou) vitorias++;
+			if (sim.jogador_perdeu) derrotas++;
+			if (!aleatorio) break;
+			sim.reinicia();
+			direcaoBot = -1;
+			partidas++;
+		}
+	}
+
+	double segundos = chrono::duration<double>(Relogio::now() - t0).count();
+
+	if (gravador.aberto()) {
+		gravador.fecha(sim);
+		printf("Gravado em %s: %zu registros\n", caminhoGravacao.c_str(), gravador.getRegistros());
+	}
+	if (salvamentos) {
+		salvador.espera();
+		printf("Autosave: %d pedidos (%d gravados) de %zu bytes, media %.4f ms, max %.4f ms por pedido\n",
+			salvamentos, salvador.getGravacoes(), sizeof(EstadoSalvo), msSalvando / salvamentos, msSalvamentoMax);
+	}
+	printf("Partidas: %d (vitorias %d, derrotas %d)\n", partidas, vitorias, derrotas);
+	imprimeResultado(sim, ticksRodados, segundos);
+	return 0;
+}
@@ -0,0 +1,194 @@
+//
+//  Replay.cpp
+//  Escrita e leitura do arquivo de replay (formato em Replay.h).
+//
+
+#include "Replay.h"
+
+#include <iostream>
+#include <string.h>
+
+static const char MAGICO_REPLAY[4] = { 'J', 'R', 'P', 'L' };
+static const size_t TAMANHO_BUFFER_REPLAY = 4096;
+
+static void escreveInteiro(std::vector<uint8_t> &b, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++)
+        b.push_back((uint8_t)(v >> (8 * i)));
+}
+
+static bool leInteiro(const std::vector<uint8_t> &b, size_t &i, int bytes, uint64_t &v) {
+    if (i + bytes > b.size()) return false;
+    v = 0;
+    for (int k = 0; k < bytes; k++)
+        v |= (uint64_t)b[i + k] << (8 * k);
+    i += bytes;
+    return true;
+}
+
+GravadorReplay::GravadorReplay() : arquivo(nullptr), ultimoTick(0), registros(0) {
+}
+
+GravadorReplay::~GravadorReplay() {
+    if (!arquivo) return;
+    descarrega();
+    fclose(arquivo);
+}
+
+bool GravadorReplay::abre(const std::string &caminho, const Simulacao &sim, const EstadoSalvo *inicial) {
+    if (arquivo) {
+        descarrega();
+        fclose(arquivo);
+    }
+    arquivo = fopen(caminho.c_str(), "wb");
+    if (!arquivo) {
+        std::cerr << "Erro ao criar o replay: " << caminho << std::endl;
+        return false;
+    }
+    buffer.clear();
+    for (int i = 0; i < 4; i++) buffer.push_back((uint8_t)MAGICO_REPLAY[i]);
+    escreveInteiro(buffer, REPLAY_VERSAO, 2);
+    escreveInteiro(buffer, sim.getSemente(), 8);
+    double duracao = sim.getDuracaoPasso();
+    uint64_t bits;
+    memcpy(&bits, &duracao, 8);
+    escreveInteiro(buffer, bits, 8);
+    buffer.push_back(inicial ? 1 : 0);
+    if (inicial) {
+        const uint8_t *p = (const uint8_t *)inicial;
+        buffer.insert(buffer.end(), p, p + sizeof(EstadoSalvo));
+    }
+    ultimoTick = 0;
+    registros = 0;
+    return true;
+}
+
+void GravadorReplay::entrada(long long tick, int direcao, int acao) {
+    registro((uint8_t)(direcao | acao << 3), tick);
+}
+
+void GravadorReplay::reinicio(long long tick) {
+    registro(REPLAY_REINICIO, tick);
+    ultimoTick = 0;
+}
+
+void GravadorReplay::fecha(const Simulacao &sim) {
+    if (!arquivo) return;
+    registro(REPLAY_FIM, sim.ticks);
+    escreveInteiro(buffer, sim.hashEstado(), 8);
+    descarrega();
+    fclose(arquivo);
+    arquivo = nullptr;
+}
+
+// Código e avanço em LEB128: uma tecla típica ocupa 2 ou 3 bytes
+void GravadorReplay::registro(uint8_t codigo, long long tick) {
+    if (!arquivo) return;
+    uint64_t delta = tick > ultimoTick ? (uint64_t)(tick - ultimoTick) : 0;
+    ultimoTick = tick;
+    buffer.push_back(codigo);
+    do {
+        uint8_t b = delta & 0x7F;
+        delta >>= 7;
+        buffer.push_back(delta ? (b | 0x80) : b);
+    } while (delta);
+    registros++;
+    if (buffer.size() >= TAMANHO_BUFFER_REPLAY) descarrega();
+}
+
+void GravadorReplay::descarrega() {
+    if (buffer.empty()) return;
+    fwrite(buffer.data(), 1, buffer.size(), arquivo);
+    fflush(arquivo);
+    buffer.clear();
+}
+
+ReprodutorReplay::ReprodutorReplay()
+    : proximo(0), semente(1), duracaoPasso(Simulacao::DURACAO_PASSO_TILE_PADRAO), temEstadoInicial(false),
+      hashGravado(false), hashFinal(0) {
+}
+
+bool ReprodutorReplay::abre(const std::string &caminho) {
+    FILE *f = fopen(caminho.c_str(), "rb");
+    if (!f) {
+        std::cerr << "Erro ao abrir o replay: " << caminho << std::endl;
+        return false;
+    }
+    std::vector<uint8_t> dados;
+    uint8_t bloco[TAMANHO_BUFFER_REPLAY];
+    size_t n;
+    while ((n = fread(bloco, 1, sizeof(bloco), f)) > 0)
+        dados.insert(dados.end(), bloco, bloco + n);
+    fclose(f);
+
+    size_t i = 4;
+    uint64_t versao = 0;
+    if (dados.size() < 23 || memcmp(dados.data(), MAGICO_REPLAY, 4) != 0 ||
+        !leInteiro(dados, i, 2, versao) || versao != REPLAY_VERSAO) {
+        std::cerr << "Arquivo de replay invalido ou de outra versao: " << caminho << std::endl;
+        return false;
+    }
+    leInteiro(dados, i, 8, semente);
+    uint64_t bits;
+    leInteiro(dados, i, 8, bits);
+    memcpy(&duracaoPasso, &bits, 8);
+    temEstadoInicial = dados[i++] != 0;
+    if (temEstadoInicial) {
+        if (i + sizeof(EstadoSalvo) > dados.size()) {
+            std::cerr << "Replay truncado no estado inicial: " << caminho << std::endl;
+            return false;
+        }
+        memcpy(&estadoInicial, &dados[i], sizeof(EstadoSalvo));
+        i += sizeof(EstadoSalvo);
+    }
+
+    registros.clear();
+    proximo = 0;
+    hashGravado = false;
+    long long tick = 0;
+    while (i < dados.size()) {
+        uint8_t codigo = dados[i++];
+        uint64_t delta = 0;
+        int desloc = 0;
+        bool completo = false;
+        while (i < dados.size() && desloc < 64) {
+            uint8_t b = dados[i++];
+            delta |= (uint64_t)(b & 0x7F) << desloc;
+            desloc += 7;
+            if (!(b & 0x80)) {
+                completo = true;
+                break;
+            }
+        }
+        if (!completo) break;   // sessão interrompida no meio de um registro
+        tick += (long long)delta;
+        Registro r = { tick, codigo };
+        registros.push_back(r);
+        if (codigo == REPLAY_REINICIO) tick = 0;
+        if (codigo == REPLAY_FIM) {
+            hashGravado = leInteiro(dados, i, 8, hashFinal);
+            break;
+        }
+    }
+    return true;
+}
+
+bool ReprodutorReplay::aplica(Simulacao &sim) {
+    while (proximo < registros.size() && registros[proximo].tick <= sim.ticks) {
+        const Registro &r = registros[proximo];
+        if (r.codigo == REPLAY_FIM) {
+            proximo = registros.size();
+            return false;
+        }
+        proximo++;
+        if (r.codigo == REPLAY_REINICIO)
+            sim.reinicia();
+        else
+            sim.entrada(r.codigo & 7, r.codigo >> 3, -1.0);
+    }
+    // Parada no fim de jogo sem o reinício gravado: a reprodução divergiu
+    return proximo < registros.size() && !sim.fimDeJogo();
+}
+
+bool ReprodutorReplay::confere(const Simulacao &sim) const {
+    return !hashGravado || sim.hashEstado() == hashFinal;
+}
@@ -0,0 +1,115 @@
+//
+//  Replay.h
+//  Gravação e reprodução das entradas do Joguinho.
+//
+//  O arquivo guarda só o que entra na simulação: cada tecla com o tick em
+//  que foi consumida e cada reinício de partida. Com a mesma semente de
+//  sorteio, reproduzir o arquivo leva a Simulacao pelos mesmos estados, com
+//  ou sem janela, em tempo real ou o mais rápido possível.
+//
+//  Formato (little-endian):
+//    cabeçalho: "JRPL", versão (u16), semente (u64), duração do passo de
+//      tile (f64), tem estado inicial (u8) e, se tiver, o EstadoSalvo de
+//      onde a sessão partiu (jogo carregado)
+//    registros: código (u8) + ticks desde o registro anterior (LEB128)
+//      0..15            tecla: direcao | acao << 3
+//      REPLAY_REINICIO  reinício de partida; a contagem de ticks volta a zero
+//      REPLAY_FIM       fim da sessão, seguido do hash do estado final (u64)
+//
+
+#ifndef Replay_h
+#define Replay_h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "Simulacao.h"
+
+const uint16_t REPLAY_VERSAO = 3;
+const uint8_t REPLAY_REINICIO = 0xF0;
+const uint8_t REPLAY_FIM = 0xFF;
+
+class GravadorReplay {
+public:
+    GravadorReplay();
+    ~GravadorReplay();
+
+    // Começa um arquivo novo (fechando o anterior, se houver) com a semente e
+    // a duração do passo da simulação. "inicial" é o estado de onde a sessão
+    // parte quando não é o começo da partida.
+    bool abre(const std::string &caminho, const Simulacao &sim, const EstadoSalvo *inicial = nullptr);
+    bool aberto() const {
+        return arquivo != nullptr;
+    }
+
+    // Chamados pela Simulacao: "tick" é quantos passos a partida já tinha dado
+    void entrada(long long tick, int direcao, int acao);
+    void reinicio(long long tick);
+
+    // Grava o fim com o estado final da simulação e fecha o arquivo
+    void fecha(const Simulacao &sim);
+
+    size_t getRegistros() const {
+        return registros;
+    }
+
+private:
+    FILE *arquivo;
+    std::vector<uint8_t> buffer;
+    long long ultimoTick;
+    size_t registros;
+
+    void registro(uint8_t codigo, long long tick);
+    void descarrega();
+};
+
+class ReprodutorReplay {
+public:
+    ReprodutorReplay();
+
+    // Lê o arquivo inteiro para a memória
+    bool abre(const std::string &caminho);
+
+    uint64_t getSemente() const {
+        return semente;
+    }
+    double getDuracaoPasso() const {
+        return duracaoPasso;
+    }
+    const EstadoSalvo *getEstadoInicial() const {
+        return temEstadoInicial ? &estadoInicial : nullptr;
+    }
+
+    // Entrega à simulação os registros marcados para antes do próximo passo.
+    // Retorna false quando o replay acabou (ou a simulação parou antes do
+    // próximo registro, o que só acontece se ela divergiu da gravação).
+    bool aplica(Simulacao &sim);
+
+    // Sem hash gravado (sessão interrompida) não há o que conferir
+    bool temHashFinal() const {
+        return hashGravado;
+    }
+    bool confere(const Simulacao &sim) const;
+
+    size_t getRegistros() const {
+        return registros.size();
+    }
+
+private:
+    struct Registro {
+        long long tick;   // ticks da partida em que o registro vale
+        uint8_t codigo;
+    };
+    std::vector<Registro> registros;
+    size_t proximo;
+    uint64_t semente;
+    double duracaoPasso;
+    bool temEstadoInicial;
+    EstadoSalvo estadoInicial;
+    bool hashGravado;
+    uint64_t hashFinal;
+};
+
+#endif /* Replay_h */
@@ -0,0 +1,132 @@
+//
+//  Salvamento.cpp
+//  Escrita atômica e leitura sem parsing do jogo salvo.
+//
+
+#include "Salvamento.h"
+
+#include <iostream>
+#include <filesystem>
+#include <stddef.h>
+#include <stdio.h>
+
+static_assert(sizeof(EstadoSalvo) == 1464, "EstadoSalvo mudou de layout: suba SALVAMENTO_VERSAO");
+
+static uint32_t checksumEstado(const EstadoSalvo &e) {
+    const uint8_t *p = (const uint8_t *)&e;
+    size_t inicio = offsetof(EstadoSalvo, checksum) + sizeof(e.checksum);
+    uint32_t h = 2166136261u;
+    for (size_t i = inicio; i < sizeof(e); i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool salvaEstado(const std::string &caminho, EstadoSalvo &e) {
+    e.magico = SALVAMENTO_MAGICO;
+    e.versao = SALVAMENTO_VERSAO;
+    e.reservado = 0;
+    e.tamanho = sizeof(EstadoSalvo);
+    e.checksum = checksumEstado(e);
+
+    std::string temporario = caminho + ".tmp";
+    FILE *f = fopen(temporario.c_str(), "wb");
+    if (!f) {
+        std::cerr << "Erro ao salvar o jogo em " << temporario << std::endl;
+        return false;
+    }
+    bool ok = fwrite(&e, sizeof(e), 1, f) == 1;
+    ok = fclose(f) == 0 && ok;
+    if (!ok) {
+        std::cerr << "Erro ao salvar o jogo em " << temporario << std::endl;
+        return false;
+    }
+
+    std::error_code erro;
+    std::filesystem::rename(temporario, caminho, erro);
+    if (erro) {
+        std::cerr << "Erro ao trocar " << temporario << " por " << caminho << ": " << erro.message() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool carregaEstado(const std::string &caminho, EstadoSalvo &e) {
+    FILE *f = fopen(caminho.c_str(), "rb");
+    if (!f) return false;
+    bool lido = fread(&e, sizeof(e), 1, f) == 1;
+    fclose(f);
+    if (!lido || e.magico != SALVAMENTO_MAGICO || e.versao != SALVAMENTO_VERSAO ||
+        e.tamanho != sizeof(EstadoSalvo) || e.checksum != checksumEstado(e)) {
+        std::cerr << "Jogo salvo invalido ou de outra versao: " << caminho << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool salvaJogo(const std::string &caminho, const Simulacao &sim) {
+    EstadoSalvo e;
+    sim.exporta(e);
+    return salvaEstado(caminho, e);
+}
+
+bool carregaJogo(const std::string &caminho, Simulacao &sim) {
+    EstadoSalvo e;
+    if (!carregaEstado(caminho, e)) return false;
+    if (!sim.importa(e)) {
+        std::cerr << "Jogo salvo com valores fora do mapa: " << caminho << std::endl;
+        return false;
+    }
+    return true;
+}
+
+SalvamentoEmSegundoPlano::SalvamentoEmSegundoPlano(const std::string &caminho)
+    : caminho(caminho), temPendente(false), gravando(false), encerrar(false), gravacoes(0) {
+    trabalhador = std::thread(&SalvamentoEmSegundoPlano::executa, this);
+}
+
+SalvamentoEmSegundoPlano::~SalvamentoEmSegundoPlano() {
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        encerrar = true;
+    }
+    sinal.notify_all();
+    trabalhador.join();
+}
+
+void SalvamentoEmSegundoPlano::pede(const Simulacao &sim) {
+    {
+        std::lock_guard<std::mutex> guarda(trava);
+        sim.exporta(pendente);
+        temPendente = true;
+    }
+    sinal.notify_all();
+}
+
+void SalvamentoEmSegundoPlano::espera() {
+    std::unique_lock<std::mutex> guarda(trava);
+    sinal.wait(guarda, [this] { return !temPendente && !gravando; });
+}
+
+int SalvamentoEmSegundoPlano::getGravacoes() {
+    std::lock_guard<std::mutex> guarda(trava);
+    return gravacoes;
+}
+
+void SalvamentoEmSegundoPlano::executa() {
+    std::unique_lock<std::mutex> guarda(trava);
+    while (true) {
+        sinal.wait(guarda, [this] { return temPendente || encerrar; });
+        if (!temPendente) return;   // encerrar sem nada pendente
+        EstadoSalvo e = pendente;
+        temPendente = false;
+        gravando = true;
+        guarda.unlock();
+        salvaEstado(caminho, e);
+        guarda.lock();
+        gravando = false;
+        gravacoes++;
+        sinal.notify_all();
+    }
+}
@@ -0,0 +1,63 @@
+//
+//  Salvamento.h
+//  Gravação e leitura do jogo salvo (EstadoSalvo, em Simulacao.h).
+//
+//  A escrita vai para "<caminho>.tmp" e só depois troca de nome com o
+//  arquivo final, então uma queda no meio nunca deixa um salvamento pela
+//  metade. A leitura é um fread direto na struct seguido da conferência de
+//  mágico, versão, tamanho e checksum.
+//
+
+#ifndef Salvamento_h
+#define Salvamento_h
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Simulacao.h"
+
+// Preenche o cabeçalho de "e" e grava de forma atômica
+bool salvaEstado(const std::string &caminho, EstadoSalvo &e);
+
+// Lê e confere o arquivo; false se não existir ou não for válido
+bool carregaEstado(const std::string &caminho, EstadoSalvo &e);
+
+// Atalhos que passam pelo retrato da simulação
+bool salvaJogo(const std::string &caminho, const Simulacao &sim);
+bool carregaJogo(const std::string &caminho, Simulacao &sim);
+
+// Autosave sem travar o quadro: quem pede só copia o retrato (1,5 KB) e
+// segue; a escrita e a troca de nome acontecem numa thread própria. Pedidos
+// que chegam durante uma gravação se juntam no mais recente.
+class SalvamentoEmSegundoPlano {
+public:
+    explicit SalvamentoEmSegundoPlano(const std::string &caminho);
+    ~SalvamentoEmSegundoPlano();    // grava o que estiver pendente antes de sair
+
+    void pede(const Simulacao &sim);
+
+    // Espera a gravação pendente terminar (antes de ler ou apagar o arquivo)
+    void espera();
+
+    const std::string &getCaminho() const {
+        return caminho;
+    }
+    int getGravacoes();
+
+private:
+    std::string caminho;
+    std::mutex trava;
+    std::condition_variable sinal;
+    EstadoSalvo pendente;
+    bool temPendente;
+    bool gravando;
+    bool encerrar;
+    int gravacoes;
+    std::thread trabalhador;
+
+    void executa();
+};
+
+#endif /* Salvamento_h */
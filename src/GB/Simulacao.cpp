@@ -0,0 +1,635 @@
+//
+//  Simulacao.cpp
+//  Lógica do Joguinho: entrada, movimento, eventos do mapa e animações.
+//
+
+#include "Simulacao.h"
+#include "Replay.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <string.h>
+
+const double Simulacao::PASSO = 1.0 / 120.0;
+const double Simulacao::DURACAO_PASSO_TILE_PADRAO = 0.15;
+const double Simulacao::FPS_ANIMACAO_MIGORE = 24.0;
+const int Simulacao::ORCAMENTO_NAVEGACAO = 4096;
+
+// Posições iniciais das moedas
+static const Moeda MOEDAS_INICIAIS[NUM_MOEDAS] = {
+    {4, 0, false},
+    {6, 2, true},
+    {7, 13, true},
+    {13, 11, false}
+};
+
+Simulacao::Simulacao()
+    : movimentosConcluidos(0), verboso(true), gravador(nullptr), duracaoPassoTile(DURACAO_PASSO_TILE_PADRAO) {
+    defineSemente(1);
+    memset(mapaBase, 0, sizeof(mapaBase));
+    memset(barreirasBase, 0, sizeof(barreirasBase));
+    reinicia();
+}
+
+bool Simulacao::carregaMapas(const std::string &pastaMapas) {
+    bool ok = leMapa(pastaMapas + "mapa.txt", mapaBase);
+    ok = leMapa(pastaMapas + "barreiras.txt", barreirasBase) && ok;
+    reinicia();
+    return ok;
+}
+
+void Simulacao::reinicia() {
+    if (gravador) gravador->reinicio(ticks);
+
+    // Resetar mapas e barreiras
+    memcpy(mapa, mapaBase, sizeof(mapa));
+    gradeCaminhavel.resize(TILEMAP_WIDTH, TILEMAP_HEIGHT, false);
+    for (int y = 0; y < TILEMAP_HEIGHT; y++)
+        for (int x = 0; x < TILEMAP_WIDTH; x++)
+            gradeCaminhavel.setWalkable(x, y, barreirasBase[x][y] == 0);
+
+    // Resetar personagem
+    pos.x = 0;
+    pos.y = 0;
+    movimento.ativo = false;
+    movimento.origem = movimento.destino = pos;
+    movimento.progresso = 0.0;
+    migore.direcao = 3;
+    migore.frame = 0;
+    migore.andando = false;
+    migore.grupoAnimacao = 0;
+    campoInimigos.build(gradeCaminhavel, pos);
+
+    // Resetar moedas
+    for (int i = 0; i < NUM_MOEDAS; i++) moedasMapa[i] = MOEDAS_INICIAIS[i];
+
+    // Resetar eventos
+    evento_38_ativado = false;
+    evento_210_ativado = false;
+    evento_45_ativado = false;
+    evento_512_ativado = false;
+    evento_82_ativado = false;
+    evento_83_ativado = false;
+    evento_71_ativado = false;
+    evento_41_ativado = false;
+    evento_118_ativado = false;
+    evento_1312_ativado = false;
+    evento_jare_capturado = false;
+    greatJareSpirit_ativo = false;
+    pontuacao = 0;
+    vidas = 5;
+    animacoesTile.clear();
+    jogo_pausado = false;
+    jogador_ganhou = false;
+    jogador_perdeu = false;
+    mensagem_morte_lava = "";
+    tempo_mensagem_lava = 0.0;
+
+    // Relógio da partida
+    tempo_jogo = 0.0;
+    ticks = 0;
+    tempo_anim_migore = 0.0;
+    frame_anim_migore = 0;
+
+    // Descarta entrada pendente
+    filaEntrada.clear();
+    for (int d = 0; d < 8; d++) direcaoSegurada[d] = false;
+    ultimaDirecaoSegurada = -1;
+    proximaDirecao = -1;
+    tempoEntradaPassoIniciado = -1.0;
+}
+
+void Simulacao::defineSemente(uint64_t s) {
+    semente = s;
+    estadoSorteio = s;
+}
+
+void Simulacao::defineDuracaoPasso(double segundos) {
+    duracaoPassoTile = std::isfinite(segundos) && segundos > 0.0 ? segundos : DURACAO_PASSO_TILE_PADRAO;
+}
+
+// splitmix64: pequeno, rápido e igual em qualquer plataforma (rand() não é)
+uint32_t Simulacao::sorteia() {
+    uint64_t z = (estadoSorteio += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return (uint32_t)((z ^ (z >> 31)) >> 32);
+}
+
+void Simulacao::entrada(int direcao, int acao, double tempo) {
+    if (direcao < 0 || direcao > 7) return;
+    EventoEntrada evento = { direcao, acao, tempo };
+    filaEntrada.push_back(evento);
+}
+
+float Simulacao::visualX() const {
+    if (!movimento.ativo) return (float)pos.x;
+    return (float)(movimento.origem.x + (movimento.destino.x - movimento.origem.x) * movimento.progresso);
+}
+
+float Simulacao::visualY() const {
+    if (!movimento.ativo) return (float)pos.y;
+    return (float)(movimento.origem.y + (movimento.destino.y - movimento.origem.y) * movimento.progresso);
+}
+
+void Simulacao::retrata(RetratoDesenho &r) const {
+    memcpy(r.mapa, mapa, sizeof(mapa));
+    r.visualX = visualX();
+    r.visualY = visualY();
+    r.pos = pos;
+    r.migore = migore;
+    for (int i = 0; i < NUM_MOEDAS; i++) r.moedas[i] = moedasMapa[i];
+    r.movendo = movimento.ativo;
+    r.animandoTiles = !animacoesTile.empty();
+    r.greatJareSpirit_ativo = greatJareSpirit_ativo;
+    r.fimDeJogo = jogo_pausado;
+    r.jogador_ganhou = jogador_ganhou;
+    r.pontuacao = pontuacao;
+    r.vidas = vidas;
+    r.tempo_jogo = tempo_jogo;
+    r.tempo_mensagem_lava = tempo_mensagem_lava;
+    const char *msg = tempo_mensagem_lava > 0.0 ? mensagem_morte_lava.c_str() : "";
+    strncpy(r.mensagemLava, msg, sizeof(r.mensagemLava) - 1);
+    r.mensagemLava[sizeof(r.mensagemLava) - 1] = '\0';
+    r.ticks = ticks;
+}
+
+// Um passo da simulação: entrada, eventos do mapa, navegação, animações e
+// fim de jogo. Tudo que depende de tempo usa só "dt".
+void Simulacao::passo(double dt) {
+    if (jogo_pausado) return;
+    tempo_jogo += dt;
+    ticks++;
+
+    processaEntrada();
+    avancaMovimento(dt);
+    // Eventos do tile só depois da chegada (pos só muda quando o passo termina)
+    verificaEventoMapa(pos.x, pos.y);
+    continuaMovimento();
+
+    // Mantém o campo de fluxo dos inimigos apontando para o tile do Migoré
+    if (pos != campoInimigos.getGoal())
+        campoInimigos.setGoal(pos);
+    campoInimigos.update(ORCAMENTO_NAVEGACAO);
+
+    atualizaAnimacoes(dt);
+
+    // --- Mensagem temporária de morte na lava ---
+    if (tempo_mensagem_lava > 0.0) {
+        tempo_mensagem_lava -= dt;
+        if (tempo_mensagem_lava <= 0.0) {
+            mensagem_morte_lava = "";
+            tempo_mensagem_lava = 0.0;
+        }
+    }
+
+    // --- CHECA CONDIÇÃO DE VITÓRIA/DERROTA ---
+    // Vitória: chegou ao final (exemplo: tile 14,5)
+    if (pos.x == 14 && pos.y == 5) {
+        jogo_pausado = true;
+        jogador_ganhou = true;
+        jogador_perdeu = false;
+    }
+    // Derrota: ficou sem vidas
+    if (!jogo_pausado && vidas <= 0) {
+        jogo_pausado = true;
+        jogador_perdeu = true;
+        jogador_ganhou = false;
+    }
+}
+
+// Consome a fila de teclas: atualiza as teclas seguradas e começa o passo na
+// hora, ou guarda a direção para quando o passo atual terminar
+void Simulacao::processaEntrada() {
+    for (size_t i = 0; i < filaEntrada.size(); i++) {
+        const EventoEntrada &evento = filaEntrada[i];
+        int d = evento.direcao;
+        if (gravador) gravador->entrada(ticks - 1, d, evento.acao);
+        if (evento.acao == ENTRADA_SOLTA) {
+            direcaoSegurada[d] = false;
+            if (ultimaDirecaoSegurada == d) {
+                ultimaDirecaoSegurada = -1;
+                for (int k = 0; k < 8; k++)
+                    if (direcaoSegurada[k]) ultimaDirecaoSegurada = k;
+            }
+            continue;
+        }
+        direcaoSegurada[d] = true;
+        ultimaDirecaoSegurada = d;
+        if (movimento.ativo)
+            proximaDirecao = d;
+        else if (iniciarMovimento(d))
+            tempoEntradaPassoIniciado = evento.tempo;
+    }
+    filaEntrada.clear();
+}
+
+// Começa um passo de um tile na direção dada. Cada eixo é limitado à borda
+// do mapa separadamente; se o destino for barreira (ou o mesmo tile), o
+// Migoré só vira para a direção.
+bool Simulacao::iniciarMovimento(int direcao) {
+    GridPoint destino = pos;
+    int nx = pos.x + FlowField::FLOW_DIR_X[direcao];
+    int ny = pos.y + FlowField::FLOW_DIR_Y[direcao];
+    if (nx >= 0 && nx < TILEMAP_WIDTH) destino.x = nx;
+    if (ny >= 0 && ny < TILEMAP_HEIGHT) destino.y = ny;
+    migore.direcao = direcao;
+
+    // Colisão: só permite andar se a célula da grade de barreiras for caminhável
+    if (destino == pos || !gradeCaminhavel.isWalkable(destino.x, destino.y))
+        return false;
+
+    if (!migore.andando) migore.grupoAnimacao = sorteia() % 2; // sorteia grupo
+    migore.andando = true;
+    movimento.ativo = true;
+    movimento.origem = pos;
+    movimento.destino = destino;
+    movimento.progresso = 0.0;
+    return true;
+}
+
+// Avança o passo em andamento; ao completar, o tile lógico vira o destino
+void Simulacao::avancaMovimento(double dt) {
+    if (!movimento.ativo) return;
+    movimento.progresso += dt / duracaoPassoTile;
+    if (movimento.progresso < 1.0) return;
+    pos = movimento.destino;
+    movimento.ativo = false;
+    movimentosConcluidos++;
+}
+
+// Parado num tile: emenda o toque guardado ou, se houver tecla segurada, o próximo passo
+void Simulacao::continuaMovimento() {
+    if (movimento.ativo) return;
+    int d = proximaDirecao >= 0 ? proximaDirecao : ultimaDirecaoSegurada;
+    proximaDirecao = -1;
+    if (d < 0 || !iniciarMovimento(d))
+        migore.andando = false;
+}
+
+void Simulacao::atualizaAnimacoes(double dt) {
+    // Atualiza animação do personagem
+    if (migore.andando) {
+        tempo_anim_migore += dt;
+        while (tempo_anim_migore >= 1.0 / FPS_ANIMACAO_MIGORE) {
+            frame_anim_migore = (frame_anim_migore + 1) % FRAMES_POR_GRUPO; // Só 2 frames por grupo
+            tempo_anim_migore -= 1.0 / FPS_ANIMACAO_MIGORE;
+        }
+        migore.frame = migore.grupoAnimacao * FRAMES_POR_GRUPO + frame_anim_migore;
+    } else {
+        migore.frame = 0;
+        frame_anim_migore = 0;
+        tempo_anim_migore = 0.0;
+    }
+
+    // --- Atualiza animações de troca de tile, se houver ---
+    if (animacoesTile.empty()) return;
+    for (size_t i = 0; i < animacoesTile.size(); i++) {
+        AnimacaoTile &anim = animacoesTile[i];
+        anim.tempo += dt;
+        // alterna o tile a cada 0.08s
+        if (fmod(anim.tempo, 0.16) < 0.08) {
+            mapa[anim.x][anim.y] = anim.tileInicial;
+        } else {
+            mapa[anim.x][anim.y] = anim.tileFinal;
+        }
+    }
+    // Remove animações finalizadas
+    size_t n = 0;
+    for (size_t i = 0; i < animacoesTile.size(); i++) {
+        AnimacaoTile &anim = animacoesTile[i];
+        if (anim.tempo >= anim.tempoTotal) {
+            mapa[anim.x][anim.y] = anim.tileFinal;
+            continue;
+        }
+        animacoesTile[n++] = anim;
+    }
+    animacoesTile.resize(n);
+}
+
+void Simulacao::animarTrocaTile(int x, int y, int tileFinal) {
+    AnimacaoTile novaAnim;
+    novaAnim.x = x;
+    novaAnim.y = y;
+    novaAnim.tileInicial = mapa[x][y];
+    novaAnim.tileFinal = tileFinal;
+    novaAnim.tempo = 0.0;
+    novaAnim.tempoTotal = 1.0;
+    animacoesTile.push_back(novaAnim);
+}
+
+// Função genérica para animar e liberar tile
+void Simulacao::liberarTileComAnimacao(int x, int y, bool &evento_ativado) {
+    if (!evento_ativado) {
+        animarTrocaTile(x, y, 0); // anima para chão
+        gradeCaminhavel.setWalkable(x, y, true); // libera barreira
+        campoInimigos.cellOpened(x, y); // só reprocessa as células que ficaram mais perto
+        evento_ativado = true;
+        if (verboso)
+            std::cout << "[LOG] Evento especial em (" << x << "," << y << "): ANIMANDO tile para liberar!" << std::endl;
+    }
+}
+
+// Função para coletar moeda
+void Simulacao::coletarMoeda(int indice) {
+    moedasMapa[indice].ativa = false;
+    pontuacao += 340;
+    if (verboso)
+        std::cout << "Voce coletou uma moeda! Pontuação: " << pontuacao << std::endl;
+    animarTrocaTile(moedasMapa[indice].x, moedasMapa[indice].y, 5);
+}
+
+// Função para verificar eventos do tile atual do mapa (lava, moedas, etc)
+void Simulacao::verificaEventoMapa(int posx, int posy) {
+
+    // --------------------- LÓGICA DA LAVA
+    if (mapa[posx][posy] == 3) {
+        if (verboso)
+            std::cout << "Voce morreu! Caiu na lava!" << std::endl;
+        pos.x = 0;
+        pos.y = 0;
+        vidas--;
+        mensagem_morte_lava = "Voce morreu! Caiu na lava!";
+        tempo_mensagem_lava = 3.5; // Exibe por 3.5 segundos
+    }
+
+    // --------------------- LÓGICA DAS MOEDAS
+    if (posx == 4 && posy == 0 && moedasMapa[0].ativa) {
+        coletarMoeda(0);
+    }
+    if (posx == 6 && posy == 2 && moedasMapa[1].ativa) {
+        coletarMoeda(1);
+    }
+    if (posx == 7 && posy == 13 && moedasMapa[2].ativa) {
+        coletarMoeda(2);
+    }
+    if (posx == 13 && posy == 11 && moedasMapa[3].ativa) {
+        coletarMoeda(3);
+    }
+
+    // --------------------- LÓGICA DO GREAT JARE SPIRIT
+    if (posx == 12 && posy == 11 && greatJareSpirit_ativo && !evento_jare_capturado) {
+        if (verboso)
+            std::cout << "Voce encontrou o Great Jare Spirit!" << std::endl;
+        animarTrocaTile(12, 11, 5);
+        greatJareSpirit_ativo = false;
+        evento_jare_capturado = true;
+        pontuacao *= 1.25f;
+    }
+
+    // --------------------- LOGICAS DOS BOTOES
+    // Primeiro botão
+    if (posx == 3 && posy == 7 && !evento_38_ativado) {
+        liberarTileComAnimacao(2, 8, evento_38_ativado);
+    }
+    // Segundo botão
+    if (posx == 1 && posy == 9 && !evento_210_ativado) {
+        liberarTileComAnimacao(2, 10, evento_210_ativado);
+    }
+    // Terceiro botão
+    if (posx == 2 && posy == 13 && !evento_45_ativado) {
+        liberarTileComAnimacao(4, 5, evento_45_ativado);
+    }
+    // Quarto botão
+    if (posx == 5 && posy == 11 && !evento_512_ativado) {
+        liberarTileComAnimacao(5, 12, evento_512_ativado);
+    }
+    // Quinto botão
+    if (posx == 9 && posy == 13 && (!evento_82_ativado)) {
+        liberarTileComAnimacao(8, 2, evento_82_ativado);
+        liberarTileComAnimacao(8, 3, evento_83_ativado);
+    }
+    // Sexto botão
+    if (posx == 13 && posy == 1 && !evento_71_ativado) {
+        liberarTileComAnimacao(7, 1, evento_71_ativado);
+    }
+    // Sétimo botão
+    if (posx == 5 && posy == 1 && !evento_41_ativado) {
+        liberarTileComAnimacao(4, 1, evento_41_ativado);
+        moedasMapa[0].ativa = true; // Ativa a moeda que está escondida
+    }
+    // Oitavo botão
+    if (posx == 5 && posy == 2 && !evento_118_ativado) {
+        liberarTileComAnimacao(11, 8, evento_118_ativado);
+    }
+    // Nono botão
+    if (posx == 14 && posy == 3 && !evento_1312_ativado) {
+        liberarTileComAnimacao(12, 10, evento_1312_ativado);
+        // gradeCaminhavel.setWalkable(12, 12, false); // Bloqueia a coordenada 12,12
+        // gradeCaminhavel.setWalkable(13, 12, false); // Bloqueia a coordenada 13,12
+        moedasMapa[3].ativa = true; // Ativa a moeda final
+        greatJareSpirit_ativo = true; // Ativa o sprite do Great Jare Spirit
+    }
+}
+
+static bool dentroDoMapa(GridPoint q) {
+    return q.x >= 0 && q.y >= 0 && q.x < TILEMAP_WIDTH && q.y < TILEMAP_HEIGHT;
+}
+
+static bool tileValido(int tile) {
+    return tile >= 0 && tile < NUM_TILES;
+}
+
+void Simulacao::exporta(EstadoSalvo &e) const {
+    memset(&e, 0, sizeof(e));   // zera também o preenchimento: o checksum cobre tudo
+    const bool *eventos[] = {
+        &evento_38_ativado, &evento_210_ativado, &evento_45_ativado, &evento_512_ativado,
+        &evento_82_ativado, &evento_83_ativado, &evento_71_ativado, &evento_41_ativado,
+        &evento_118_ativado, &evento_1312_ativado, &evento_jare_capturado
+    };
+    for (int i = 0; i < (int)(sizeof(eventos) / sizeof(eventos[0])); i++)
+        if (*eventos[i]) e.eventos |= 1u << i;
+    for (int i = 0; i < NUM_MOEDAS; i++)
+        if (moedasMapa[i].ativa) e.moedas |= 1u << i;
+
+    e.semente = semente;
+    e.estadoSorteio = estadoSorteio;
+    e.ticks = ticks;
+    e.tempo_jogo = tempo_jogo;
+    e.pontuacao = pontuacao;
+    e.tempo_mensagem_lava = tempo_mensagem_lava;
+    e.tempo_anim_migore = tempo_anim_migore;
+    e.progressoMovimento = movimento.progresso;
+    e.vidas = vidas;
+    if (movimento.ativo) e.flags |= SALVO_MOVIMENTO_ATIVO;
+    if (migore.andando) e.flags |= SALVO_ANDANDO;
+    if (greatJareSpirit_ativo) e.flags |= SALVO_GREAT_JARE;
+    if (jogo_pausado) e.flags |= SALVO_PAUSADO;
+    if (jogador_ganhou) e.flags |= SALVO_GANHOU;
+    if (jogador_perdeu) e.flags |= SALVO_PERDEU;
+    e.posX = pos.x;
+    e.posY = pos.y;
+    e.origemX = movimento.origem.x;
+    e.origemY = movimento.origem.y;
+    e.destinoX = movimento.destino.x;
+    e.destinoY = movimento.destino.y;
+    e.direcao = migore.direcao;
+    e.frame = migore.frame;
+    e.grupoAnimacao = migore.grupoAnimacao;
+    e.frameAnimacao = frame_anim_migore;
+
+    // As trocas de tile duram 1 s e são poucas ao mesmo tempo: as que passarem
+    // do limite são salvas já terminadas, com o tile final no mapa
+    int atual[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+    memcpy(atual, mapa, sizeof(atual));
+    for (size_t i = 0; i < animacoesTile.size(); i++) {
+        const AnimacaoTile &a = animacoesTile[i];
+        if (e.numAnimacoes == MAX_ANIMACOES_SALVAS) {
+            atual[a.x][a.y] = a.tileFinal;
+            continue;
+        }
+        AnimacaoSalva &s = e.animacoes[e.numAnimacoes++];
+        s.x = (int16_t)a.x;
+        s.y = (int16_t)a.y;
+        s.tileInicial = (int16_t)a.tileInicial;
+        s.tileFinal = (int16_t)a.tileFinal;
+        s.tempo = a.tempo;
+        s.tempoTotal = a.tempoTotal;
+    }
+
+    for (int y = 0; y < TILEMAP_HEIGHT; y++)
+        for (int x = 0; x < TILEMAP_WIDTH; x++) {
+            if (gradeCaminhavel.isWalkable(x, y)) e.caminhavel[y] |= (uint16_t)(1u << x);
+            if (atual[x][y] != mapaBase[x][y]) {
+                DiferencaMapa &d = e.diferencas[e.numDiferencas++];
+                d.x = (uint8_t)x;
+                d.y = (uint8_t)y;
+                d.tile = (int16_t)atual[x][y];
+            }
+        }
+}
+
+bool Simulacao::importa(const EstadoSalvo &e) {
+    GridPoint p = { e.posX, e.posY }, o = { e.origemX, e.origemY }, d = { e.destinoX, e.destinoY };
+    if (!dentroDoMapa(p) || !dentroDoMapa(o) || !dentroDoMapa(d) || e.direcao < 0 || e.direcao > 7 ||
+        e.numDiferencas < 0 || e.numDiferencas > TILEMAP_WIDTH * TILEMAP_HEIGHT ||
+        e.numAnimacoes < 0 || e.numAnimacoes > MAX_ANIMACOES_SALVAS)
+        return false;
+    // O checksum só diz que o arquivo não mudou no caminho: tiles e frames
+    // viram índices no desenho, então cada um é conferido antes de aplicar
+    if (e.vidas < 0 || e.frame < 0 || e.frame >= NUM_FRAMES_MIGORE || e.grupoAnimacao < 0 ||
+        e.grupoAnimacao >= NUM_FRAMES_MIGORE / FRAMES_POR_GRUPO || e.frameAnimacao < 0 ||
+        e.frameAnimacao >= FRAMES_POR_GRUPO)
+        return false;
+    for (int i = 0; i < e.numDiferencas; i++) {
+        const DiferencaMapa &q = e.diferencas[i];
+        if (q.x >= TILEMAP_WIDTH || q.y >= TILEMAP_HEIGHT || !tileValido(q.tile)) return false;
+    }
+    for (int i = 0; i < e.numAnimacoes; i++) {
+        const AnimacaoSalva &s = e.animacoes[i];
+        GridPoint q = { s.x, s.y };
+        if (!dentroDoMapa(q) || !tileValido(s.tileInicial) || !tileValido(s.tileFinal)) return false;
+    }
+
+    // Parte do começo da partida e aplica o retrato por cima
+    GravadorReplay *g = gravador;
+    gravador = nullptr;
+    reinicia();
+    gravador = g;
+
+    bool *eventos[] = {
+        &evento_38_ativado, &evento_210_ativado, &evento_45_ativado, &evento_512_ativado,
+        &evento_82_ativado, &evento_83_ativado, &evento_71_ativado, &evento_41_ativado,
+        &evento_118_ativado, &evento_1312_ativado, &evento_jare_capturado
+    };
+    for (int i = 0; i < (int)(sizeof(eventos) / sizeof(eventos[0])); i++)
+        *eventos[i] = (e.eventos >> i) & 1;
+    for (int i = 0; i < NUM_MOEDAS; i++)
+        moedasMapa[i].ativa = (e.moedas >> i) & 1;
+
+    semente = e.semente;
+    estadoSorteio = e.estadoSorteio;
+    ticks = e.ticks;
+    tempo_jogo = e.tempo_jogo;
+    pontuacao = e.pontuacao;
+    tempo_mensagem_lava = e.tempo_mensagem_lava;
+    mensagem_morte_lava = tempo_mensagem_lava > 0.0 ? "Voce morreu! Caiu na lava!" : "";
+    tempo_anim_migore = e.tempo_anim_migore;
+    vidas = e.vidas;
+    movimento.ativo = (e.flags & SALVO_MOVIMENTO_ATIVO) != 0;
+    movimento.origem = o;
+    movimento.destino = d;
+    movimento.progresso = e.progressoMovimento;
+    migore.andando = (e.flags & SALVO_ANDANDO) != 0;
+    greatJareSpirit_ativo = (e.flags & SALVO_GREAT_JARE) != 0;
+    jogo_pausado = (e.flags & SALVO_PAUSADO) != 0;
+    jogador_ganhou = (e.flags & SALVO_GANHOU) != 0;
+    jogador_perdeu = (e.flags & SALVO_PERDEU) != 0;
+    pos = p;
+    migore.direcao = e.direcao;
+    migore.frame = e.frame;
+    migore.grupoAnimacao = e.grupoAnimacao;
+    frame_anim_migore = e.frameAnimacao;
+
+    for (int y = 0; y < TILEMAP_HEIGHT; y++)
+        for (int x = 0; x < TILEMAP_WIDTH; x++)
+            gradeCaminhavel.setWalkable(x, y, (e.caminhavel[y] >> x) & 1);
+    for (int i = 0; i < e.numDiferencas; i++)
+        mapa[e.diferencas[i].x][e.diferencas[i].y] = e.diferencas[i].tile;
+    for (int i = 0; i < e.numAnimacoes; i++) {
+        const AnimacaoSalva &s = e.animacoes[i];
+        AnimacaoTile a = { s.x, s.y, s.tileInicial, s.tileFinal, s.tempo, s.tempoTotal };
+        animacoesTile.push_back(a);
+    }
+    campoInimigos.build(gradeCaminhavel, pos);
+    return true;
+}
+
+static void acumulaHash(uint64_t &h, const void *dados, size_t n) {
+    const unsigned char *b = (const unsigned char *)dados;
+    for (size_t i = 0; i < n; i++) {
+        h ^= b[i];
+        h *= 1099511628211ull;
+    }
+}
+
+// FNV-1a sobre os campos que definem a partida
+uint64_t Simulacao::hashEstado() const {
+    uint64_t h = 1469598103934665603ull;
+    acumulaHash(h, mapa, sizeof(mapa));
+    acumulaHash(h, &pos, sizeof(pos));
+    acumulaHash(h, &vidas, sizeof(vidas));
+    acumulaHash(h, &pontuacao, sizeof(pontuacao));
+    acumulaHash(h, &ticks, sizeof(ticks));
+    acumulaHash(h, &estadoSorteio, sizeof(estadoSorteio));
+    for (int i = 0; i < NUM_MOEDAS; i++) acumulaHash(h, &moedasMapa[i].ativa, sizeof(bool));
+    for (int y = 0; y < TILEMAP_HEIGHT; y++) {
+        bool livre[TILEMAP_WIDTH];
+        for (int x = 0; x < TILEMAP_WIDTH; x++) livre[x] = gradeCaminhavel.isWalkable(x, y);
+        acumulaHash(h, livre, sizeof(livre));
+    }
+    acumulaHash(h, &jogador_ganhou, sizeof(bool));
+    acumulaHash(h, &jogador_perdeu, sizeof(bool));
+    return h;
+}
+
+bool leMapa(const std::string &path, int map[][TILEMAP_HEIGHT]) {
+    std::ifstream arquivo(path);
+    if (!arquivo.is_open()) {
+        std::cerr << "Erro ao abrir o arquivo: " << path << std::endl;
+        return false;
+    }
+    std::string linha;
+    int y = 0;
+    while (std::getline(arquivo, linha) && y < TILEMAP_HEIGHT) {
+        int x = 0;
+        size_t start = 0, end;
+        while (x < TILEMAP_WIDTH && (end = linha.find(',', start)) != std::string::npos) {
+            std::string valor = linha.substr(start, end - start);
+            if (!valor.empty() && valor.find_first_not_of(" \t\n\r") != std::string::npos)
+                map[x++][y] = std::stoi(valor);
+            start = end + 1;
+        }
+        // Último valor da linha (após a última vírgula)
+        if (x < TILEMAP_WIDTH && start < linha.size()) {
+            std::string valor = linha.substr(start);
+            if (!valor.empty() && valor.find_first_not_of(" \t\n\r") != std::string::npos)
+                map[x++][y] = std::stoi(valor);
+        }
+        y++;
+    }
+    return true;
+}
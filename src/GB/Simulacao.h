@@ -0,0 +1,296 @@
+//
+//  Simulacao.h
+//  Lógica do Joguinho sem janela nem OpenGL.
+//
+//  Movimento entre tiles, colisão, botões, moedas, lava, vidas e
+//  vitória/derrota avançam só por passo(dt), e a entrada chega por
+//  entrada(direcao, acao, tempo). O jogo com janela desenha a partir deste
+//  estado; o JoguinhoHeadless roda a mesma simulação no terminal com
+//  entradas de script.
+//
+
+#ifndef Simulacao_h
+#define Simulacao_h
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "WalkGrid.h"
+#include "FlowField.h"
+
+#define TILEMAP_WIDTH 15
+#define TILEMAP_HEIGHT 15
+
+// Ações de entrada (mesmos valores de GLFW_RELEASE e GLFW_PRESS)
+enum AcaoEntrada {
+    ENTRADA_SOLTA = 0,
+    ENTRADA_PRESSIONA = 1
+};
+
+struct EventoEntrada {
+    int direcao;   // 0..7, mesma numeração de EstadoMigore::direcao
+    int acao;      // AcaoEntrada
+    double tempo;  // horário de chegada (só usado para medir latência)
+};
+
+// --- Controle de animação de troca de tile ---
+struct AnimacaoTile {
+    int x, y;
+    int tileInicial;
+    int tileFinal;
+    double tempo;
+    double tempoTotal; // duração total da animação em segundos
+};
+
+// Struct para representar uma moeda no mapa
+struct Moeda {
+    int x, y;
+    bool ativa;
+};
+
+// Passo de um tile ao vizinho em andamento
+struct MovimentoTile {
+    bool ativo;
+    GridPoint origem, destino;
+    double progresso; // 0..1
+};
+
+// Parte do Migoré que é lógica de jogo (o sprite fica com quem desenha)
+struct EstadoMigore {
+    int direcao;       // 0=N, 1=NO, 2=O, 3=SO, 4=S, 5=SE, 6=L, 7=NE
+    int frame;
+    bool andando;
+    int grupoAnimacao; // 0: frames baixos, 1: frames altos
+};
+
+const int NUM_MOEDAS = 4;
+
+// Tiles do tileset e frames por direção na folha do Migoré: quem desenha
+// indexa por estes valores, então o estado nunca sai destas faixas
+const int NUM_TILES = 7;
+const int NUM_FRAMES_MIGORE = 4;
+const int FRAMES_POR_GRUPO = 2;   // cada grupoAnimacao usa 2 frames seguidos
+
+// --- Retrato do estado para salvar o jogo (Salvamento.h) ---
+// Layout fixo, só tipos de tamanho definido e sem ponteiros: o arquivo é
+// esta struct byte a byte (little-endian), então carregar é um fread e uma
+// conferência do cabeçalho. O mapa vai como diferenças em relação ao mapa
+// base, e as barreiras como uma linha de bits por y.
+const uint32_t SALVAMENTO_MAGICO = 0x5653474A;   // "JGSV"
+const uint16_t SALVAMENTO_VERSAO = 1;
+const int MAX_ANIMACOES_SALVAS = 16;
+
+struct DiferencaMapa {
+    uint8_t x, y;
+    int16_t tile;
+};
+
+struct AnimacaoSalva {
+    int16_t x, y, tileInicial, tileFinal;
+    double tempo, tempoTotal;
+};
+
+// Bits de EstadoSalvo::flags
+enum {
+    SALVO_MOVIMENTO_ATIVO = 1 << 0,
+    SALVO_ANDANDO = 1 << 1,
+    SALVO_GREAT_JARE = 1 << 2,
+    SALVO_PAUSADO = 1 << 3,
+    SALVO_GANHOU = 1 << 4,
+    SALVO_PERDEU = 1 << 5
+};
+
+struct EstadoSalvo {
+    // Cabeçalho (preenchido por salvaEstado)
+    uint32_t magico;
+    uint16_t versao;
+    uint16_t reservado;
+    uint32_t tamanho;       // sizeof(EstadoSalvo)
+    uint32_t checksum;      // FNV-1a de tudo depois deste campo
+
+    uint64_t semente;
+    uint64_t estadoSorteio;
+    int64_t ticks;
+    double tempo_jogo;
+    double pontuacao;
+    double tempo_mensagem_lava;
+    double tempo_anim_migore;
+    double progressoMovimento;
+
+    int32_t vidas;
+    uint32_t eventos;       // um bit por gatilho já disparado
+    uint32_t moedas;        // um bit por moeda ainda ativa
+    uint32_t flags;
+    int32_t posX, posY;
+    int32_t origemX, origemY, destinoX, destinoY;
+    int32_t direcao, frame, grupoAnimacao, frameAnimacao;
+    int32_t numDiferencas;
+    int32_t numAnimacoes;
+
+    uint16_t caminhavel[TILEMAP_HEIGHT];   // bit x da linha y = 1 se caminhável
+    uint16_t alinhamento[3];  // deixa as animações alinhadas em 8 sem preenchimento implícito
+
+    DiferencaMapa diferencas[TILEMAP_WIDTH * TILEMAP_HEIGHT];
+    AnimacaoSalva animacoes[MAX_ANIMACOES_SALVAS];
+};
+
+// --- Retrato para quem desenha ---
+// Cópia de tudo que o desenho lê, sem ponteiros nem alocação, para a
+// simulação rodar noutra thread e entregar um destes a cada passo
+// (Common/TripleBuffer.h). Quem desenha não lê mais nada de Simulacao.
+struct RetratoDesenho {
+    int mapa[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+    float visualX, visualY;     // posição contínua do Migoré (em tiles)
+    GridPoint pos;
+    EstadoMigore migore;
+    Moeda moedas[NUM_MOEDAS];
+    bool movendo;               // passo de tile em andamento
+    bool animandoTiles;         // alguma troca de tile animada em andamento
+    bool greatJareSpirit_ativo;
+    bool fimDeJogo;
+    bool jogador_ganhou;
+    double pontuacao;
+    int vidas;
+    double tempo_jogo;
+    double tempo_mensagem_lava;
+    char mensagemLava[64];      // vazia quando não há mensagem na tela
+    long long ticks;
+};
+
+class GravadorReplay;
+
+class Simulacao {
+public:
+    static const double PASSO;               // passo fixo padrão (1/120 s)
+    static const double DURACAO_PASSO_TILE_PADRAO; // segundos para chegar ao tile vizinho
+    static const double FPS_ANIMACAO_MIGORE; // troca de frame da caminhada
+    static const int ORCAMENTO_NAVEGACAO;    // células do campo de fluxo por passo
+
+    Simulacao();
+
+    // Lê mapa.txt e barreiras.txt da pasta (terminada em '/') como mapas base
+    bool carregaMapas(const std::string &pastaMapas);
+
+    // Volta ao começo da partida a partir dos mapas base
+    void reinicia();
+
+    // Semente do sorteio da sessão. Não muda em reinicia(): as partidas de
+    // uma sessão seguem a mesma sequência, e um replay com a mesma semente
+    // sorteia os mesmos valores
+    void defineSemente(uint64_t s);
+    uint64_t getSemente() const {
+        return semente;
+    }
+
+    // Segundos de um passo de tile ao vizinho (padrão DURACAO_PASSO_TILE_PADRAO;
+    // valores não positivos ou infinitos voltam ao padrão). Também não muda em reinicia(),
+    // e o replay grava o valor da sessão
+    void defineDuracaoPasso(double segundos);
+    double getDuracaoPasso() const {
+        return duracaoPassoTile;
+    }
+
+    // Enfileira uma tecla de direção; é consumida no próximo passo
+    void entrada(int direcao, int acao, double tempo);
+
+    // Avança a simulação em dt segundos
+    void passo(double dt);
+
+    // Retrato do estado da partida (sem a entrada pendente) e a volta a
+    // partir dele. importa recusa retratos com valores fora do mapa, do
+    // tileset ou da folha de frames, sem mudar nada do estado atual.
+    void exporta(EstadoSalvo &e) const;
+    bool importa(const EstadoSalvo &e);
+
+    bool fimDeJogo() const {
+        return jogo_pausado;
+    }
+
+    // Copia para "r" o que o desenho precisa deste passo
+    void retrata(RetratoDesenho &r) const;
+
+    // Posição contínua do Migoré (em tiles) entre o tile de origem e o destino
+    float visualX() const;
+    float visualY() const;
+
+    // Resumo do estado para conferir que duas execuções deram no mesmo lugar
+    uint64_t hashEstado() const;
+
+    // --- Estado do jogo (lido por quem desenha) ---
+    int mapa[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+    WalkGrid gradeCaminhavel;   // barreiras em bits (1 = caminhável): colisão e navegação
+    FlowField campoInimigos;    // campo de fluxo até o Migoré, compartilhado pelos inimigos
+    GridPoint pos;              // tile lógico: só muda quando o passo termina
+    MovimentoTile movimento;
+    EstadoMigore migore;
+    Moeda moedasMapa[NUM_MOEDAS];
+    std::vector<AnimacaoTile> animacoesTile;
+    bool greatJareSpirit_ativo;
+    double pontuacao;
+    int vidas;
+    bool jogo_pausado;
+    bool jogador_ganhou;
+    bool jogador_perdeu;
+    std::string mensagem_morte_lava;
+    double tempo_mensagem_lava;
+    double tempo_jogo;          // tempo simulado desde o início da partida
+    long long ticks;            // passos dados desde o início da partida
+    long long movimentosConcluidos; // passos de tile terminados (para o autosave)
+
+    // Horário da tecla que iniciou um passo desde a última leitura (ou -1);
+    // quem mede latência lê e volta para -1
+    double tempoEntradaPassoIniciado;
+
+    // Mensagens de eventos no console (o headless desliga)
+    bool verboso;
+
+    // Quando definido, recebe cada entrada consumida e cada reinício (Replay.h)
+    GravadorReplay *gravador;
+
+private:
+    // INICIALIZA OS CONTROLES DE EVENTOS
+    bool evento_38_ativado;
+    bool evento_210_ativado;
+    bool evento_45_ativado;
+    bool evento_512_ativado;
+    bool evento_82_ativado;
+    bool evento_83_ativado;
+    bool evento_71_ativado;
+    bool evento_41_ativado;
+    bool evento_118_ativado;
+    bool evento_1312_ativado;
+    bool evento_jare_capturado;
+
+    int mapaBase[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+    int barreirasBase[TILEMAP_WIDTH][TILEMAP_HEIGHT];
+
+    std::vector<EventoEntrada> filaEntrada;
+    bool direcaoSegurada[8];     // teclas de direção pressionadas agora
+    int ultimaDirecaoSegurada;   // a mais recente entre as seguradas: anda sem parar
+    int proximaDirecao;          // toque recebido no meio de um passo, executado na chegada
+
+    double tempo_anim_migore;    // acumulador da animação de caminhada
+    int frame_anim_migore;
+
+    uint64_t semente;
+    uint64_t estadoSorteio;
+    uint32_t sorteia();
+
+    double duracaoPassoTile;
+
+    void processaEntrada();
+    bool iniciarMovimento(int direcao);
+    void avancaMovimento(double dt);
+    void continuaMovimento();
+    void atualizaAnimacoes(double dt);
+    void verificaEventoMapa(int posx, int posy);
+    void liberarTileComAnimacao(int x, int y, bool &evento_ativado);
+    void animarTrocaTile(int x, int y, int tileFinal);
+    void coletarMoeda(int indice);
+};
+
+// Lê um mapa de TILEMAP_WIDTH x TILEMAP_HEIGHT inteiros separados por vírgula
+bool leMapa(const std::string &path, int map[][TILEMAP_HEIGHT]);
+
+#endif /* Simulacao_h */
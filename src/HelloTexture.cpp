@@ -36,6 +36,10 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Ritmo de quadros (vsync e limitador)
+#include "FramePacing.h"
+#include "gl_utils.h" // tempos de quadro
+
 // STB_IMAGE
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
@@ -81,7 +85,7 @@ const GLchar *fragmentShaderSource = R"(
  )";
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
 	// Inicialização da GLFW
 	glfwInit();
@@ -113,6 +117,13 @@ int main()
 	}
 	glfwMakeContextCurrent(window);
 
+	// Vsync e limite de FPS: --vsync on|off|adaptive, --fps N, --fps-pausa N
+	FramePacer pacer;
+	pacer.parseArgs(argc, argv);
+	pacer.apply();
+	// --tempos-quadro arq.csv [--travada-ms N]: p50/p95/p99 e travadas, CSV na saída
+	frame_times_parse_args(argc, argv);
+
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
@@ -145,9 +156,6 @@ int main()
 
 	glUseProgram(shaderID); // Reseta o estado do shader para evitar problemas futuros
 
-	double prev_s = glfwGetTime();	// Define o "tempo anterior" inicial.
-	double title_countdown_s = 0.1; // Intervalo para atualizar o título da janela com o FPS.
-
 	float colorValue = 0.0;
 
 	// Ativando o primeiro buffer de textura do OpenGL
@@ -159,27 +167,6 @@ int main()
 	// Loop da aplicação - "game loop"
 	while (!glfwWindowShouldClose(window))
 	{
-		// Este trecho de código é totalmente opcional: calcula e mostra a contagem do FPS na barra de título
-		{
-			double curr_s = glfwGetTime();		// Obtém o tempo atual.
-			double elapsed_s = curr_s - prev_s; // Calcula o tempo decorrido desde o último frame.
-			prev_s = curr_s;					// Atualiza o "tempo anterior" para o próximo frame.
-
-			// Exibe o FPS, mas não a cada frame, para evitar oscilações excessivas.
-			title_countdown_s -= elapsed_s;
-			if (title_countdown_s <= 0.0 && elapsed_s > 0.0)
-			{
-				double fps = 1.0 / elapsed_s; // Calcula o FPS com base no tempo decorrido.
-
-				// Cria uma string e define o FPS como título da janela.
-				char tmp[256];
-				sprintf(tmp, "Ola Triangulo! -- Rossana\tFPS %.2lf", fps);
-				glfwSetWindowTitle(window, tmp);
-
-				title_countdown_s = 0.1; // Reinicia o temporizador para atualizar o título periodicamente.
-			}
-		}
-
 		// Checa se houveram eventos de input (key pressed, mouse moved etc.) e chama as funções de callback correspondentes
 		glfwPollEvents();
 
@@ -204,6 +191,9 @@ int main()
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		frame_times_mark();
+		_update_fps_counter(window, "Ola Triangulo! -- Rossana"); // FPS (e p99/max, se gravando) no título
+		pacer.waitForNextFrame();
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
@@ -19,6 +19,10 @@ using namespace std;
 // GLFW
 #include <GLFW/glfw3.h>
 
+// Ritmo de quadros (vsync e limitador)
+#include "FramePacing.h"
+#include "gl_utils.h" // tempos de quadro
+
 //GLM
 #include <glm/glm.hpp> 
 #include <glm/gtc/matrix_transform.hpp>
@@ -60,7 +64,7 @@ const GLchar* fragmentShaderSource = "#version 400\n"
 "}\n\0";
 
 // Função MAIN
-int main()
+int main(int argc, char **argv)
 {
 	// Inicialização da GLFW
 	glfwInit();
@@ -82,6 +86,13 @@ int main()
 	GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Ola Triangulo! -- Rossana", nullptr, nullptr);
 	glfwMakeContextCurrent(window);
 
+	// Vsync e limite de FPS: --vsync on|off|adaptive, --fps N, --fps-pausa N
+	FramePacer pacer;
+	pacer.parseArgs(argc, argv);
+	pacer.apply();
+	// --tempos-quadro arq.csv [--travada-ms N]: p50/p95/p99 e travadas, CSV na saída
+	frame_times_parse_args(argc, argv);
+
 	// Fazendo o registro da função de callback para a janela GLFW
 	glfwSetKeyCallback(window, key_callback);
 
@@ -177,6 +188,9 @@ int main()
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
+		frame_times_mark();
+		_update_fps_counter(window, "Ola Triangulo! -- Rossana"); // FPS (e p99/max, se gravando) no título
+		pacer.waitForNextFrame();
 	}
 	// Pede pra OpenGL desalocar os buffers
 	glDeleteVertexArrays(1, &VAO);
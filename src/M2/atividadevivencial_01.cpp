@@ -20,6 +20,8 @@
 #include <ctime>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include "FramePacing.h"
+#include "gl_utils.h" // tempos de quadro
 
 using namespace std;
 
@@ -145,7 +147,7 @@ int setupShader() {
     return shaderProgram;
 }
 
-int main() {
+int main(int argc, char **argv) {
     srand(static_cast<unsigned int>(time(0)));
 
     glfwInit();
@@ -154,6 +156,13 @@ int main() {
     GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Atividade Vivencial 01", NULL, NULL);
     glfwMakeContextCurrent(window);
 
+    // Vsync e limite de FPS: --vsync on|off|adaptive, --fps N, --fps-pausa N
+    FramePacer pacer;
+    pacer.parseArgs(argc, argv);
+    pacer.apply();
+    // --tempos-quadro arq.csv [--travada-ms N]: p50/p95/p99 e travadas, CSV na saída
+    frame_times_parse_args(argc, argv);
+
     // GLAD: carrega todos os ponteiros de funcoes da OpenGL
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         cerr << "Erro ao inicializar GLAD." << endl;
@@ -186,6 +195,9 @@ int main() {
 
         // Troca os buffers da tela
         glfwSwapBuffers(window);
+        frame_times_mark();
+        _update_fps_counter(window, "Atividade Vivencial 01"); // FPS (e p99/max, se gravando) no título
+        pacer.waitForNextFrame();
     }
 
     // Pede pra OpenGL desalocar os buffers
@@ -18,18 +18,30 @@
  * Atenção: este código foi adaptado para incluir:
  *   - Movimento para a direita/esquerda com limite de tela.
  *   - Flip horizontal ao andar para a esquerda.
- *   - Pulo com física simples (velocidade inicial + gravidade).
- *   - Efeito parallax de 5 camadas usando texturas extras ("parallax1.png" até "parallax5.png").
+ *   - Pulo com física simples (velocidade inicial + gravidade), integrada em lote pelo SpritePhysics.
+ *   - --estresse [N]: N sprites (padrão 100.000) pulando sem parar, num único desenho instanciado.
+ *   - Efeito parallax de 5 camadas usando texturas extras ("parallax1.png" até "parallax5.png"),
+ *     todas numa textura array; o ParallaxRenderer só usa blend nas bordas translúcidas.
  *   - Mantidos todos os comentários originais e as texturas já carregadas, exceto o SKY, que foi removido.
  */
 
 #include <iostream>
 #include <vector>
 #include <string>
+#include <cstdlib>
+#include <cstring>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+// Ritmo de quadros (vsync e limitador)
+#include "FramePacing.h"
+#include "gl_utils.h" // tempos de quadro
+#include "GLStateCache.h"
+#include "ParallaxRenderer.h"
+#include "SpritePhysics.h"
+#include "StreamBuffer.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -71,6 +83,25 @@ void main()
 }
 )";
 
+// GLSL: vertex shader dos sprites do modo de estresse (um quad por instância,
+// com x e y vindos de dois buffers, como ficam no SpritePhysics)
+const GLchar* estresseVertexShaderSource = R"(
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in float aX;
+layout (location = 3) in float aY;
+uniform mat4 uProjection;
+uniform vec2 uScale;
+out vec2 TexCoord;
+void main()
+{
+    vec2 p = vec2(aX, aY) + (aPos.xy + 0.5) * uScale;
+    gl_Position = uProjection * vec4(p, 0.0, 1.0);
+    TexCoord = vec2(aTexCoord.x, 1.0 - aTexCoord.y);
+}
+)";
+
 // =========================================================================
 // 2) Funções utilitárias para criar e compilar shaders, criar quad VAO, carregar texturas
 // =========================================================================
@@ -173,6 +204,24 @@ GLuint CreateQuadVAO()
     return VAO;
 }
 
+// O quad base com mais dois atributos por instância (location 2 = x, 3 = y),
+// um float por sprite em cada buffer
+GLuint CreateInstancedQuadVAO(GLuint xVBO, GLuint yVBO)
+{
+    GLuint VAO = CreateQuadVAO();
+    glBindVertexArray(VAO);
+    GLuint buffers[2] = { xVBO, yVBO };
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffers[i]);
+        glVertexAttribPointer(2 + i, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (void*)0);
+        glEnableVertexAttribArray(2 + i);
+        glVertexAttribDivisor(2 + i, 1);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+    return VAO;
+}
+
 // =========================================================================
 // 3) Callback para teclado (ESC fecha a janela)
 // =========================================================================
@@ -187,27 +236,27 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 
 class Sprite {
 public:
-    // Construtor: recebe ID de shader compilado, ID de VAO (quad base), e textura
-    Sprite(GLuint shaderID, GLuint quadVAO, GLuint textureID)
+    // Construtor: recebe ID de shader compilado, ID de VAO (quad base), textura
+    // e o sistema de física onde fica o corpo do pulo
+    Sprite(GLuint shaderID, GLuint quadVAO, GLuint textureID, SpritePhysics& physics)
         : shaderID(shaderID),
           VAO(quadVAO),
           textureID(textureID),
           facingRight(true),
-          isJumping(false),
-          velocityY(0.0f),
-          gravity(800.0f),
           initialJumpV(350.0f),
-          rotation(0.0f)
+          rotation(0.0f),
+          physics(&physics)
     {
         position = glm::vec2(0.0f, 0.0f);
         scale    = glm::vec2(100.0f, 100.0f); // escala padrão: 100 × 100 px
-        groundY  = position.y;               // inicializa "chão" para pulo
+        // Corpo no chão em y = 0, com gravidade de 800 px/s²
+        body     = physics.add(position.y, 800.0f);
     }
 
     // Ajusta posição (em px, no sistema de coordenadas [0,800]×[0,600])
     void SetPosition(float x, float y) {
         position = glm::vec2(x, y);
-        groundY  = y; // define o chão para o pulo
+        physics->place(body, y); // define o chão para o pulo
     }
 
     // Ajusta escala (largura×altura em px)
@@ -239,19 +288,21 @@ public:
 
     void andaCima(float /*qtd*/) {
         // Adicionar lógica de pulo: sobe até certa altura e depois cai
-        if (!isJumping) {
-            isJumping = true;
-            velocityY = initialJumpV; // define velocidade inicial do pulo (px/s)
-        }
+        // (só começa se estiver no chão; a velocidade inicial é em px/s)
+        physics->jump(body, initialJumpV);
     }
 
     void andaBaixo(float qtd) {
         // Caso queira mover para baixo (não usado para pulo)
-        position.y += qtd;
+        position.y = physics->getY(body) + qtd;
+        physics->setY(body, position.y);
     }
 
     // Desenha o sprite (quad texturizado) usando shader e textura definidos
     void Draw(const glm::mat4& projection) {
+        // A altura vem da física (SpritePhysics::update, uma vez por quadro)
+        position.y = physics->getY(body);
+
         glm::mat4 model = glm::mat4(1.0f);
 
         // 1. Translada para a posição desejada (posição refere-se ao CENTRO do sprite)
@@ -268,37 +319,19 @@ public:
         model = glm::scale(model, glm::vec3(flipX * scale.x, scale.y, 1.0f));
 
         // 6. Envia uModel e uProjection para o shader
-        glUseProgram(shaderID);
-        GLint modelLoc = glGetUniformLocation(shaderID, "uModel");
-        GLint projLoc  = glGetUniformLocation(shaderID, "uProjection");
+        g_glState.useProgram(shaderID);
+        GLint modelLoc = g_glState.uniformLocation(shaderID, "uModel");
+        GLint projLoc  = g_glState.uniformLocation(shaderID, "uProjection");
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
         glUniformMatrix4fv(projLoc,  1, GL_FALSE, glm::value_ptr(projection));
 
-        // 7. Textura na unidade 0
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glUniform1i(glGetUniformLocation(shaderID, "uTexture"), 0);
+        // 7. Textura na unidade 0 (uTexture = 0 fica definido no main)
+        g_glState.activeTexture(GL_TEXTURE0);
+        g_glState.bindTexture(GL_TEXTURE_2D, textureID);
 
         // 8. Bind no VAO (quad) e desenha
-        glBindVertexArray(VAO);
+        g_glState.bindVertexArray(VAO);
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        glBindVertexArray(0);
-    }
-
-    // Atualiza a física do pulo (gravidade, subida e descida)
-    void UpdatePhysics(float deltaTime) {
-        if (isJumping) {
-            // Move para cima/baixo de acordo com velocidadeY atual
-            position.y += velocityY * deltaTime;
-            // Aplica gravidade (reduz velocidadeY)
-            velocityY -= gravity * deltaTime;
-            // Se voltar ao chão, para o pulo
-            if (position.y <= groundY) {
-                position.y   = groundY;
-                isJumping    = false;
-                velocityY    = 0.0f;
-            }
-        }
     }
 
     // Expondo posição e escala publicamente para facilitar uso no parallax
@@ -313,12 +346,11 @@ private:
     float rotation;    // rotação em graus
     bool  facingRight; // controla flip horizontal
 
-    // Variáveis para pulo
-    bool  isJumping;
-    float velocityY;
-    float gravity;      // aceleração da gravidade (px/s²)
+    // Variáveis para pulo: altura, velocidade, chão e gravidade ficam no
+    // SpritePhysics (vetores de todos os corpos), aqui só o índice do corpo
     float initialJumpV; // velocidade inicial do pulo (px/s)
-    float groundY;      // posição Y do chão (onde o sprite começa)
+    SpritePhysics* physics;
+    int   body;
 };
 
 // Função auxiliar (não utilizada diretamente, mas deixada para referência)
@@ -338,7 +370,7 @@ void move(Sprite& sprite, GLFWwindow* window, float qtd) {
     }
 }
 
-int main()
+int main(int argc, char **argv)
 {
     // 6.1 Inicializa GLFW
     if (!glfwInit()) {
@@ -354,6 +386,13 @@ int main()
         return -1;
     }
     glfwMakeContextCurrent(window);
+
+    // Vsync e limite de FPS: --vsync on|off|adaptive, --fps N, --fps-pausa N
+    FramePacer pacer;
+    pacer.parseArgs(argc, argv);
+    pacer.apply();
+    // --tempos-quadro arq.csv [--travada-ms N]: p50/p95/p99 e travadas, CSV na saída
+    frame_times_parse_args(argc, argv);
     glfwSetKeyCallback(window, key_callback);
 
     // 6.2 Carrega GLAD
@@ -381,19 +420,49 @@ int main()
     GLuint fafare   = loadTexture("../assets/sprites/fafare.png");
     GLuint raphare  = loadTexture("../assets/sprites/raphare.png");
 
-    // 6.6.1 Carrega texturas de parallax (camadas extras; substitua pelos arquivos reais)
-    GLuint parallaxTex[5];
-    parallaxTex[0] = loadTexture("../assets/sprites/parallax1.png"); // camada mais distante
-    parallaxTex[1] = loadTexture("../assets/sprites/parallax2.png");
-    parallaxTex[2] = loadTexture("../assets/sprites/parallax3.png");
-    parallaxTex[3] = loadTexture("../assets/sprites/parallax4.png");
-    parallaxTex[4] = loadTexture("../assets/sprites/parallax5.png"); // camada mais próxima
+    float MULTIPLICADOR = 10.0f;
+    const float VELOCIDADE_JOGADOR = 200.0f * MULTIPLICADOR; // px/s
+
+    // 6.6.1 Camadas de parallax, da mais distante à mais próxima (para mais
+    // camadas, basta acrescentar linhas). ratex é a fração da velocidade do
+    // jogador com que a camada anda.
+    const char *arquivosParallax[] = {
+        "../assets/sprites/parallax1.png",
+        "../assets/sprites/parallax2.png",
+        "../assets/sprites/parallax3.png",
+        "../assets/sprites/parallax4.png",
+        "../assets/sprites/parallax5.png"
+    };
+    const int NUM_CAMADAS = sizeof(arquivosParallax) / sizeof(arquivosParallax[0]);
+    std::vector<Layer> camadas(NUM_CAMADAS);
+    for (int i = 0; i < NUM_CAMADAS; ++i) {
+        camadas[i].z = (float)i;
+        camadas[i].filename = arquivosParallax[i];
+        camadas[i].offsetx = camadas[i].offsety = 0.0f;
+        camadas[i].ratex = 0.1f * (i + 1); // 20, 40, ... 100 px/s vezes o MULTIPLICADOR
+        camadas[i].ratey = 0.0f;
+    }
+
+    // Uma textura array do tamanho da tela; cada camada ocupa a tela inteira
+    ParallaxRenderer parallax;
+    parallax.create(camadas, SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (int i = 0; i < NUM_CAMADAS; ++i) {
+        int w, h, canais;
+        unsigned char *pixels = stbi_load(camadas[i].filename, &w, &h, &canais, 0);
+        if (!pixels) {
+            std::cerr << "[ERRO] Falha ao carregar textura em: " << camadas[i].filename << std::endl;
+            continue;
+        }
+        parallax.setLayerImage(i, pixels, w, h, canais);
+        stbi_image_free(pixels);
+    }
 
-    // 6.7 Cria instâncias de Sprite
+    // 6.7 Cria instâncias de Sprite; o pulo de todas é integrado junto
+    SpritePhysics fisica;
     std::vector<Sprite> sprites;
 
     // JARE ON TOP (jogador/personagem)
-    sprites.emplace_back(shaderProgram, quadVAO, jare);
+    sprites.emplace_back(shaderProgram, quadVAO, jare, fisica);
     // Posição inicial do jogador: em baixo, próximo ao "chão" y = 50
     sprites.back().SetPosition(50.0f, 50.0f);
     sprites.back().SetScale(128.0f, 128.0f);
@@ -401,31 +470,11 @@ int main()
 
     // (adicione mais sprites conforme desejar)
     // Por exemplo, se quiser usar 'fafare' ou 'raphare', pode emplacá-los aqui:
-    // sprites.emplace_back(shaderProgram, quadVAO, fafare);
+    // sprites.emplace_back(shaderProgram, quadVAO, fafare, fisica);
     // sprites.back().SetPosition(200.0f, 100.0f);
     // sprites.back().SetScale(64.0f, 64.0f);
     // sprites.back().SetRotation(0.0f);
 
-    // 6.7.1 Cria sprites de parallax (cada camada ocupa toda a tela; posição inicial em x=0)
-    std::vector<Sprite> parallaxSprites;
-    parallaxSprites.reserve(5);
-    for (int i = 0; i < 5; ++i) {
-        parallaxSprites.emplace_back(shaderProgram, quadVAO, parallaxTex[i]);
-        // Define escala para toda a tela, mas posição X será ajustada via offset
-        parallaxSprites.back().SetScale((float)SCREEN_WIDTH, (float)SCREEN_HEIGHT);
-        // Verticalmente, centraliza no meio da tela (300)
-        parallaxSprites.back().SetPosition(SCREEN_WIDTH / 2.0f, SCREEN_HEIGHT / 2.0f);
-        parallaxSprites.back().SetRotation(0.0f);
-    }
-
-    float MULTIPLICADOR = 10.0f;
-
-    // 6.7.2 Define velocidades de parallax (quanto maior, mais rápido a camada se move)
-    float parallaxSpeeds[5] = { 20.0f * MULTIPLICADOR, 40.0f * MULTIPLICADOR, 60.0f * MULTIPLICADOR, 80.0f * MULTIPLICADOR, 100.0f * MULTIPLICADOR };
-
-    // 6.7.3 Offset X inicial de cada camada (em px, partindo de 0 = sem deslocamento)
-    float parallaxOffsetX[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
-
     // 6.8 Define matriz de projeção ortográfica (coordenadas de tela)
     glm::mat4 projection = glm::ortho(
         0.0f, (float)SCREEN_WIDTH,
@@ -433,8 +482,55 @@ int main()
        -1.0f,  1.0f
     );
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // 6.8.1 Modo de estresse (--estresse [N]): N sprites pequenos pulando sem
+    // parar, num sistema de física próprio (para que pulem sem o jogador).
+    // As alturas vão direto do SpritePhysics para a região do quadro no
+    // StreamBuffer e todos saem num glDrawArraysInstanced
+    int numEstresse = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (!strcmp(argv[i], "--estresse")) {
+            numEstresse = (i + 1 < argc && atoi(argv[i + 1]) > 0) ? atoi(argv[i + 1]) : 100000;
+        }
+    }
+    const float ESTRESSE_TAMANHO = 8.0f;   // px
+    SpritePhysics multidao;
+    GLuint estresseProgram = 0, estresseVAO = 0, estresseX = 0;
+    double estresseFisicaSeg = 0.0;
+    long estresseQuadros = 0;
+    if (numEstresse > 0) {
+        std::vector<float> xs(numEstresse);
+        srand(1);
+        for (int i = 0; i < numEstresse; ++i) {
+            xs[i] = (float)(rand() % (int)(SCREEN_WIDTH - ESTRESSE_TAMANHO));
+            // chão entre 0 e 500 px e um primeiro pulo de força variada,
+            // para que não pousem todos juntos
+            int corpo = multidao.add((float)(rand() % 500), 800.0f);
+            multidao.jump(corpo, (float)(rand() % 350));
+        }
+        glGenBuffers(1, &estresseX);
+        glBindBuffer(GL_ARRAY_BUFFER, estresseX);
+        glBufferData(GL_ARRAY_BUFFER, numEstresse * sizeof(float), xs.data(), GL_STATIC_DRAW);
+        // Uma região por quadro com as alturas de todos os sprites
+        g_streamBuffer.create(numEstresse * sizeof(float));
+        estresseVAO = CreateInstancedQuadVAO(estresseX, g_streamBuffer.getBuffer());
+
+        estresseProgram = CreateShaderProgram(estresseVertexShaderSource, fragmentShaderSource);
+        glUseProgram(estresseProgram);
+        glUniform1i(glGetUniformLocation(estresseProgram, "uTexture"), 0);
+        glUniform2f(glGetUniformLocation(estresseProgram, "uScale"), ESTRESSE_TAMANHO, ESTRESSE_TAMANHO);
+        glUniformMatrix4fv(glGetUniformLocation(estresseProgram, "uProjection"), 1, GL_FALSE,
+                           glm::value_ptr(projection));
+        std::cout << "[estresse] " << numEstresse << " sprites pulando" << std::endl;
+    }
+
+    // O setup acima faz binds direto no GL: o cache recomeça daqui
+    g_glState.invalidate();
+    g_glState.setEnabled(GL_BLEND, true);
+    g_glState.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // Todos os sprites amostram a unidade 0
+    g_glState.useProgram(shaderProgram);
+    glUniform1i(g_glState.uniformLocation(shaderProgram, "uTexture"), 0);
 
     // 6.9 Variáveis de tempo para deltaTime
     float lastFrameTime = (float)glfwGetTime();
@@ -457,11 +553,11 @@ int main()
 
         // *** Movimentar o JOGADOR que está em sprites[0] ***
         if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
-            sprites[0].andaDireita(200.0f * MULTIPLICADOR * deltaTime); // 200 px/s
+            sprites[0].andaDireita(VELOCIDADE_JOGADOR * deltaTime); // 200 px/s
             moveDir = +1;
         }
         if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS) {
-            sprites[0].andaEsquerda(-200.0f * MULTIPLICADOR * deltaTime); // qtd negativo = moveDir -1
+            sprites[0].andaEsquerda(-VELOCIDADE_JOGADOR * deltaTime); // qtd negativo = moveDir -1
             moveDir = -1;
         }
         if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS) {
@@ -471,59 +567,75 @@ int main()
             sprites[0].andaBaixo(200.0f * deltaTime);
         }
 
-        // 6.10.4 Atualiza física do pulo do jogador (sprites[0])
-        sprites[0].UpdatePhysics(deltaTime);
+        // 6.10.4 Atualiza física do pulo de todos os sprites de uma vez
+        fisica.update(deltaTime);
+        if (numEstresse > 0) {
+            double inicio = glfwGetTime();
+            multidao.jumpGrounded(350.0f); // quem pousou pula de novo
+            multidao.update(deltaTime);
+            estresseFisicaSeg += glfwGetTime() - inicio;
+            estresseQuadros++;
+        }
 
         // 6.10.5 Atualiza offsets de parallax com base na direção do jogador
-        for (int i = 0; i < 5; ++i) {
-            parallaxOffsetX[i] -= moveDir * parallaxSpeeds[i] * deltaTime;
-
-            // Faz wrapping do offset quando sai muito para a esquerda ou direita
-            if (parallaxOffsetX[i] <= -SCREEN_WIDTH)
-                parallaxOffsetX[i] += SCREEN_WIDTH;
-            if (parallaxOffsetX[i] >= SCREEN_WIDTH)
-                parallaxOffsetX[i] -= SCREEN_WIDTH;
-        }
+        // (em larguras de tela; o GL_REPEAT faz a volta)
+        parallax.scroll(moveDir * VELOCIDADE_JOGADOR * deltaTime / SCREEN_WIDTH, 0.0f);
 
         // 6.10.6 Desenha cena
+        // Se alguma camada é toda opaca, o fundo cobre a tela e a cor não
+        // precisa ser limpa; a profundidade sempre (o parallax a usa)
         glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        // 6.10.6.1 Desenha cada camada de parallax (da mais distante à mais próxima)
-        for (int i = 0; i < 5; ++i) {
-            // Calcula o centro X atual da textura: offset + metade da largura da tela
-            float centerX = parallaxOffsetX[i] + (SCREEN_WIDTH / 2.0f);
-            float centerY = SCREEN_HEIGHT / 2.0f; // mantém vertical centralizada
-
-            // Se o offset estiver ≤ 0: desenha em centerX e centerX + SCREEN_WIDTH
-            // Senão, desenha em centerX e centerX - SCREEN_WIDTH
-            if (parallaxOffsetX[i] <= 0.0f) {
-                // 1ª cópia
-                parallaxSprites[i].SetPosition(centerX, centerY);
-                parallaxSprites[i].Draw(projection);
-                // 2ª cópia (à direita)
-                parallaxSprites[i].SetPosition(centerX + SCREEN_WIDTH, centerY);
-                parallaxSprites[i].Draw(projection);
-            } else {
-                // 1ª cópia
-                parallaxSprites[i].SetPosition(centerX, centerY);
-                parallaxSprites[i].Draw(projection);
-                // 2ª cópia (à esquerda)
-                parallaxSprites[i].SetPosition(centerX - SCREEN_WIDTH, centerY);
-                parallaxSprites[i].Draw(projection);
+        glClear(parallax.coversScreen() ? GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // 6.10.6.1 Desenha as camadas de parallax: opacos da frente para trás,
+        // bordas translúcidas com blend
+        parallax.draw();
+
+        // 6.10.6.2 Sprites do modo de estresse: envia as alturas e desenha todos
+        if (numEstresse > 0) {
+            GLsizeiptr bytes = numEstresse * sizeof(float);
+            GLintptr deslocamento;
+            void* destino = g_streamBuffer.allocate(bytes, sizeof(float), deslocamento);
+            if (destino) {
+                memcpy(destino, multidao.getYs(), bytes);
+                g_streamBuffer.commit(deslocamento, bytes);
+                g_glState.useProgram(estresseProgram);
+                g_glState.activeTexture(GL_TEXTURE0);
+                g_glState.bindTexture(GL_TEXTURE_2D, fafare);
+                g_glState.bindVertexArray(estresseVAO);
+                // O atributo das alturas segue a região do quadro
+                g_glState.bindBuffer(GL_ARRAY_BUFFER, g_streamBuffer.getBuffer());
+                glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), (void*)deslocamento);
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, numEstresse);
             }
         }
 
-        // 6.10.6.2 Desenha os sprites originais (jogador, rochas, etc.) por cima dos backgrounds
+        // 6.10.6.3 Desenha os sprites originais (jogador, rochas, etc.) por cima dos backgrounds
         for (auto& sprite : sprites) {
             sprite.Draw(projection);
         }
 
         // 6.10.7 Troca buffers
         glfwSwapBuffers(window);
+        g_streamBuffer.endFrame();
+        frame_times_mark();
+        _update_fps_counter(window, "MultiSprite Example"); // FPS (e p99/max, se gravando) no título
+        pacer.waitForNextFrame();
     }
 
     // 6.11 Finaliza
+    if (numEstresse > 0) {
+        if (estresseQuadros > 0) {
+            std::cout << "[estresse] física de " << numEstresse << " sprites: "
+                      << estresseFisicaSeg * 1000.0 / estresseQuadros << " ms por quadro (média de "
+                      << estresseQuadros << " quadros)" << std::endl;
+        }
+        glDeleteVertexArrays(1, &estresseVAO);
+        glDeleteBuffers(1, &estresseX);
+        g_streamBuffer.destroy();
+        glDeleteProgram(estresseProgram);
+    }
+    parallax.destroy();
     glDeleteVertexArrays(1, &quadVAO);
     glDeleteProgram(shaderProgram);
     glfwTerminate();